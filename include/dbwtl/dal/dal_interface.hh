@@ -64,6 +64,7 @@
 
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <iosfwd>
@@ -1315,6 +1316,42 @@ public:
 
 
 
+//------------------------------------------------------------------------------
+///
+/// @brief Hash index for column name lookups
+///
+/// The index maps the column names of a dataset to column numbers.
+/// Datasets invalidate it when their metadata is refreshed and rebuild it
+/// on the next columnID() call, so name lookups inside a fetch loop do
+/// not scan all column descriptors.
+class DBWTL_EXPORT ColumnIndex
+{
+public:
+    ColumnIndex(void);
+
+    /// @brief Rebuilds the index from the column names of ds
+    void build(const IDataset &ds);
+
+    /// @brief Invalidates the index
+    void clear(void);
+
+    /// @brief Returns true if the index was built for the current metadata
+    inline bool isValid(void) const
+    {
+        return this->m_valid;
+    }
+
+    /// @brief Returns the number of the column, 0 if not found (case-sensitive)
+    colnum_t find(const String &name) const;
+
+protected:
+    typedef std::unordered_map<std::string, colnum_t> map_type;
+
+    map_type m_exact;
+    bool     m_valid;
+};
+
+
 
 class DBWTL_EXPORT IDataProvider : public IDataset
 {
@@ -1764,8 +1801,7 @@ bool ColumnMatchFilter<T>::operator()(IDataset &ds) const
 {
 	if(m_value.isnull() || ds.column(this->m_column).isnull())
 			return false;
-	throw 1;
-	//return m_value.get<T>() == ds.column(this->m_column).get<T>();
+	return m_value.get<T>() == ds.column(this->m_column).get<T>();
 }
 
 
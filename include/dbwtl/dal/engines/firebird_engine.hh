@@ -272,6 +272,10 @@ public:
 
     virtual bool isnull(void) const = 0;
 
+    /// Sets view to the XSQLVAR text data, valid until the next fetch.
+    /// Returns false for non-text columns and charsets other than UTF-8.
+    virtual bool getUTF8View(utf8_view &view) const = 0;
+
     virtual void refresh(void) = 0;
 
     virtual daltype_t daltype(void) const = 0;
@@ -803,7 +807,8 @@ struct sv_accessor<FirebirdData*> : public virtual sa_base<FirebirdData*>,
                                          public supports<TTimestamp>,
                                          public supports<TNumeric>,
                                          public supports<TVarbinary>,
-                                         public supports<String>
+                                         public supports<String>,
+                                         public supports_utf8_view
 {
     virtual signed int cast(signed int*, std::locale loc) const;
     virtual signed short cast(signed short*, std::locale loc) const;
@@ -822,6 +827,8 @@ struct sv_accessor<FirebirdData*> : public virtual sa_base<FirebirdData*>,
     virtual TVarbinary cast(TVarbinary*, std::locale loc) const;
     virtual String cast(String*, std::locale loc) const;
 
+    virtual bool get_utf8_view(utf8_view &view) const;
+
 
     virtual bool valueNullCheck(void) const;
     //virtual bool isNull() const;
@@ -695,6 +695,9 @@ public:
     virtual UnicodeStreamBuf*  getMemoStream(void) const = 0;
 
     virtual String getString(void) const = 0;
+    /// Sets view to the bound char buffer, valid until the next fetch.
+    /// Returns false for wide buffers and charsets other than UTF-8.
+    virtual bool getUTF8View(utf8_view &view) const = 0;
     virtual signed short int getSShort(void) const = 0;
     virtual unsigned short int getUShort(void) const = 0;
     virtual signed long int getSLong(void) const = 0;
@@ -1232,7 +1235,8 @@ struct sv_accessor<OdbcData*> : public virtual sa_base<OdbcData*>,
                                 public supports<TTimestamp>,
                                 public supports<TNumeric>,
                                          public supports<TVarbinary>,
-                                public supports<String>
+                                public supports<String>,
+                                public supports_utf8_view
 {
     virtual signed char cast(signed char*, std::locale loc) const;
     virtual signed int cast(signed int*, std::locale loc) const;
@@ -1258,6 +1262,8 @@ struct sv_accessor<OdbcData*> : public virtual sa_base<OdbcData*>,
     virtual TVarbinary cast(TVarbinary*, std::locale loc) const;
     virtual String cast(String*, std::locale loc) const;
 
+    virtual bool get_utf8_view(utf8_view &view) const;
+
 
     virtual bool valueNullCheck(void) const;
     //virtual bool isNull() const;
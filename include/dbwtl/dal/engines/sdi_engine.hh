@@ -235,6 +235,9 @@ public:
     virtual TNumeric getNumeric(void) const = 0;
     virtual bool getBool(void) const = 0;
     virtual String getString(void) const = 0;
+    /// Sets view to the text of the column, valid until the next fetch.
+    /// Returns false for non-string columns and charsets other than UTF-8.
+    virtual bool getUTF8View(utf8_view &view) const = 0;
     virtual TDate getDate(void) const = 0;
     virtual TTime getTime(void) const = 0;
     virtual TTimestamp getTimestamp(void) const = 0;
@@ -789,7 +792,8 @@ class sv_accessor<SDIData*> : public virtual sa_base<SDIData*>,
                                    public supports<TTime>,
                                    public supports<TTimestamp>,
                                    public supports<Blob>,
-                                   public supports<Memo>
+                                   public supports<Memo>,
+                                   public supports_utf8_view
     
 {
 public:
@@ -812,6 +816,8 @@ public:
     SV_CAST_METHOD(Blob);
     SV_CAST_METHOD(Memo);
 
+    virtual bool get_utf8_view(utf8_view &view) const;
+
     virtual bool valueNullCheck() const;
     virtual daltype_t datatype() const;
 };
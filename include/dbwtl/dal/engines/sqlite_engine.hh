@@ -54,6 +54,11 @@
 #endif
 
 
+/// Capacity of the per-connection prepared statement cache (default 32),
+/// 0 disables the cache
+#define DBWTL_SQLITE_STMT_CACHE_SIZE       "SQLITE_STMT_CACHE_SIZE"
+
+
 DAL_NAMESPACE_BEGIN
 
 
@@ -214,6 +219,10 @@ public:
 
     virtual String getString(void) const = 0;
 
+    /// Sets view to the text of the column, valid until the next fetch.
+    /// Returns false for BLOB values.
+    virtual bool getUTF8View(utf8_view &view) const = 0;
+
     virtual bool isnull(void) const = 0;
 
     virtual void refresh(void) = 0;
@@ -591,6 +600,32 @@ public:
 
     virtual String         quoteIdentifier(const String &id);
 
+    /// @brief Number of prepare() calls served from the statement cache
+    virtual size_t         stmtCacheHits(void) const = 0;
+
+    /// @brief Number of prepare() calls that compiled a new statement
+    virtual size_t         stmtCacheMisses(void) const = 0;
+
+    /// @brief Finalizes all cached statements
+    virtual void           clearStmtCache(void) = 0;
+
+    /// @brief Writes data into an existing BLOB value
+    ///
+    /// @details The value must already have its final size, usually
+    /// by inserting zeroblob(n). The data is streamed in fixed chunks
+    /// through sqlite3_blob_write(), so it is never held in memory as
+    /// a whole.
+    virtual void           writeBlob(String table, String column, int64_t rowid,
+                                     ByteStreamBuf *data) = 0;
+
+    /// @brief Opens a BLOB value for incremental reading
+    ///
+    /// @details The returned buffer reads the value in fixed chunks
+    /// through sqlite3_blob_read() and supports seeking, so memory use
+    /// does not depend on the size of the value. The caller owns the
+    /// buffer and must delete it before the connection is closed.
+    virtual SqliteBlob*    openBlob(String table, String column, int64_t rowid) = 0;
+
 protected:
     SqliteDiagController m_diag;
 };
@@ -700,16 +735,19 @@ template<>
 struct sv_accessor<SqliteData*> : public virtual sa_base<SqliteData*>,
                                        public supports<signed int>,
                                        public supports<bool>,
+                                       public supports<double>,
                                        public supports<BlobStream>,
                                        public supports<Blob>,
                                        public supports<TDate>,
                                        public supports<TTime>,
                                        public supports<TTimestamp>,
                                        public supports<TNumeric>,
-                                       public supports<String>
+                                       public supports<String>,
+                                       public supports_utf8_view
 {
     virtual signed int cast(signed int*, std::locale loc) const;
     virtual bool cast(bool*, std::locale loc) const;
+    virtual double cast(double*, std::locale loc) const;
     virtual BlobStream cast(BlobStream*, std::locale loc) const;
     virtual Blob cast(Blob*, std::locale loc) const;
     virtual TDate cast(TDate*, std::locale loc) const;
@@ -718,6 +756,8 @@ struct sv_accessor<SqliteData*> : public virtual sa_base<SqliteData*>,
     virtual TNumeric cast(TNumeric*, std::locale loc) const;
     virtual String cast(String*, std::locale loc) const;
 
+    virtual bool get_utf8_view(utf8_view &view) const;
+
 
     virtual bool valueNullCheck(void) const;
     //virtual bool isNull() const;
@@ -46,6 +46,7 @@
 #include "dbwtl/dbwtl_config.hh"
 
 #include "dbwtl/util/bcd.hh"
+#include "dbwtl/util/decimal.hh"
 
 #define DB_NAMESPACE_BEGIN namespace informave { namespace db {
 #define DB_NAMESPACE_END }}
@@ -71,7 +72,11 @@ class TTime;
 class TInterval;
 class TVarbinary;
 //class TNumeric;
+#if defined(DBWTL_NUMERIC_BCD) || !defined(INFORMAVE_HAVE_DECIMAL128)
 typedef informave::utils::bcd TNumeric;
+#else
+typedef informave::utils::decimal TNumeric;
+#endif
 //typedef informave::utils::bcd TDecimal;
 
 class TTimestamp;
@@ -125,6 +130,10 @@ enum DatatypeEnumeration
 typedef enum DatatypeEnumeration daltype_t;
 
 
+/// Number of DAL datatypes, used for tables indexed by daltype_t
+enum { DAL_TYPE_COUNT = DAL_TYPE_INTERVAL + 1 };
+
+
 
 
 DB_NAMESPACE_END
@@ -56,6 +56,9 @@
 #include "dal/dal_interface.hh"
 
 #include <iosfwd>
+#include <exception>
+#include <map>
+#include <unordered_map>
 
 
 
@@ -745,7 +748,10 @@ public:
 /// @brief ShrRecord class
 /// A ShrRecord object stores all column data into an internal buffer.
 /// This buffer may be shared between other ShrRecord objects.
-/// If you want a full independent copy of a ShrRecord, use the clone() method.
+/// Sharing is copy-on-write: copies share the buffer until one of them is
+/// modified through a non-const method, which first gives that record its
+/// own copy of the buffer. Readers never copy. clone() always creates an
+/// independent copy immediately.
 ///
 /// Implementation notes:
 /// A ShrRecord object has no Bookmark information.
@@ -763,7 +769,8 @@ public:
     ShrRecord(size_t ncol);
 
     /// @brief Create a duplicate of the origin record.
-    /// @note Both ShrRecord objects shares the same column buffer!
+    /// @note Both ShrRecord objects share the same column buffer
+    /// until one of them is modified.
     ShrRecord(const ShrRecord& orig);
 
     /// @brief Construct Record from a list of Variant values (C++0x)
@@ -791,6 +798,10 @@ public:
     ShrRecord clone(void) const;
 
     /// @brief Returns a reference to the column data
+    /// @details
+    /// Detaches the record from a shared column buffer first. The reference
+    /// must not be used after the record is copied, because the copy
+    /// shares the buffer again.
     Variant&       operator[](size_t index);
 
     /// @brief Returns a const reference to the column data
@@ -802,6 +813,7 @@ public:
     /// @brief Allocate space for ncol columns
     inline void allocate(size_t ncol)
     {
+        this->detach();
     	this->m_data->resize(ncol);
     }
 
@@ -812,14 +824,27 @@ public:
     }
 
     /// @brief Clear data buffer, release allocated column space
+    /// @details
+    /// A shared buffer is released, other records keep their data.
     inline void clear(void)
     {
-        this->m_data->clear();
+        if(this->unique())
+            this->m_data->clear();
+        else
+            this->m_data.reset(new ColumnBuffer());
     }
 
-    /// @brief Returns the internal column buffer
+    /// @brief Returns true if no other ShrRecord shares the column buffer
+    inline bool unique(void) const
+    {
+        return this->m_data.use_count() == 1;
+    }
+
+    /// @brief Returns the internal column buffer, detaches the record
+    /// from a shared buffer first
     inline ColumnBuffer& getbuf(void)
     {
+        this->detach();
         return *this->m_data;
     }
 
@@ -830,11 +855,340 @@ public:
     }
 
 protected:
+    /// Copies a shared column buffer before it is modified
+    inline void detach(void)
+    {
+        if(! this->unique())
+            this->m_data.reset(new ColumnBuffer(*this->m_data));
+    }
+
     std::shared_ptr<ColumnBuffer>          m_data;
 };
 
 
 
+/// @brief Storage layout of a RecordSet
+enum RecordSetStorage
+{
+    DBWTL_STORAGE_ROWS = 0,      ///< one ShrRecord per row (default)
+    DBWTL_STORAGE_COLUMNS = 1,   ///< one typed array per column
+    DBWTL_STORAGE_SPILL = 2,     ///< row pages, spilled to a temporary file
+    DBWTL_STORAGE_SNAPSHOT = 3   ///< read-only, memory mapped snapshot file
+};
+
+
+/// @brief Kind of a RecordSet index
+enum RecordIndexType
+{
+    DBWTL_INDEX_HASH = 0,        ///< equality lookups only
+    DBWTL_INDEX_ORDERED = 1      ///< equality, prefix and range lookups
+};
+
+
+struct column_vector;
+struct spill_page;
+struct spill_file;
+struct snapshot_map;
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////////// ColumnStore
+///
+/// @since 0.0.1
+/// @brief Columnar storage for RecordSet
+/// Each column is stored as a contiguous array. Scalar types (all types
+/// stored inline by Variant) use an array of the native type, strings
+/// are stored as UTF-8 in a per-column arena. All other types (numerics,
+/// LOB handles, ...) and columns with mixed types are stored as Variants.
+/// Every column has a null bitmap.
+///
+/// The array type of a column is chosen by the first non-null value.
+class DBWTL_EXPORT ColumnStore
+{
+public:
+    ColumnStore(void);
+
+    /// @brief Creates a deep copy of all columns
+    ColumnStore(const ColumnStore &orig);
+
+    ColumnStore& operator=(const ColumnStore &orig);
+
+    ~ColumnStore(void);
+
+    /// @brief Appends the values of rec as a new row
+    void append(const ShrRecord &rec);
+
+    /// @brief Copies the value at row/col (both 0-based) into dest
+    void load(size_t row, size_t col, Variant &dest) const;
+
+    /// @brief Returns true if the value at row/col (both 0-based) is NULL
+    bool isnull(size_t row, size_t col) const;
+
+    /// @brief Returns the type of the column array, DAL_TYPE_UNKNOWN if
+    /// the column has only NULL values or values of mixed types
+    daltype_t columnType(size_t col) const;
+
+    inline size_t rowCount(void) const
+    {
+        return this->m_rows;
+    }
+
+    inline size_t columnCount(void) const
+    {
+        return this->m_columns.size();
+    }
+
+    /// @brief Removes all rows and columns
+    void clear(void);
+
+    /// @brief Returns the approximate number of bytes allocated for the data
+    size_t memoryUsage(void) const;
+
+protected:
+    std::vector<column_vector*>  m_columns;
+    size_t                       m_rows;
+};
+
+
+
+//..............................................................................
+///////////////////////////////////////////////////////////////////// SpillStore
+///
+/// @since 0.0.1
+/// @brief Row storage with a memory limit for RecordSet
+/// Rows are grouped into pages of getPageSize() rows. If the resident pages
+/// use more memory than getMemoryLimit(), the least recently used pages
+/// are written to a temporary file in the binary record format and
+/// released. Accessing a row of a released page reads the page back.
+///
+/// The last page is always kept in memory. Pages are written only once,
+/// because rows can't be modified after they are appended.
+class DBWTL_EXPORT SpillStore
+{
+public:
+    SpillStore(void);
+
+    /// @brief Creates a copy of all rows, the copy uses its own file
+    SpillStore(const SpillStore &orig);
+
+    SpillStore& operator=(const SpillStore &orig);
+
+    ~SpillStore(void);
+
+    /// @brief Sets the number of bytes resident pages may use
+    void setMemoryLimit(size_t bytes);
+
+    inline size_t getMemoryLimit(void) const
+    {
+        return this->m_memory_limit;
+    }
+
+    /// @brief Sets the number of rows per page, only allowed if the store is empty
+    void setPageSize(size_t rows);
+
+    inline size_t getPageSize(void) const
+    {
+        return this->m_page_rows;
+    }
+
+    /// @brief Appends rec as a new row, the column buffer is shared with rec
+    void append(const ShrRecord &rec);
+
+    /// @brief Returns the row (0-based), reads the page from disk if required
+    ShrRecord get(size_t row) const;
+
+    inline size_t rowCount(void) const
+    {
+        return this->m_rows;
+    }
+
+    /// @brief Removes all rows and closes the temporary file
+    void clear(void);
+
+    /// @brief Returns the approximate number of bytes used by resident pages
+    inline size_t memoryUsage(void) const
+    {
+        return this->m_resident_bytes;
+    }
+
+    /// @brief Returns the number of pages currently kept in memory
+    size_t residentPages(void) const;
+
+    /// @brief Returns the number of pages written to the temporary file
+    size_t spilledPages(void) const;
+
+protected:
+    void touch(spill_page &page) const;
+    void evict(const spill_page *keep) const;
+    void load(spill_page &page) const;
+
+    std::vector<spill_page*>  m_pages;
+    mutable spill_file       *m_file;
+    size_t                    m_rows;
+    size_t                    m_page_rows;
+    size_t                    m_memory_limit;
+    mutable size_t            m_resident_bytes;
+    mutable size_t            m_clock;
+};
+
+
+
+//..............................................................................
+////////////////////////////////////////////////////////////////// SnapshotStore
+///
+/// @since 0.0.1
+/// @brief Read-only access to a RecordSet snapshot file
+///
+/// The file is mapped into memory. Values are read from the mapping when
+/// they are requested, nothing is deserialized when the file is opened.
+///
+/// A snapshot holds the column names and types followed by one data
+/// section per column: a null bitmap and either an array of the native
+/// type (columns with one scalar type) or offsets into values in the
+/// binary record format. Integers are stored in native byte order,
+/// files written on a machine with a different byte order are rejected.
+class DBWTL_EXPORT SnapshotStore
+{
+public:
+    SnapshotStore(void);
+
+    /// @brief Creates a copy that shares the mapping of other
+    SnapshotStore(const SnapshotStore &other);
+
+    ~SnapshotStore(void);
+
+    SnapshotStore& operator=(const SnapshotStore &other);
+
+    /// @brief Maps the snapshot file, throws EngineException if the
+    /// file is not a valid snapshot
+    void open(const std::string &path);
+
+    /// @brief Unmaps the file
+    void close(void);
+
+    inline bool isOpen(void) const
+    {
+        return this->m_map.get() != 0;
+    }
+
+    inline size_t rowCount(void) const
+    {
+        return this->m_rows;
+    }
+
+    inline size_t columnCount(void) const
+    {
+        return this->m_columns.size();
+    }
+
+    /// @brief Returns the name of the column (0-based)
+    const String& columnName(size_t col) const;
+
+    /// @brief Returns the datatype of the column descriptor (0-based)
+    daltype_t columnType(size_t col) const;
+
+    /// @brief Copies the value at row/col (both 0-based) into dest
+    void load(size_t row, size_t col, Variant &dest) const;
+
+    /// @brief Returns true if the value at row/col (both 0-based) is NULL
+    bool isnull(size_t row, size_t col) const;
+
+protected:
+    struct column_info
+    {
+        String         name;
+        daltype_t      desc_type;
+        daltype_t      fixed_type;   ///< DAL_TYPE_UNKNOWN for encoded values
+        const char    *nulls;
+        const char    *data;
+        size_t         length;
+    };
+
+    std::shared_ptr<snapshot_map>   m_map;
+    std::vector<column_info>        m_columns;
+    size_t                          m_rows;
+};
+
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////////// RecordIndex
+///
+/// @since 0.0.1
+/// @brief Secondary index on one or more columns of a RecordSet
+///
+/// The index maps key values to 1-based row numbers. Rows with the same
+/// key are returned in ascending row order.
+///
+/// A hash index compares keys by value: numbers of different integer and
+/// floating point types are equal if their values are equal, other types
+/// are compared by type and string representation.
+/// An ordered index sorts the keys like the SQL comparison operators with
+/// NULL before all other values, so the values of an indexed column must
+/// be comparable to each other.
+class DBWTL_EXPORT RecordIndex
+{
+public:
+    typedef std::vector<Variant>    key_type;
+    typedef std::vector<rownum_t>   rowlist_type;
+
+    /// @param columns 1-based column numbers of the key
+    RecordIndex(RecordIndexType type, const std::vector<colnum_t> &columns);
+
+    inline RecordIndexType type(void) const
+    {
+        return this->m_type;
+    }
+
+    inline const std::vector<colnum_t>& columns(void) const
+    {
+        return this->m_columns;
+    }
+
+    /// @brief Returns the number of indexed rows
+    inline size_t size(void) const
+    {
+        return this->m_rows;
+    }
+
+    /// @brief Adds the key of rec for the given row
+    void add(const ShrRecord &rec, rownum_t row);
+
+    /// @brief Removes all rows
+    void clear(void);
+
+    /// @brief Returns all rows with the given key
+    /// @details
+    /// An ordered index also accepts a prefix of the key, i.e. the values
+    /// of the first columns only.
+    rowlist_type find(const key_type &key) const;
+
+    /// @brief Returns all rows with lower <= key <= upper in key order,
+    /// only supported by ordered indexes
+    /// @details
+    /// Both bounds can be prefixes of the key, an empty bound is unlimited.
+    rowlist_type range(const key_type &lower, const key_type &upper) const;
+
+protected:
+    /// Orders keys column by column, a prefix compares equal
+    /// to all keys starting with it
+    struct key_less
+    {
+        bool operator()(const key_type &a, const key_type &b) const;
+    };
+
+    typedef std::unordered_map<std::string, rowlist_type>    hash_type;
+    typedef std::multimap<key_type, rownum_t, key_less>       tree_type;
+
+    RecordIndexType         m_type;
+    std::vector<colnum_t>   m_columns;
+    hash_type               m_hash;
+    tree_type               m_tree;
+    size_t                  m_rows;
+};
+
+
+
 class DBWTL_EXPORT ScrollableDataset : public IDataset
 {
 public:
@@ -874,12 +1228,92 @@ public:
 ///
 /// A standalone RecordSet object can be used to store values as a dataset.
 /// This is sometime called a in-memory or temporary dataset.
+///
+/// With DBWTL_STORAGE_COLUMNS the records are stored in a ColumnStore,
+/// with DBWTL_STORAGE_SPILL in a SpillStore. DBWTL_STORAGE_SNAPSHOT
+/// is used by loadSnapshot().
+/// The cursor API works the same way for all storage layouts, but
+/// begin()/end() iterate over ShrRecord objects only in row storage.
 class DBWTL_EXPORT RecordSet : public ScrollableDataset
 {
 public:
     RecordSet(void);
+    explicit RecordSet(RecordSetStorage storage);
     virtual ~RecordSet(void);
 
+    /// @brief Changes the storage layout, only allowed if the RecordSet is empty
+    void setStorage(RecordSetStorage storage);
+
+    inline RecordSetStorage getStorage(void) const
+    {
+        return this->m_storage;
+    }
+
+    /// @brief Returns the column store, only filled in column storage
+    inline const ColumnStore& columns(void) const
+    {
+        return this->m_column_store;
+    }
+
+    /// @brief Returns the spill store, only filled in spill storage
+    inline const SpillStore& spilled(void) const
+    {
+        return this->m_spill_store;
+    }
+
+    /// @brief Sets the memory limit for spill storage
+    inline void setMemoryLimit(size_t bytes)
+    {
+        this->m_spill_store.setMemoryLimit(bytes);
+    }
+
+    /// @brief Writes all records and column descriptors to a snapshot file
+    void saveSnapshot(const std::string &path) const;
+
+    /// @brief Opens a snapshot file written by saveSnapshot()
+    /// @details
+    /// The RecordSet must be empty. It switches to DBWTL_STORAGE_SNAPSHOT,
+    /// is opened and serves the values directly from the mapped file.
+    /// A snapshot RecordSet is read-only.
+    void loadSnapshot(const std::string &path);
+
+    /// @brief Returns the row as a record, row is 1-based like setpos()
+    /// @details
+    /// In row and spill storage the record shares the column buffer with
+    /// the RecordSet (copy-on-write), otherwise the values are copied into
+    /// a new record.
+    ShrRecord getRecord(rownum_t row) const;
+
+    /// @brief Creates an index on the given 1-based columns
+    /// @details
+    /// Existing rows are indexed immediately, new rows are added by
+    /// insert() and emplace(). clear() keeps the index definitions,
+    /// reset() drops them.
+    void createIndex(const String &name, RecordIndexType type,
+                     const std::vector<colnum_t> &columns);
+
+    /// @brief Removes the index, throws NotFoundException if there is none
+    void dropIndex(const String &name);
+
+    /// @brief Returns the index, throws NotFoundException if there is none
+    const RecordIndex& getIndex(const String &name) const;
+
+    /// @brief Returns all rows with the given key, see RecordIndex::find()
+    RecordIndex::rowlist_type lookup(const String &index,
+                                     const RecordIndex::key_type &key) const;
+
+    /// @brief Returns all rows between both keys, see RecordIndex::range()
+    RecordIndex::rowlist_type lookupRange(const String &index,
+                                          const RecordIndex::key_type &lower,
+                                          const RecordIndex::key_type &upper) const;
+
+    /// @brief Moves the cursor to the first row with the given key
+    /// @return false if no row matches, the cursor is not moved then
+    bool seek(const String &index, const RecordIndex::key_type &key);
+
+    /// @brief Same as seek() for single column keys
+    bool seek(const String &index, const Variant &key);
+
     virtual bool   isBad(void) const;
 
     virtual void   open(void);
@@ -967,13 +1401,52 @@ public:
     }
 
 
+    /// @brief Inserts a record
+    /// @details
+    /// The RecordSet shares the column buffer with rec. Modifying rec
+    /// later gives rec its own copy and does not change the RecordSet.
     void insert(const ShrRecord &rec);
 
+    /// @brief Inserts a record that is not used by the caller afterwards
+    /// @details
+    /// Same as insert(). Records share their buffer copy-on-write, so
+    /// neither insert() nor emplace() copies the column buffer.
+    void emplace(ShrRecord &&rec);
+
 protected:
-    RecordSet::iterator m_cursor;
+    /// Checks the field count of a new record with ncol columns
+    void prepareInsert(size_t ncol);
+
+    /// 0-based position of the cursor
+    size_t m_pos;
+
+    RecordSetStorage m_storage;
+    ColumnStore      m_column_store;
+    SpillStore       m_spill_store;
+    SnapshotStore    m_snapshot;
+
+    /// Current row in spill storage, keeps the values returned
+    /// by column() alive if the page is released
+    ShrRecord        m_spill_row;
+    size_t           m_spill_row_pos;
+
+    /// Values of the current row in column storage, loaded on access.
+    /// m_rowbuf_pos holds the row each value was loaded from.
+    std::vector<Variant> m_rowbuf;
+    std::vector<size_t>  m_rowbuf_pos;
    
     std::vector<ColumnDesc>	m_column_descriptors;
 
+    /// Maps column names to numbers, invalidated if a descriptor changes
+    mutable ColumnIndex     m_column_index;
+
+    /// Secondary indexes by name
+    typedef std::map<std::string, RecordIndex> index_map_type;
+    index_map_type          m_indexes;
+
+    /// Adds the last inserted record to all indexes
+    void updateIndexes(const ShrRecord &rec);
+
     inline ColumnDesc& findDescriptor(colnum_t num)
     {
     	assert(num > 0);
@@ -1002,6 +1475,100 @@ protected:
 };
 
 
+/// @brief Sort key for RecordSetOps::sort()
+struct DBWTL_EXPORT RecordSortKey
+{
+    RecordSortKey(colnum_t col, bool desc = false)
+        : column(col), descending(desc)
+    {}
+
+    colnum_t   column;         ///< 1-based column number
+    bool       descending;
+};
+
+
+/// @brief Aggregate functions for RecordSetOps::groupBy()
+enum RecordAggregateType
+{
+    DBWTL_AGGREGATE_COUNT = 0,
+    DBWTL_AGGREGATE_SUM = 1,
+    DBWTL_AGGREGATE_MIN = 2,
+    DBWTL_AGGREGATE_MAX = 3,
+    DBWTL_AGGREGATE_AVG = 4
+};
+
+
+/// @brief Aggregate column for RecordSetOps::groupBy()
+struct DBWTL_EXPORT RecordAggregate
+{
+    /// @param col 1-based column number, 0 for COUNT(*)
+    /// @param n name of the result column, a default name is used if empty
+    RecordAggregate(RecordAggregateType t, colnum_t col, const String &n = String())
+        : type(t), column(col), name(n)
+    {}
+
+    RecordAggregateType   type;
+    colnum_t              column;
+    String                name;
+};
+
+
+
+//------------------------------------------------------------------------------
+///
+/// @brief Sort, filter and group-by operators on RecordSet objects
+///
+/// @details
+/// The operators read the rows through RecordSet::getRecord(), so they work
+/// for all storage layouts. The result is written to dest, which is reset
+/// first and receives the column descriptors of the result.
+///
+/// NULL values sort before all other values. Aggregates ignore NULL values
+/// like in SQL, SUM, MIN, MAX and AVG return NULL for groups without
+/// non-NULL values.
+///
+/// sort() and groupBy() split the rows into equal parts for the given
+/// number of threads, 0 uses one thread per core. Each thread sorts its
+/// part, the parts are merged pairwise in parallel. For groupBy() each
+/// thread builds a partial hash table, the tables are merged at the end.
+/// Small inputs and RecordSets in spill storage are processed by a
+/// single thread.
+struct DBWTL_EXPORT RecordSetOps
+{
+    typedef std::vector<rownum_t> rowlist_type;
+
+    /// @brief Computes the row numbers of src in sort order
+    /// @details
+    /// The sort is stable. The key values are extracted once per row into
+    /// typed arrays before sorting, comparisons do not touch any Variant
+    /// unless a key column has mixed types.
+    static void sortRows(const RecordSet &src, const std::vector<RecordSortKey> &keys,
+                         rowlist_type &order, size_t threads = 1);
+
+    /// @brief Copies the rows of src sorted by keys into dest
+    static void sort(const RecordSet &src, const std::vector<RecordSortKey> &keys,
+                     RecordSet &dest, size_t threads = 1);
+
+    /// @brief Copies the given rows of src into dest
+    static void select(const RecordSet &src, const rowlist_type &rows, RecordSet &dest);
+
+    /// @brief Copies all rows of src accepted by filter into dest
+    /// @details
+    /// The filter is called with src positioned on each row, so the
+    /// cursor of src is moved.
+    static void filter(RecordSet &src, const DatasetFilter &filter, RecordSet &dest);
+
+    /// @brief Groups the rows of src by the key columns and computes the aggregates
+    /// @details
+    /// dest gets the key columns followed by one column per aggregate.
+    /// Groups are returned in the order of their first row in src.
+    static void groupBy(const RecordSet &src, const std::vector<colnum_t> &keys,
+                        const std::vector<RecordAggregate> &aggregates, RecordSet &dest,
+                        size_t threads = 1);
+};
+
+
+
 template<typename T>
 struct DBWTL_EXPORT ColumnSortByNumber
 {
@@ -1022,7 +1589,22 @@ struct DBWTL_EXPORT ColumnSortByNumber
 
 
 
+struct cached_prefetch;
+
 
+//..............................................................................
+/////////////////////////////////////////////////////////////// CachedResultBase
+///
+/// @since 0.0.1
+/// @brief Caches the records of a resultset in a RecordSet
+///
+/// Records are copied from the source resultset when the cursor moves
+/// beyond the cached rows. fetchMore() copies up to getRowsetSize() rows.
+///
+/// With setPrefetch() a worker thread reads records from the source ahead
+/// of the cursor into a bounded queue. The queue holds at most the given
+/// number of rows and, if a budget is set, about the given number of bytes.
+/// The source must not be used by other code while prefetching is active.
 class DBWTL_EXPORT CachedResultBase : public ScrollableDataset
 {
 
@@ -1102,6 +1684,72 @@ public:
     void fetchAll(void);
     void detach(void);
 
+    /// @brief Sets the storage layout of the internal cache,
+    /// must be called before any row is fetched
+    inline void setStorage(RecordSetStorage storage)
+    {
+        this->m_rscache.setStorage(storage);
+    }
+
+    /// @brief Sets the memory limit of the internal cache for spill storage
+    inline void setMemoryLimit(size_t bytes)
+    {
+        this->m_rscache.setMemoryLimit(bytes);
+    }
+
+    /// @brief Sets the number of rows copied by fetchMore()
+    void setRowsetSize(rowcount_t rows);
+
+    inline rowcount_t getRowsetSize(void) const
+    {
+        return this->m_rowset_size;
+    }
+
+    /// @brief Enables background prefetching
+    /// @details
+    /// A worker thread keeps up to rows records ahead of the cached rows.
+    /// If max_bytes is not 0, the worker also pauses when the queued
+    /// records use about max_bytes of memory. rows = 0 disables prefetching.
+    /// The worker is started by open() or immediately if already open.
+    ///
+    /// The worker drives the source statement on its own thread. The
+    /// connection of the source must not be used concurrently while
+    /// prefetching, not even through other statements: drivers do not
+    /// lock it, e.g. SQLite clears the shared statement cache from
+    /// next() when the schema changed.
+    void setPrefetch(rowcount_t rows, size_t max_bytes = 0);
+
+    /// @brief Stops the worker thread, queued records are kept
+    void stopPrefetch(void);
+
+    /// @brief Returns true if a worker thread is running
+    bool isPrefetching(void) const;
+
+    /// @brief Creates an index on the cached rows, see RecordSet::createIndex()
+    /// @details
+    /// Must be called after open(). Rows fetched later are added to the
+    /// index while they are copied into the cache.
+    void createIndex(const String &name, RecordIndexType type,
+                     const std::vector<colnum_t> &columns);
+
+    /// @brief Removes the index
+    void dropIndex(const String &name);
+
+    /// @brief Fetches all remaining rows and returns the rows with the given key
+    RecordIndex::rowlist_type lookup(const String &index, const RecordIndex::key_type &key);
+
+    /// @brief Fetches all remaining rows and returns the rows between both keys
+    RecordIndex::rowlist_type lookupRange(const String &index,
+                                          const RecordIndex::key_type &lower,
+                                          const RecordIndex::key_type &upper);
+
+    /// @brief Moves the cursor to the first row with the given key
+    /// @return false if no row matches, the cursor is not moved then
+    bool seek(const String &index, const RecordIndex::key_type &key);
+
+    /// @brief Same as seek() for single column keys
+    bool seek(const String &index, const Variant &key);
+
 
 protected:
     dal_resultset_type *m_source;
@@ -1109,10 +1757,25 @@ protected:
 
     rowcount_t m_current_row; // 1-base // 1-basedd
 
+    rowcount_t        m_rowset_size;
+    rowcount_t        m_prefetch_rows;
+    size_t            m_prefetch_bytes;
+    cached_prefetch  *m_prefetch;
+    std::exception_ptr m_prefetch_error;
+
     void resetInternal(void);
     void copyMetadata(void);
     void copyRecord(void);
 
+    /// @brief Copies the current row of the source into a new record
+    ShrRecord readRecord(void);
+
+    /// @brief Adds the next source record to the cache
+    /// @return false if there are no more records
+    bool pullRecord(void);
+
+    void startPrefetch(void);
+
 private:
     CachedResultBase(const CachedResultBase&);
     CachedResultBase& operator=(const CachedResultBase&);
@@ -143,6 +143,9 @@ public:
 
 	std::streambuf* rdbuf(void) const;
 
+    /// @brief Returns the number of bytes held by the BLOB
+    size_t size(void) const;
+
     TVarbinary toVarbinary(void);
 
 
@@ -170,6 +173,9 @@ public:
 
 	std::wstreambuf* rdbuf(void) const;
 
+    /// @brief Returns the number of bytes held by the MEMO buffer
+    size_t size(void) const;
+
     Memo(const Memo&);
     Memo(const Variant&);
     Memo& operator=(const Memo&);
@@ -1016,7 +1022,9 @@ struct DBWTL_EXPORT sv_accessor<unsigned long long> : public virtual sa_base<uns
 template<>
 struct DBWTL_EXPORT sv_accessor<TNumeric> : public virtual sa_base<TNumeric>,
                                public supports<String>,
-                               public supports<bool>
+                               public supports<bool>,
+                               public supports<signed long long>,
+                               public supports<double>
 
                                   // public supports_cast<signed int, bool>,
                                    // public supports_cast<signed int, signed char>,
@@ -1037,6 +1045,8 @@ struct DBWTL_EXPORT sv_accessor<TNumeric> : public virtual sa_base<TNumeric>,
 {
     virtual String cast(String*, std::locale loc) const;
     virtual bool cast(bool*, std::locale loc) const;
+    virtual signed long long cast(signed long long*, std::locale loc) const;
+    virtual double cast(double*, std::locale loc) const;
 };
 
 
@@ -1210,7 +1220,8 @@ struct DBWTL_EXPORT sv_accessor<String> : public virtual sa_base<String>,
                              public supports<TDate>,
                              public supports<TTime>,
                              public supports<TTimestamp>,
-                             public supports<Memo>
+                             public supports<Memo>,
+                             public supports_utf8_view
 
                                   // public supports_cast<signed int, bool>,
                                    // public supports_cast<signed int, signed char>,
@@ -1243,6 +1254,92 @@ struct DBWTL_EXPORT sv_accessor<String> : public virtual sa_base<String>,
     virtual TTime cast(TTime*, std::locale loc) const;
     virtual TTimestamp cast(TTimestamp*, std::locale loc) const;
     virtual Memo cast(Memo*, std::locale loc) const;
+
+    virtual bool get_utf8_view(utf8_view &view) const;
+};
+
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////////// inline_cast
+///
+/// @since 0.0.1
+/// @brief Conversion from an inline value of type U to T
+/// @detail
+/// The accessor is a local object, so the cast is called without a
+/// dynamic_cast<> and without a lookup of the final overrider at runtime.
+/// Arithmetic conversions implemented by supports_cast<> or
+/// supports_integral_type_cast<> don't use the locale, they are done
+/// directly without an accessor and without a locale.
+template<typename U, typename T,
+         bool supported = std::is_base_of<supports<T>, sv_accessor<U> >::value>
+struct inline_cast
+{
+    typedef typename std::conditional<
+        std::is_base_of<supports_integral_type_cast<U, T>, sv_accessor<U> >::value,
+        supports_integral_type_cast<U, T>,
+        supports_cast<U, T> >::type direct_type;
+
+    static const bool direct = std::is_arithmetic<T>::value
+        && std::is_base_of<direct_type, sv_accessor<U> >::value;
+
+    static T convert_with(const U &value, const std::locale*, std::true_type)
+    {
+        return direct_type::convert_value(value);
+    }
+
+    static T convert_with(const U &value, const std::locale *loc, std::false_type)
+    {
+        const_ptr_value<U> acc(&value);
+        return static_cast<const supports<T>&>(acc).cast((T*)0, loc ? *loc : std::locale());
+    }
+
+    static T convert(const void *value, const std::locale *loc)
+    {
+        return convert_with(*static_cast<const U*>(value), loc, std::integral_constant<bool, direct>());
+    }
+
+    static constexpr typename inline_conversion<T>::function_type function = &convert;
+};
+
+
+template<typename U, typename T>
+struct inline_cast<U, T, false>
+{
+    static constexpr typename inline_conversion<T>::function_type function = 0;
+};
+
+
+static_assert(DAL_TYPE_COUNT == 24, "inline_conversion<T>::table must be updated");
+
+
+template<typename T>
+const typename inline_conversion<T>::function_type inline_conversion<T>::table[DAL_TYPE_COUNT] =
+{
+    0,                                               // DAL_TYPE_CUSTOM
+    0,                                               // DAL_TYPE_UNKNOWN
+    inline_cast<signed int, T>::function,            // DAL_TYPE_INT
+    inline_cast<unsigned int, T>::function,          // DAL_TYPE_UINT
+    inline_cast<signed char, T>::function,           // DAL_TYPE_CHAR
+    inline_cast<unsigned char, T>::function,         // DAL_TYPE_UCHAR
+    0,                                               // DAL_TYPE_STRING
+    inline_cast<bool, T>::function,                  // DAL_TYPE_BOOL
+    inline_cast<signed short, T>::function,          // DAL_TYPE_SMALLINT
+    inline_cast<unsigned short, T>::function,        // DAL_TYPE_USMALLINT
+    inline_cast<signed long long, T>::function,      // DAL_TYPE_BIGINT
+    inline_cast<unsigned long long, T>::function,    // DAL_TYPE_UBIGINT
+    0,                                               // DAL_TYPE_BLOB
+    0,                                               // DAL_TYPE_BLOBSTREAM
+    0,                                               // DAL_TYPE_MEMO
+    0,                                               // DAL_TYPE_MEMOSTREAM
+    0,                                               // DAL_TYPE_NUMERIC
+    0,                                               // DAL_TYPE_VARBINARY
+    inline_cast<float, T>::function,                 // DAL_TYPE_FLOAT
+    inline_cast<double, T>::function,                // DAL_TYPE_DOUBLE
+    inline_cast<TDate, T>::function,                 // DAL_TYPE_DATE
+    inline_cast<TTime, T>::function,                 // DAL_TYPE_TIME
+    inline_cast<TTimestamp, T>::function,            // DAL_TYPE_TIMESTAMP
+    0                                                // DAL_TYPE_INTERVAL
 };
 
 
@@ -73,6 +73,9 @@ typedef uint16_t UCharT;
 
 #define USTRING_DEFAULT_CHARSET "UTF-8"
 
+/// Number of ICU converters cached per thread
+#define USTRING_CONVERTER_CACHE_SIZE 8
+
 #ifdef _WIN32
 #define USTRING_WCHAR_SIZE 2
 #else
@@ -102,16 +105,30 @@ public:
     virtual ~ustring_icu(void)
     {}
 
+    typedef unsigned short charset_id_t;
+
+    /// Returns the process wide id of a charset name.
+    /// Ids are assigned on first use and never reused. Recent names
+    /// are cached per thread, the registry is only locked on a miss.
+    static charset_id_t intern_charset(const std::string &charset);
+
+    /// Opens the converter for charset in the converter cache of the
+    /// calling thread, so the first conversion does not pay for
+    /// ucnv_open(). Throws ConversionError for unknown charsets.
+    static charset_id_t prepare_converter(const std::string &charset);
+
 
 protected:
 
+    /// charset is an id returned by intern_charset()
     size_t from_wide(char *cdest, size_t cdestbuf,
                      const UCharT *wsrc, size_t wlen,
-                     const std::string &charset) const;
+                     charset_id_t charset) const;
 
+    /// charset is an id returned by intern_charset()
     size_t to_wide(UCharT *wdest, size_t wbuflen,
                    const char *csrc, size_t clen,
-                   const std::string &charset) const;
+                   charset_id_t charset) const;
 
 
     size_t utf32_to_utf16(UCharT *wdest, size_t wbuflen,
@@ -196,16 +213,57 @@ public:
     /// @final
     inline void loadUTF8(const char *s)
     {
-        this->m_data.clear();
-        if(s)
+        this->loadUTF8(s, s ? ::strlen(s) : 0);
+    }
+
+
+    /// @final
+    /// @details
+    /// The UTF-8 bytes are stored as they are and the UTF-16 representation
+    /// is built on the first access through a wide API. utf8() and to("UTF-8")
+    /// return the stored bytes without any conversion.
+    /// Strings with extern storage are converted immediately.
+    inline void loadUTF8(const char *s, size_t len)
+    {
+        if(LIKELY(!hasExternStorage()))
         {
-            size_t len = ::strlen(s);
-            ref().resize(len*2); // 4 correct? no ->2
-            size_t c = this->utf8_to_utf16(cptr(), ref().size(),
-                                           s, len);
-            ref().resize(c);
+            this->discard();
+            this->m_data.clear();
+            this->m_narrow.assign(s ? s : "", s ? len : 0);
+            this->set_narrow_cached(USTRING_DEFAULT_CHARSET);
+            this->m_wide_pending = true;
+        }
+        else
+        {
+            this->discard();
+            this->m_data.clear();
+            if(s)
+            {
+                ref().resize(len*2); // 4 correct? no ->2
+                size_t c = this->utf8_to_utf16(cptr(), ref().size(),
+                                               s, len);
+                ref().resize(c);
+            }
+            this->writeStr(this->m_data);
         }
-        this->writeStr(this->m_data);
+    }
+
+
+    /// @final
+    /// Returns true if the string holds UTF-8 data which is not yet
+    /// converted to UTF-16.
+    inline bool isUTF8Pending(void) const
+    {
+        return this->m_wide_pending;
+    }
+
+
+    /// @final
+    /// Returns true if charset names UTF-8
+    static inline bool isUTF8Charset(const std::string &charset)
+    {
+        return charset == "UTF-8" || charset == "utf-8"
+            || charset == "UTF8" || charset == "utf8";
     }
 
 
@@ -213,6 +271,9 @@ public:
     ustring(const char *s)
         : m_data(),
           m_narrow(),
+          m_narrow_charset(),
+          m_narrow_valid(false),
+          m_wide_pending(false),
           m_strptr(0)
 
     {
@@ -225,15 +286,23 @@ public:
     ustring(const char *s, const std::string &charset)
         : m_data(),
           m_narrow(),
+          m_narrow_charset(),
+          m_narrow_valid(false),
+          m_wide_pending(false),
           m_strptr(0)
     {
         if(!s) return;
+        if(isUTF8Charset(charset))
+        {
+            this->loadUTF8(s);
+            return;
+        }
         size_t clen = ::strlen(s);
         this->ref().resize(clen*2);
 
         size_t wlen = this->to_wide(cptr(), ref().size(),
                                     s, clen,
-                                    charset);
+                                    this->intern_charset(charset));
         this->ref().resize(wlen);
     }
 
@@ -242,6 +311,9 @@ public:
     ustring(const wchar_t *s)
         : m_data(),
           m_narrow(),
+          m_narrow_charset(),
+          m_narrow_valid(false),
+          m_wide_pending(false),
           m_strptr(0)
     {
         if(LIKELY(s))
@@ -265,6 +337,9 @@ public:
     ustring(const std::basic_string<wchar_t, B, C> &s)
         : m_data(),
           m_narrow(),
+          m_narrow_charset(),
+          m_narrow_valid(false),
+          m_wide_pending(false),
           m_strptr(0)
     {
         if(s.empty()) return;
@@ -287,24 +362,36 @@ public:
             const std::string &charset = USTRING_DEFAULT_CHARSET)
         : m_data(),
           m_narrow(),
+          m_narrow_charset(),
+          m_narrow_valid(false),
+          m_wide_pending(false),
           m_strptr(0)
     {
         static_assert(sizeof(char) == 1, "Invalid char size");
 
         if(!s.length()) return;
 
+        if(isUTF8Charset(charset))
+        {
+            this->loadUTF8(s.data(), s.size());
+            return;
+        }
+
         ref().resize(s.size()*2); // 4 correct? no -> 2
         size_t wlen = this->to_wide(cptr(), ref().size(),
                                     s.c_str(), s.size(),
-                                    charset);
+                                    this->intern_charset(charset));
         this->ref().resize(wlen);
     }
 
 
     /// @final
     ustring(const string_type &s)
-        : m_data(s.readStr()),
-          m_narrow(),
+        : m_data(s.m_wide_pending ? StrT() : s.readStr()),
+          m_narrow(s.m_narrow_valid ? s.m_narrow : std::string()),
+          m_narrow_charset(s.m_narrow_valid ? s.m_narrow_charset : std::string()),
+          m_narrow_valid(s.m_narrow_valid),
+          m_wide_pending(s.m_wide_pending),
           m_strptr(0)
     {
     }
@@ -314,6 +401,9 @@ public:
     ustring(void)
         : m_data(),
           m_narrow(),
+          m_narrow_charset(),
+          m_narrow_valid(false),
+          m_wide_pending(false),
           m_strptr(0)
     {
     }
@@ -333,6 +423,8 @@ public:
     {
         if(hasExternStorage())
             return this->readStr().empty();
+        else if(this->m_wide_pending)
+            return this->m_narrow.empty();
         else
             return ref().empty();
     }
@@ -366,8 +458,22 @@ public:
     /// @final
     string_type& operator=(const string_type& str)
     {
+        if(this == &str)
+            return *this;
+
+        this->discard();
         if(LIKELY(!hasExternStorage()))
-            m_data = str.hasExternStorage() ? str.readStr() : str.m_data;
+        {
+            if(str.m_wide_pending)
+            {
+                this->m_data.clear();
+                this->m_narrow = str.m_narrow;
+                this->set_narrow_cached(USTRING_DEFAULT_CHARSET);
+                this->m_wide_pending = true;
+            }
+            else
+                m_data = str.hasExternStorage() ? str.readStr() : str.m_data;
+        }
         else
             this->writeStr(str.readStr());
         return *this;
@@ -379,11 +485,7 @@ public:
     string_type& operator=(const std::basic_string<A, B, C>& s)
     {
         string_type tmp(s);
-        if(LIKELY(!hasExternStorage()))
-            this->m_data = tmp.m_data;
-        else
-            this->writeStr(tmp.m_data);
-        return *this;
+        return (*this = tmp);
     }
 
 
@@ -394,7 +496,13 @@ public:
         if(LIKELY(!hasExternStorage()))
         {
             string_type tmp;
-            tmp.m_data = this->m_data;
+            if(this->m_wide_pending && str.m_wide_pending)
+            {
+                tmp.loadUTF8(this->m_narrow.data(), this->m_narrow.size());
+                tmp.m_narrow += str.m_narrow;
+                return tmp;
+            }
+            tmp.m_data = this->ref();
             tmp.m_data += str.readStr();
             return tmp;
         }
@@ -420,6 +528,8 @@ public:
     /// @final
     inline bool operator==(const string_type& str) const
     {
+        if(this->m_wide_pending && str.m_wide_pending)
+            return this->m_narrow == str.m_narrow;
         return this->readStr() == str.readStr();
     }
 
@@ -432,14 +542,21 @@ public:
 
 
     /// @final
+    /// @details
+    /// The converted string is cached until the string is modified
+    /// or converted to another charset.
     const char* utf8(void) const
     {
+        if(this->narrow_cached(USTRING_DEFAULT_CHARSET))
+            return this->m_narrow.c_str();
+
         if(LIKELY(!hasExternStorage()))
         {
             this->m_narrow.resize(ref().size()*4);
             size_t clen = this->utf16_to_utf8(&this->m_narrow[0], this->m_narrow.size(),
                                               ref().c_str(), ref().size());
             this->m_narrow.resize(clen);
+            this->set_narrow_cached(USTRING_DEFAULT_CHARSET);
             return this->m_narrow.c_str();
         }
         else
@@ -455,14 +572,37 @@ public:
 
 
     /// @final
+    /// @details
+    /// Same as utf8(), len is set to the length of the returned
+    /// string in bytes.
+    const char* utf8(size_t &len) const
+    {
+        const char *s = this->utf8();
+        len = this->m_narrow.size();
+        return s;
+    }
+
+
+    /// @final
+    /// @details
+    /// The converted string is cached until the string is modified
+    /// or converted to another charset.
     const char* to(const std::string &charset = USTRING_DEFAULT_CHARSET) const
     {
+        if(this->narrow_cached(charset.c_str()))
+            return this->m_narrow.c_str();
+
         if(LIKELY(!hasExternStorage()))
         {
+            // m_narrow is reused for the new charset, so pending
+            // UTF-8 data must be converted first
+            this->materialize();
             this->m_narrow.resize(ref().size()*4);
             size_t clen = this->from_wide(&this->m_narrow[0], this->m_narrow.size(),
-                                          ref().c_str(), ref().size(), charset);
+                                          ref().c_str(), ref().size(),
+                                          this->intern_charset(charset));
             this->m_narrow.resize(clen);
+            this->set_narrow_cached(charset.c_str());
             return this->m_narrow.c_str();
         }
         else
@@ -470,7 +610,8 @@ public:
             StrT tmp = this->readStr();
             this->m_narrow.resize(tmp.size()*4);
             size_t clen = this->from_wide(&this->m_narrow[0], this->m_narrow.size(),
-                                          tmp.c_str(), tmp.size(), charset);
+                                          tmp.c_str(), tmp.size(),
+                                          this->intern_charset(charset));
             this->m_narrow.resize(clen);
             return this->m_narrow.c_str();
         }
@@ -485,6 +626,7 @@ public:
         if(this->empty())
             return "";
 
+        this->materialize();
         std::wstring tmp(*this);
         std::string out;
         std::locale loc;
@@ -512,6 +654,7 @@ public:
         }
 
         this->m_narrow = out;
+        this->m_narrow_valid = false;
         return this->m_narrow.c_str();
     }
 
@@ -519,8 +662,15 @@ public:
     /// @final
     string_type& operator+=(const string_type& s)
     {
+        if(this->m_wide_pending && s.m_wide_pending)
+        {
+            this->m_narrow += s.m_narrow;
+            return *this;
+        }
+
+        this->touch();
         if(LIKELY(!hasExternStorage()))
-            this->m_data += s.m_data;
+            this->m_data += s.ref();
         else
             this->m_data += s.readStr();
 
@@ -550,7 +700,7 @@ public:
     inline size_t length(void) const
     {
         if(LIKELY(!hasExternStorage()))
-            return this->m_data.length();
+            return this->ref().length();
         else
             return this->readStr().length();
     }
@@ -559,13 +709,14 @@ public:
     /// @final
     size_t capacity(void) const
     {
-        return this->m_data.capacity();
+        return this->ref().capacity();
     }
 
 
     /// @final
     void reserve(size_t res_arg = 0)
     {
+        this->materialize();
         this->m_data.reserve(res_arg);
     }
 
@@ -598,7 +749,7 @@ public:
         return s;
 #else
         if(LIKELY(!hasExternStorage()))
-            return std::wstring(this->m_data.begin(), this->m_data.end());
+            return std::wstring(this->ref().begin(), this->ref().end());
         else
         {
             StrT tmp = this->readStr();
@@ -644,21 +795,25 @@ public:
 
     inline StrT& ref(void)
     {
+        this->touch();
         return this->m_data;
     }
 
     inline const StrT& ref(void) const
     {
+        this->materialize();
         return this->m_data;
     }
 
     inline UCharT* cptr(void)
     {
+        this->touch();
         return &this->m_data[0];
     }
 
     inline const UCharT* cptr(void) const
     {
+        this->materialize();
         return &this->m_data[0];
     }
 
@@ -666,6 +821,7 @@ public:
     template<class A, class B, class C>
     void sync_with(std::basic_string<A, B, C> *str)
     {
+        this->touch();
         delete m_strptr;
         m_strptr = new string_ptr<string_type, std::basic_string<A, B, C> >(str);
     }
@@ -673,14 +829,63 @@ public:
     template<class A, class B, class C>
     void sync_with(const std::basic_string<A, B, C> *str)
     {
+        this->touch();
         delete m_strptr;
         m_strptr = new string_ptr<string_type, const std::basic_string<A, B, C> >(str);
     }
 
 
 private:
-    StrT m_data;
+    /// Drops the cached narrow string, called before each modification.
+    /// Pending UTF-8 data is converted first because the modification
+    /// is applied to the UTF-16 representation.
+    inline void touch(void)
+    {
+        this->materialize();
+        this->m_narrow_valid = false;
+    }
+
+    /// Drops the cached narrow string and any pending UTF-8 data,
+    /// called before the whole string is replaced.
+    inline void discard(void)
+    {
+        this->m_wide_pending = false;
+        this->m_narrow_valid = false;
+    }
+
+    /// Builds the UTF-16 representation from pending UTF-8 data.
+    /// The UTF-8 data stays valid as cached narrow string.
+    inline void materialize(void) const
+    {
+        if(LIKELY(!this->m_wide_pending))
+            return;
+        this->m_data.resize(this->m_narrow.size()*2); // 4 correct? no ->2
+        size_t c = this->utf8_to_utf16(&this->m_data[0], this->m_data.size(),
+                                       this->m_narrow.data(), this->m_narrow.size());
+        this->m_data.resize(c);
+        this->m_wide_pending = false;
+    }
+
+    /// Returns true if m_narrow holds the string in the given charset.
+    /// Strings with extern storage are never cached because the extern
+    /// string may change at any time.
+    inline bool narrow_cached(const char *charset) const
+    {
+        return this->m_narrow_valid && this->m_narrow_charset == charset;
+    }
+
+    inline void set_narrow_cached(const char *charset) const
+    {
+        this->m_narrow_charset = charset;
+        this->m_narrow_valid = true;
+    }
+
+
+    mutable StrT                   m_data;
     mutable std::string            m_narrow;
+    mutable std::string            m_narrow_charset;
+    mutable bool                   m_narrow_valid;
+    mutable bool                   m_wide_pending;
     string_ptr_base<string_type>  *m_strptr;
 };
 
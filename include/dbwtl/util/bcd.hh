@@ -80,6 +80,20 @@ namespace std
 INFORMAVE_BCD_NS_BEGIN
 
 
+//--------------------------------------------------------------------------
+/// Rounding of the last digit of a division result
+///
+/// @since 0.0.1
+/// @brief Rounding modes
+enum bcd_rounding
+{
+    BCD_ROUND_HALF_UP = 0,  ///< round half away from zero
+    BCD_ROUND_HALF_EVEN,    ///< round half to the even digit
+    BCD_ROUND_DOWN,         ///< truncate
+    BCD_ROUND_UP            ///< round away from zero
+};
+
+
 //..............................................................................
 ////////////////////////////////////////////////////////////////////// basic_bcd
 ///
@@ -105,18 +119,30 @@ public:
     static bcd_type tolerance;
     static bcd_type inverse_mfactor;
 
+    /// Minimum number of fractional digits of a division result
+    static size_t division_scale;
+
 
 
 
+    /// @brief Returns the integral part
+    /// @details
+    /// Throws std::out_of_range if it does not fit into a long long.
     signed long long asLongLong(void) const
     {
         std::stringstream ss;
         ss << str();
         signed long long data;
-        ss >> data;
+        if(! (ss >> data))
+            throw std::out_of_range(std::string("Numeric value out of range: ").append(str()));
         return data;
     }
 
+    double asDouble(void) const
+    {
+        return this->convert<double>();
+    }
+
     /// @brief Empty constructor
     basic_bcd(void)
         : m_nibbles(),
@@ -165,8 +191,7 @@ public:
     {
         set_value(num);
         m_scale = scale;
-        if(this->precision() == this->scale())
-            this->m_nibbles.push_front(0);
+        this->fill_front(this->scale() + 1, 0);
         assert(this->precision() > this->scale());
     }
 
@@ -693,8 +718,82 @@ public:
 
     /// @brief Division routine
     /// @details
-    /// Division is done by Newon-Raphson division method.
+    /// The quotient is rounded half up to division_scale or the scale
+    /// of the dividend, whichever is larger.
     void div(const bcd_type &divisor)
+    {
+        this->div(divisor, this->scale() > division_scale ? this->scale() : division_scale,
+                  BCD_ROUND_HALF_UP);
+        this->normalize();
+    }
+
+
+    /// @brief Division routine
+    /// @details
+    /// Exact long division, the quotient has exactly sc fractional
+    /// digits and the last digit is rounded by mode.
+    void div(const bcd_type &divisor, size_t sc, bcd_rounding mode)
+    {
+        if(std::find_if(divisor.nibbles().begin(), divisor.nibbles().end(), non_zero) == divisor.nibbles().end())
+            throw std::domain_error("Division by zero");
+
+        // this / divisor = (A * 10^-sa) / (B * 10^-sb)
+        //                = (A * 10^(sc + sb - sa) / B) * 10^-sc
+        std::vector<value_type> num(this->nibbles().begin(), this->nibbles().end());
+        std::vector<value_type> den(1, 0); // one more digit for the remainder
+        den.insert(den.end(), divisor.nibbles().begin(), divisor.nibbles().end());
+
+        if(sc + divisor.scale() >= this->scale())
+            num.insert(num.end(), sc + divisor.scale() - this->scale(), 0);
+        else
+            den.insert(den.end(), this->scale() - sc - divisor.scale(), 0);
+
+        std::vector<value_type> rem(den.size(), 0);
+        storage_type result;
+
+        for(typename std::vector<value_type>::const_iterator i = num.begin(); i != num.end(); ++i)
+        {
+            std::copy(rem.begin() + 1, rem.end(), rem.begin());
+            rem.back() = *i;
+
+            value_type q = 0;
+            while(! std::lexicographical_compare(rem.begin(), rem.end(), den.begin(), den.end()))
+            {
+                sub_digits(rem, den);
+                ++q;
+            }
+            result.push_back(q);
+        }
+
+        if(round_up(rem, den, result.empty() ? 0 : result.back(), mode))
+        {
+            typename storage_type::reverse_iterator p = result.rbegin();
+            for(; p != result.rend() && *p == 9; ++p)
+                *p = 0;
+            if(p == result.rend())
+                result.push_front(1);
+            else
+                ++*p;
+        }
+
+        while(result.size() > sc + 1 && result.front() == 0)
+            result.pop_front();
+        while(result.size() < sc + 1)
+            result.push_front(0);
+
+        bool sig = this->sign() == divisor.sign()
+            || std::find_if(result.begin(), result.end(), non_zero) == result.end();
+        this->m_nibbles.swap(result);
+        this->m_scale = sc;
+        this->m_sign = sig;
+    }
+
+
+    /// @brief Division routine
+    /// @details
+    /// Division is done by Newon-Raphson division method.
+    /// The result is approximated by the inverse of the divisor.
+    void div_newton(const bcd_type &divisor)
     {
     	if(*this == divisor)
 	{
@@ -798,7 +897,9 @@ public:
     	this->assign(this->shift_left(this->scale()));
     }
 
-    /// @brief 
+    /// @brief Change the scale
+    /// @details
+    /// Reducing the scale rounds, raising the scale appends zeros.
     void rescale(size_t sc)
     {
         typename storage_type::reverse_iterator y = this->nibbles().rbegin();
@@ -819,11 +920,12 @@ public:
             bcd_type a = bcd_type(1).shift_right(this->scale());
             this->add(a);
         }
-	if(this->scale() < sc && this->precision() >= sc)
-	{
-		//std::cout << this->precision() << " / " << sc << std::endl;
-		this->m_scale = sc;
-	}
+        // raising the scale keeps the value, like basic_decimal::rescale()
+        while(this->scale() < sc)
+        {
+            this->nibbles().push_back(0);
+            ++this->m_scale;
+        }
 
         assert(! this->nibbles().empty());
         assert(this->precision() != 0);
@@ -906,6 +1008,51 @@ protected:
         return (9-v);
     }
 
+    static inline bool non_zero(value_type v)
+    {
+        return v != 0;
+    }
+
+
+    /// @brief Subtract two digit sequences of the same length, a >= b
+    static inline void sub_digits(std::vector<value_type> &a, const std::vector<value_type> &b)
+    {
+        int borrow = 0;
+        for(size_t i = a.size(); i > 0; --i)
+        {
+            int v = int(a[i-1]) - int(b[i-1]) - borrow;
+            borrow = v < 0;
+            a[i-1] = value_type(v < 0 ? v + 10 : v);
+        }
+    }
+
+
+    /// @brief Decide if the quotient must be incremented
+    /// @details
+    /// rem is the remainder of the division by den and last the
+    /// last digit of the quotient.
+    static inline bool round_up(const std::vector<value_type> &rem, const std::vector<value_type> &den,
+                                value_type last, bcd_rounding mode)
+    {
+        if(std::find_if(rem.begin(), rem.end(), non_zero) == rem.end())
+            return false;
+
+        // compare rem against den - rem instead of 2 * rem against den
+        std::vector<value_type> half(den);
+        sub_digits(half, rem);
+        bool less = std::lexicographical_compare(rem.begin(), rem.end(), half.begin(), half.end());
+        bool greater = std::lexicographical_compare(half.begin(), half.end(), rem.begin(), rem.end());
+
+        switch(mode)
+        {
+        case BCD_ROUND_DOWN:      return false;
+        case BCD_ROUND_UP:        return true;
+        case BCD_ROUND_HALF_EVEN: return greater || (!less && (last % 2));
+        case BCD_ROUND_HALF_UP:
+        default:                  return !less;
+        }
+    }
+
 
 protected:
     StorageContainer  m_nibbles;
@@ -941,6 +1088,9 @@ basic_bcd<StorageContainer> basic_bcd<StorageContainer>::tolerance("0.0000000000
 template<typename StorageContainer>
 basic_bcd<StorageContainer> basic_bcd<StorageContainer>::inverse_mfactor("2.914", std::locale("C"));
 
+template<typename StorageContainer>
+size_t basic_bcd<StorageContainer>::division_scale = 14;
+
 
 INFORMAVE_BCD_NS_END
 
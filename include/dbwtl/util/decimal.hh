@@ -0,0 +1,966 @@
+//
+// decimal.hh - Fixed size decimal class
+//
+// Copyright (C)         informave.org
+//   2011,               Daniel Vogelbacher <daniel@vogelbacher.name>
+//
+// BSD License
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the
+// distribution.
+//
+// Neither the name of the copyright holders nor the names of its
+// contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/// @file
+/// @brief Fixed size decimal class
+/// @author Daniel Vogelbacher
+/// @since 0.0.1
+
+
+#ifndef INFORMAVE_UTILS_DECIMAL_HH
+#define INFORMAVE_UTILS_DECIMAL_HH
+
+#include "dbwtl/util/bcd.hh"
+
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <memory>
+#include <sstream>
+#include <locale>
+#include <cmath>
+#include <limits>
+
+
+#if defined(__SIZEOF_INT128__)
+
+#define INFORMAVE_HAVE_DECIMAL128
+
+
+INFORMAVE_BCD_NS_BEGIN
+
+__extension__ typedef unsigned __int128 decimal_coeff_t;
+
+
+//..............................................................................
+////////////////////////////////////////////////////////////////// basic_decimal
+///
+/// @details
+/// The value is stored as 128 bit unsigned coefficient, a sign and a
+/// decimal scale (value = coefficient * 10^-scale). This covers up to
+/// 38 significant digits without any heap allocation.
+///
+/// Values with more digits are stored in a basic_bcd<StorageContainer>
+/// and all operations on them are forwarded to basic_bcd. Results are
+/// moved back to the fixed size representation if they fit.
+///
+/// @since 0.0.1
+/// @brief Fixed size decimal class
+template<typename StorageContainer>
+class basic_decimal
+{
+public:
+    typedef basic_decimal<StorageContainer>      decimal_type;
+    typedef basic_bcd<StorageContainer>          bcd_type;
+    typedef decimal_coeff_t                      coeff_type;
+
+    /// Maximum number of digits in the fixed size representation
+    enum { max_digits = 38 };
+
+    /// Minimum number of fractional digits of a division result
+    static size_t division_scale;
+
+
+    /// @brief Empty constructor
+    basic_decimal(void)
+        : m_coeff(0),
+          m_scale(0),
+          m_sign(true),
+          m_wide()
+    {}
+
+    /// @brief Copy constructor
+    basic_decimal(const basic_decimal &orig)
+        : m_coeff(orig.m_coeff),
+          m_scale(orig.m_scale),
+          m_sign(orig.m_sign),
+          m_wide(orig.m_wide ? new bcd_type(*orig.m_wide) : 0)
+    {}
+
+    /// @brief Move constructor
+    basic_decimal(basic_decimal &&orig)
+        : m_coeff(orig.m_coeff),
+          m_scale(orig.m_scale),
+          m_sign(orig.m_sign),
+          m_wide(std::move(orig.m_wide))
+    {}
+
+    /// @brief Construct from long long
+    basic_decimal(long long v)
+        : m_coeff(0),
+          m_scale(0),
+          m_sign(true),
+          m_wide()
+    {
+        set_value(v);
+    }
+
+    /// @brief Construct from long long and specific scale
+    basic_decimal(long long num, unsigned short scale)
+        : m_coeff(0),
+          m_scale(0),
+          m_sign(true),
+          m_wide()
+    {
+        set_value(num);
+        m_scale = scale;
+    }
+
+    /// @brief Construct from string
+    basic_decimal(const std::string &v, const std::locale &loc = std::locale())
+        : m_coeff(0),
+          m_scale(0),
+          m_sign(true),
+          m_wide()
+    {
+        set_strvalue(v, loc);
+    }
+
+    /// @brief Construct from a BCD value
+    explicit basic_decimal(const bcd_type &v)
+        : m_coeff(0),
+          m_scale(0),
+          m_sign(true),
+          m_wide()
+    {
+        from_bcd(v);
+    }
+
+    static basic_decimal from_float(float v)
+    {
+        basic_decimal d;
+        d.set_value(static_cast<double>(v));
+        return d;
+    }
+
+    static basic_decimal from_double(double v)
+    {
+        basic_decimal d;
+        d.set_value(v);
+        return d;
+    }
+
+
+    basic_decimal& operator=(const basic_decimal &v)
+    {
+        if(this != &v)
+            this->assign(v);
+        return *this;
+    }
+
+    basic_decimal& operator=(basic_decimal &&v)
+    {
+        this->m_coeff = v.m_coeff;
+        this->m_scale = v.m_scale;
+        this->m_sign = v.m_sign;
+        this->m_wide = std::move(v.m_wide);
+        return *this;
+    }
+
+    void assign(const basic_decimal &v)
+    {
+        this->m_coeff = v.m_coeff;
+        this->m_scale = v.m_scale;
+        this->m_sign = v.m_sign;
+        this->m_wide.reset(v.m_wide ? new bcd_type(*v.m_wide) : 0);
+    }
+
+
+    /// @brief Returns the scale
+    size_t scale(void) const
+    {
+        return m_wide ? m_wide->scale() : this->m_scale;
+    }
+
+    /// @brief Returns the precision
+    size_t precision(void) const
+    {
+        if(m_wide)
+            return m_wide->precision();
+        size_t n = digits(m_coeff);
+        return n > m_scale ? n : m_scale + 1;
+    }
+
+    /// @brief Return sign
+    bool sign(void) const
+    {
+        return m_wide ? m_wide->sign() : this->m_sign;
+    }
+
+    /// @brief Returns true if the value is stored as BCD
+    bool is_wide(void) const
+    {
+        return m_wide.get() != 0;
+    }
+
+    /// @brief Returns the unsigned coefficient
+    /// @note Only valid if is_wide() is false
+    coeff_type coefficient(void) const
+    {
+        return this->m_coeff;
+    }
+
+
+    /// @brief Returns the integral part
+    /// @details
+    /// Throws std::out_of_range if it does not fit into a long long.
+    signed long long asLongLong(void) const
+    {
+        return this->convert<signed long long>();
+    }
+
+    /// @brief Returns the nearest double value
+    double asDouble(void) const
+    {
+        if(m_wide)
+            return m_wide->template convert<double>();
+        long double v = static_cast<long double>(m_coeff);
+        if(m_scale <= size_t(max_digits))
+            v /= static_cast<long double>(pow10(m_scale));
+        else
+            v /= std::pow(10.0L, static_cast<long double>(m_scale));
+        return static_cast<double>(m_sign ? v : -v);
+    }
+
+    template<typename T>
+    T convert(void) const
+    {
+        return convert_to<T>(std::integral_constant<int, std::is_integral<T>::value ? 1
+                             : (std::is_floating_point<T>::value ? 2 : 0)>());
+    }
+
+
+    /// @brief Set value as long
+    void set_value(long long v)
+    {
+        m_wide.reset();
+        m_sign = v >= 0;
+        m_scale = 0;
+        m_coeff = v >= 0 ? coeff_type(v) : coeff_type(0) - coeff_type(v);
+    }
+
+    /// @details
+    /// Produces the same value as basic_bcd, which rounds to six
+    /// fractional digits. Small values are converted directly, all
+    /// other values are formatted and parsed like in basic_bcd.
+    void set_value(double v)
+    {
+        if(std::isfinite(v) && std::fabs(v) < 1e12)
+        {
+            m_wide.reset();
+            m_sign = !(v < 0);
+            m_scale = 6;
+            long double x = std::floor(std::fabs(static_cast<long double>(v)) * 1e6L + 0.5L);
+            m_coeff = static_cast<coeff_type>(static_cast<unsigned long long>(x));
+            this->normalize();
+        }
+        else
+        {
+            std::stringstream ss;
+            std::locale loc("C");
+            ss.imbue(loc);
+            ss << std::fixed << v;
+            set_strvalue(ss.str(), loc);
+        }
+    }
+
+    void set_value(float v)
+    {
+        set_value(static_cast<double>(v));
+    }
+
+
+    /// @brief Set value as string
+    void set_strvalue(const std::string &s, const std::locale &loc)
+    {
+        m_wide.reset();
+        m_coeff = 0;
+        m_sign = true;
+        m_scale = 0;
+
+        if(s.size() == 0) return;
+
+        std::string::size_type i = 0;
+
+        if(s[0] == '+' || s[0] == '-')
+        {
+            m_sign = s[0] == '+';
+            ++i;
+        }
+
+        if(i == s.size()) throw std::invalid_argument(std::string("Invalid numeric value: ").append(s));
+
+        const char radix_separator = std::use_facet<std::numpunct<char> >(loc).decimal_point();
+        const char thousands_separator = std::use_facet<std::numpunct<char> >(loc).thousands_sep();
+        bool dot = false;
+        size_t n = 0;
+
+        for(; i < s.size(); ++i)
+        {
+            if(!dot && s[i] == radix_separator)
+            {
+                dot = true;
+                continue;
+            }
+            if(s[i] == thousands_separator)
+                continue;
+            if(s[i] < 0x30 || s[i] > 0x39)
+                throw std::invalid_argument(std::string("Invalid numeric value: ").append(s));
+            if(n == size_t(max_digits))
+            {
+                from_bcd(bcd_type(s, loc));
+                return;
+            }
+            m_coeff = m_coeff * 10 + (s[i] - 0x30);
+            if(m_coeff) ++n;
+            if(dot) ++m_scale;
+        }
+
+        this->normalize();
+    }
+
+
+    /// @brief Convert number to string
+    std::string str(const std::locale &loc = std::locale("")) const
+    {
+        if(m_wide)
+            return m_wide->str(loc);
+
+        char buf[max_digits + 1];
+        char *end = buf + sizeof(buf);
+        char *p = to_chars(m_coeff, end);
+        std::string s(p, end);
+        if(s.size() <= m_scale)
+            s.insert(0, m_scale + 1 - s.size(), '0');
+
+        if(m_scale)
+        {
+            std::numpunct<std::string::value_type> const &n = std::use_facet<std::numpunct<std::string::value_type> >(loc);
+
+            return std::string(this->sign() ? "" : "-") + s.substr(0, s.size() - m_scale)
+                + n.decimal_point() + s.substr(s.size() - m_scale);
+        }
+        else
+            return std::string(this->sign() ? "" : "-") + s;
+    }
+
+
+    /// @brief Returns a value < 0, 0 or > 0 if *this is less, equal or greater than b
+    int compare(const basic_decimal &b) const
+    {
+        if(!m_wide && !b.m_wide)
+        {
+            if(m_coeff == 0 && b.m_coeff == 0)
+                return 0;
+            if(m_sign != b.m_sign)
+                return m_sign ? 1 : -1;
+
+            coeff_type ca, cb;
+            size_t sc;
+            if(align(*this, b, ca, cb, sc))
+            {
+                int c = ca < cb ? -1 : (ca > cb ? 1 : 0);
+                return m_sign ? c : -c;
+            }
+        }
+        bcd_type x(this->to_bcd()), y(b.to_bcd());
+        return x < y ? -1 : (x == y ? 0 : 1);
+    }
+
+    bool operator<(const basic_decimal &b) const  { return this->compare(b) < 0; }
+    bool operator>(const basic_decimal &b) const  { return this->compare(b) > 0; }
+    bool operator==(const basic_decimal &b) const { return this->compare(b) == 0; }
+    bool operator!=(const basic_decimal &b) const { return this->compare(b) != 0; }
+    bool operator>=(const basic_decimal &b) const { return this->compare(b) >= 0; }
+    bool operator<=(const basic_decimal &b) const { return this->compare(b) <= 0; }
+
+
+    basic_decimal& operator+=(const basic_decimal &b)
+    {
+        this->add(b, false);
+        return *this;
+    }
+
+    basic_decimal& operator-=(const basic_decimal &b)
+    {
+        this->add(b, true);
+        return *this;
+    }
+
+    basic_decimal& operator*=(const basic_decimal &b)
+    {
+        this->mul(b);
+        return *this;
+    }
+
+    basic_decimal& operator/=(const basic_decimal &b)
+    {
+        this->div(b);
+        return *this;
+    }
+
+    basic_decimal operator+(const basic_decimal &b) const
+    {
+        basic_decimal result(*this);
+        result += b;
+        return result;
+    }
+
+    basic_decimal operator-(const basic_decimal &b) const
+    {
+        basic_decimal result(*this);
+        result -= b;
+        return result;
+    }
+
+    basic_decimal operator*(const basic_decimal &b) const
+    {
+        basic_decimal result(*this);
+        result *= b;
+        return result;
+    }
+
+    basic_decimal operator/(const basic_decimal &b) const
+    {
+        basic_decimal result(*this);
+        result /= b;
+        return result;
+    }
+
+    /// @details
+    /// The result has the sign of *this (truncated division).
+    basic_decimal operator%(const basic_decimal &b) const
+    {
+        if(b.is_zero())
+            throw std::domain_error("Division by zero");
+
+        if(!m_wide && !b.m_wide)
+        {
+            basic_decimal result;
+            coeff_type ca, cb;
+            if(align(*this, b, ca, cb, result.m_scale))
+            {
+                result.m_coeff = ca % cb;
+                result.m_sign = m_sign;
+                result.normalize();
+                return result;
+            }
+        }
+        return basic_decimal(this->to_bcd() % b.to_bcd());
+    }
+
+
+    /// @brief Addition and subtraction routine
+    void add(const basic_decimal &b, bool negate)
+    {
+        if(!m_wide && !b.m_wide)
+        {
+            coeff_type ca, cb;
+            size_t sc;
+            if(align(*this, b, ca, cb, sc))
+            {
+                bool sb = b.m_sign != negate;
+                if(m_sign == sb)
+                {
+                    if(ca + cb <= max_coeff())
+                    {
+                        m_coeff = ca + cb;
+                        m_scale = sc;
+                        this->normalize();
+                        return;
+                    }
+                }
+                else
+                {
+                    if(ca >= cb)
+                        m_coeff = ca - cb;
+                    else
+                    {
+                        m_coeff = cb - ca;
+                        m_sign = sb;
+                    }
+                    m_scale = sc;
+                    this->normalize();
+                    return;
+                }
+            }
+        }
+        bcd_type r(this->to_bcd());
+        if(negate)
+            r -= b.to_bcd();
+        else
+            r += b.to_bcd();
+        this->from_bcd(r);
+    }
+
+
+    /// @brief Multiplication routine
+    void mul(const basic_decimal &b)
+    {
+        if(!m_wide && !b.m_wide)
+        {
+            coeff_type r;
+            if(!__builtin_mul_overflow(m_coeff, b.m_coeff, &r) && r <= max_coeff())
+            {
+                m_coeff = r;
+                m_scale += b.m_scale;
+                m_sign = (m_sign == b.m_sign);
+                this->normalize();
+                return;
+            }
+        }
+        bcd_type r(this->to_bcd());
+        r *= b.to_bcd();
+        this->from_bcd(r);
+    }
+
+
+    /// @brief Division routine
+    /// @details
+    /// The quotient is rounded half up to division_scale or the scale
+    /// of the dividend, whichever is larger.
+    void div(const basic_decimal &b)
+    {
+        if(b.is_zero())
+            throw std::domain_error("Division by zero");
+
+        if(this->div_fixed(b, this->scale() > division_scale ? this->scale() : division_scale, BCD_ROUND_HALF_UP))
+            this->normalize();
+        else
+        {
+            bcd_type r(this->to_bcd());
+            r /= b.to_bcd();
+            this->from_bcd(r);
+        }
+    }
+
+
+    /// @brief Division routine
+    /// @details
+    /// The quotient has exactly sc fractional digits and the last
+    /// digit is rounded by mode.
+    void div(const basic_decimal &b, size_t sc, bcd_rounding mode)
+    {
+        if(b.is_zero())
+            throw std::domain_error("Division by zero");
+
+        if(! this->div_fixed(b, sc, mode))
+        {
+            bcd_type r(this->to_bcd());
+            r.div(b.to_bcd(), sc, mode);
+            this->from_bcd(r);
+        }
+    }
+
+
+    /// @brief Change sign to +
+    inline void make_positive(void)
+    {
+        if(m_wide)
+            m_wide->make_positive();
+        this->m_sign = true;
+    }
+
+    inline void make_negative(void)
+    {
+        if(m_wide)
+            m_wide->make_negative();
+        this->m_sign = false;
+    }
+
+
+    /// @brief Shift the decimal point behind the last digit
+    void zeroscale(void)
+    {
+        if(m_wide)
+        {
+            bcd_type r(*m_wide);
+            r.zeroscale();
+            this->from_bcd(r);
+        }
+        else
+            m_scale = 0;
+    }
+
+
+    /// @brief Change the scale
+    /// @details
+    /// Reducing the scale rounds half away from zero. Raising the scale
+    /// keeps the value and appends zeros, like basic_bcd::rescale(). If
+    /// the coefficient gets more than max_digits digits, the value is
+    /// stored as BCD.
+    void rescale(size_t sc)
+    {
+        if(m_wide)
+        {
+            bcd_type r(*m_wide);
+            r.rescale(sc);
+            this->from_bcd(r);
+        }
+        else if(m_scale > sc)
+        {
+            size_t k = m_scale - sc;
+            if(k > size_t(max_digits))
+                m_coeff = 0;
+            else
+            {
+                coeff_type p = pow10(k);
+                coeff_type q = m_coeff / p;
+                if((m_coeff % p) * 2 >= p)
+                    ++q;
+                m_coeff = q;
+            }
+            m_scale = sc;
+        }
+        else if(m_scale < sc)
+        {
+            coeff_type c;
+            if(upscale(m_coeff, sc - m_scale, c))
+            {
+                m_coeff = c;
+                m_scale = sc;
+            }
+            else
+            {
+                bcd_type r = this->to_bcd();
+                r.rescale(sc);
+                this->from_bcd(r);
+            }
+        }
+    }
+
+
+    /// @brief Returns the value as BCD
+    bcd_type to_bcd(void) const
+    {
+        if(m_wide)
+            return *m_wide;
+        std::locale loc("C");
+        return bcd_type(this->str(loc), loc);
+    }
+
+
+protected:
+    /// Converts the integral part, throws std::out_of_range if it does
+    /// not fit into T
+    template<typename T>
+    T convert_to(std::integral_constant<int, 1>) const
+    {
+        if(m_wide)
+        {
+            std::locale loc("C");
+            std::string s = m_wide->str(loc);
+            std::string::size_type p = s.find('.');
+            if(p != std::string::npos)
+                s.erase(p);
+            basic_decimal i(s, loc);
+            if(i.is_wide())
+                throw std::out_of_range("Numeric value out of range: " + this->str(loc));
+            return i.template convert<T>();
+        }
+
+        coeff_type v = integral_part();
+        if(std::is_same<T, bool>::value)
+            return static_cast<T>(v != 0);
+        if(m_sign || v == 0)
+        {
+            if(v > coeff_type(std::numeric_limits<T>::max()))
+                throw std::out_of_range("Numeric value out of range: " + this->str(std::locale("C")));
+            return static_cast<T>(v);
+        }
+        // -v is computed as -(v-1)-1, so the minimum of T does not overflow
+        if(! std::numeric_limits<T>::is_signed || v - 1 > coeff_type(std::numeric_limits<T>::max()))
+            throw std::out_of_range("Numeric value out of range: " + this->str(std::locale("C")));
+        return static_cast<T>(- static_cast<T>(v - 1) - 1);
+    }
+
+    template<typename T>
+    T convert_to(std::integral_constant<int, 2>) const
+    {
+        return static_cast<T>(this->asDouble());
+    }
+
+    template<typename T>
+    T convert_to(std::integral_constant<int, 0>) const
+    {
+        std::stringstream ss;
+        ss << str();
+        T x;
+        ss >> x;
+        return x;
+    }
+
+
+    /// @brief Take over a BCD value, narrow it if possible
+    void from_bcd(const bcd_type &v)
+    {
+        if(v.precision() > size_t(max_digits))
+        {
+            m_wide.reset(new bcd_type(v));
+            m_coeff = 0;
+            m_scale = 0;
+            m_sign = true;
+            return;
+        }
+        m_wide.reset();
+        m_coeff = 0;
+        for(typename bcd_type::storage_type::const_iterator i = v.nibbles().begin();
+            i != v.nibbles().end(); ++i)
+        {
+            m_coeff = m_coeff * 10 + *i;
+        }
+        m_scale = v.scale();
+        m_sign = v.sign() || m_coeff == 0;
+    }
+
+
+    bool is_zero(void) const
+    {
+        return m_wide ? *m_wide == bcd_type(0) : m_coeff == 0;
+    }
+
+
+    coeff_type integral_part(void) const
+    {
+        return m_scale > size_t(max_digits) ? 0 : m_coeff / pow10(m_scale);
+    }
+
+
+    /// @brief Remove trailing zeros of the fraction
+    void normalize(void)
+    {
+        while(m_scale && m_coeff % 10 == 0 && m_coeff)
+        {
+            m_coeff /= 10;
+            --m_scale;
+        }
+        if(m_coeff == 0)
+        {
+            m_scale = 0;
+            m_sign = true;
+        }
+    }
+
+
+    /// @brief Division of two fixed size values
+    /// @return false if an operand or the result does not fit
+    bool div_fixed(const basic_decimal &b, size_t sc, bcd_rounding mode)
+    {
+        if(m_wide || b.m_wide)
+            return false;
+
+        // (A * 10^-sa) / (B * 10^-sb) = (A * 10^(sc + sb - sa) / B) * 10^-sc
+        coeff_type n = m_coeff, d = b.m_coeff;
+        bool fits = sc + b.m_scale >= m_scale
+            ? upscale(m_coeff, sc + b.m_scale - m_scale, n)
+            : upscale(b.m_coeff, m_scale - sc - b.m_scale, d);
+        if(!fits)
+            return false;
+
+        coeff_type q = n / d;
+        if(round_up(q, n % d, d, mode))
+            ++q;
+        if(q > max_coeff())
+            return false;
+
+        m_coeff = q;
+        m_scale = sc;
+        m_sign = (m_sign == b.m_sign) || q == 0;
+        return true;
+    }
+
+
+    /// @brief Decide if the quotient q with remainder r of a division
+    /// by d must be incremented
+    static inline bool round_up(coeff_type q, coeff_type r, coeff_type d, bcd_rounding mode)
+    {
+        if(r == 0)
+            return false;
+        switch(mode)
+        {
+        case BCD_ROUND_DOWN:      return false;
+        case BCD_ROUND_UP:        return true;
+        case BCD_ROUND_HALF_EVEN: return r > d - r || (r == d - r && (q % 2));
+        case BCD_ROUND_HALF_UP:
+        default:                  return r >= d - r;
+        }
+    }
+
+
+    /// @brief Brings both coefficients to the same scale
+    /// @return false if one coefficient does not fit
+    static inline bool align(const basic_decimal &a, const basic_decimal &b,
+                             coeff_type &ca, coeff_type &cb, size_t &sc)
+    {
+        sc = a.m_scale > b.m_scale ? a.m_scale : b.m_scale;
+        return upscale(a.m_coeff, sc - a.m_scale, ca) && upscale(b.m_coeff, sc - b.m_scale, cb);
+    }
+
+
+    /// @brief Multiplies c by 10^k
+    /// @return false if the result has more than max_digits digits
+    static inline bool upscale(coeff_type c, size_t k, coeff_type &result)
+    {
+        if(k == 0 || c == 0)
+        {
+            result = c;
+            return true;
+        }
+        if(k > size_t(max_digits) || c > max_coeff() / pow10(k))
+            return false;
+        result = c * pow10(k);
+        return true;
+    }
+
+
+    static inline coeff_type pow10(size_t n)
+    {
+        static const struct table
+        {
+            table(void)
+            {
+                v[0] = 1;
+                for(size_t i = 1; i <= size_t(max_digits); ++i)
+                    v[i] = v[i-1] * 10;
+            }
+            coeff_type v[max_digits + 1];
+        } t;
+        assert(n <= size_t(max_digits));
+        return t.v[n];
+    }
+
+
+    static inline coeff_type max_coeff(void)
+    {
+        return pow10(max_digits) - 1;
+    }
+
+
+    /// @brief Number of decimal digits of c, 1 for 0
+    static inline size_t digits(coeff_type c)
+    {
+        size_t n = 1;
+        while(n < size_t(max_digits) && c >= pow10(n)) ++n;
+        return n;
+    }
+
+
+    /// @brief Writes the digits of c in front of end
+    static inline char* to_chars(coeff_type c, char *end)
+    {
+        while(c >> 64)
+        {
+            *--end = static_cast<char>(0x30 + static_cast<int>(c % 10));
+            c /= 10;
+        }
+        unsigned long long v = static_cast<unsigned long long>(c);
+        do
+        {
+            *--end = static_cast<char>(0x30 + static_cast<int>(v % 10));
+            v /= 10;
+        }
+        while(v);
+        return end;
+    }
+
+
+protected:
+    coeff_type                  m_coeff;
+    size_t                      m_scale;
+    bool                        m_sign;
+    std::unique_ptr<bcd_type>   m_wide;
+};
+
+
+
+
+template<typename T, typename U>
+basic_decimal<T> operator+(const U &a, const basic_decimal<T> &b) { return basic_decimal<T>(a) + b; }
+
+template<typename T, typename U>
+basic_decimal<T> operator-(const U &a, const basic_decimal<T> &b) { return basic_decimal<T>(a) - b; }
+
+template<typename T, typename U>
+basic_decimal<T> operator*(const U &a, const basic_decimal<T> &b) { return basic_decimal<T>(a) * b; }
+
+template<typename T, typename U>
+basic_decimal<T> operator/(const U &a, const basic_decimal<T> &b) { return basic_decimal<T>(a) / b; }
+
+
+template<typename T, typename U>
+basic_decimal<T> divi(const U &a, const basic_decimal<T> &b) { basic_decimal<T> x = basic_decimal<T>(a) / b; x.rescale(0); return x; }
+
+typedef informave::utils::basic_decimal<std::deque<uint8_t> > decimal;
+
+
+template<typename StorageContainer>
+size_t basic_decimal<StorageContainer>::division_scale = 14;
+
+
+INFORMAVE_BCD_NS_END
+
+
+
+template<typename T>
+std::ostream& operator<<(std::ostream& o, const informave::utils::basic_decimal<T> &d) { return (o << d.str()); }
+
+
+
+namespace std
+{
+    template<typename T>
+    informave::utils::basic_decimal<T> abs(const informave::utils::basic_decimal<T> &v)
+    {
+        informave::utils::basic_decimal<T> r(v);
+        r.make_positive();
+        return r;
+    }
+}
+
+
+#endif // __SIZEOF_INT128__
+
+#endif
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
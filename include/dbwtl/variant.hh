@@ -50,10 +50,14 @@
 #include "dbwtl/util/smartptr.hh"
 
 #include <memory>
+#include <new>
+#include <limits>
 #include <type_traits>
 //#include <iostream>
 #include <sstream>
 #include <locale>
+#include <vector>
+#include <cstring>
 
 
 DB_NAMESPACE_BEGIN
@@ -95,6 +99,10 @@ struct DBWTL_EXPORT BinaryOperatorVariant
 
 Variant DBWTL_EXPORT apply_binary_method(const Variant &op0, const Variant &op1, BinaryOperatorVariant::memfun_type method);
 
+/// Returns the statically allocated operator implementation for
+/// the given operand types. The returned object is never freed.
+DBWTL_EXPORT const BinaryOperatorVariant* binary_operator_for(daltype_t t0, daltype_t t1);
+
 
 
 void DBWTL_EXPORT throw_read_only(void);
@@ -187,6 +195,57 @@ struct DBWTL_EXPORT variant_writter
 };
 
 
+//..............................................................................
+////////////////////////////////////////////////////////////////////// utf8_view
+///
+/// @since 0.0.1
+/// @brief Borrowed UTF-8 text
+/// @detail
+/// Points into a buffer owned by the value store, e.g. the column buffer
+/// of a resultset. The view does not own the data and is only valid until
+/// the resultset moves to the next row or the value is modified.
+struct DBWTL_EXPORT utf8_view
+{
+    utf8_view(void) : m_ptr(""), m_len(0) {}
+
+    utf8_view(const char *ptr, size_t len) : m_ptr(ptr), m_len(len) {}
+
+    inline const char* data(void) const { return this->m_ptr; }
+    inline size_t      size(void) const { return this->m_len; }
+    inline bool        empty(void) const { return this->m_len == 0; }
+
+    /// Copies the text into an owning string
+    inline std::string str(void) const { return std::string(this->m_ptr, this->m_len); }
+
+    inline bool operator==(const utf8_view &v) const
+    {
+        return this->m_len == v.m_len
+            && (this->m_len == 0 || ::memcmp(this->m_ptr, v.m_ptr, this->m_len) == 0);
+    }
+
+    inline bool operator!=(const utf8_view &v) const { return !(*this == v); }
+
+private:
+    const char *m_ptr;
+    size_t      m_len;
+};
+
+
+//..............................................................................
+///////////////////////////////////////////////////////////// supports_utf8_view
+///
+/// @since 0.0.1
+/// @brief Interface for value stores which can lend their text as UTF-8
+/// @detail
+/// get_utf8_view() returns false if the text is not available as UTF-8
+/// without a conversion (non-text values, other charsets).
+struct DBWTL_EXPORT supports_utf8_view
+{
+    virtual bool get_utf8_view(utf8_view &view) const = 0;
+    virtual ~supports_utf8_view(void) {}
+};
+
+
 //..............................................................................
 /////////////////////////////////////////////////////////////////////// var_info
 ///
@@ -265,9 +324,15 @@ template<typename U, typename T>
 struct supports_cast : public virtual sa_base<U>, /// @todo rename to supports_implicit_cast
                        public supports<T>
 {
+    /// The conversion without an accessor, used by inline_cast
+    static inline T convert_value(const U &value)
+    {
+        return (T)value;
+    }
+
     virtual T cast(T*, std::locale) const
     {    	
-    	return (T)this->get_value();
+    	return convert_value(this->get_value());
     }
 };
 
@@ -386,9 +451,15 @@ template<typename U, typename T>
 struct supports_integral_type_cast : public virtual sa_base<U>,
                                      public supports<T>
 {
+    /// The conversion without an accessor, used by inline_cast
+    static inline T convert_value(const U &value)
+    {
+        return arithmetic_cast<U, T>(value);
+    }
+
     virtual T cast(T*, std::locale) const
     {
-        return arithmetic_cast<U, T>(this->get_value());
+        return convert_value(this->get_value());
     }
 };
 
@@ -397,9 +468,14 @@ template<typename U>
 struct supports_integral_type_cast<U, bool> : public virtual sa_base<U>,
                                      public supports<bool>
 {
+    static inline bool convert_value(const U &value)
+    {
+        return value ? true : false;
+    }
+
     virtual bool cast(bool*, std::locale) const
     {
-        return this->get_value() ? true : false;
+        return convert_value(this->get_value());
     }
 };
 
@@ -652,6 +728,99 @@ struct value_traits<const T*>
 
 
 
+//..............................................................................
+///////////////////////////////////////////////////////////////// inline_storage
+///
+/// @since 0.0.1
+/// @brief Marks types which are stored inside the Variant
+/// @detail
+/// Values of these types are placed into the inline buffer of the Variant
+/// instead of a heap allocated variant_value<>. All other types (strings,
+/// LOBs, numerics, engine accessors...) still use the IVariantValue store.
+template<typename T> struct inline_storage : public std::false_type {};
+
+template<> struct inline_storage<signed int>         : public std::true_type {};
+template<> struct inline_storage<unsigned int>       : public std::true_type {};
+template<> struct inline_storage<signed char>        : public std::true_type {};
+template<> struct inline_storage<unsigned char>      : public std::true_type {};
+template<> struct inline_storage<bool>               : public std::true_type {};
+template<> struct inline_storage<signed short>       : public std::true_type {};
+template<> struct inline_storage<unsigned short>     : public std::true_type {};
+template<> struct inline_storage<signed long long>   : public std::true_type {};
+template<> struct inline_storage<unsigned long long> : public std::true_type {};
+template<> struct inline_storage<float>              : public std::true_type {};
+template<> struct inline_storage<double>             : public std::true_type {};
+template<> struct inline_storage<TDate>              : public std::true_type {};
+template<> struct inline_storage<TTime>              : public std::true_type {};
+template<> struct inline_storage<TTimestamp>         : public std::true_type {};
+
+
+/// Size of the inline buffer, must be large enough for TTimestamp
+#define DBWTL_VARIANT_INLINE_SIZE 24
+
+/// Size of the stack buffer for inline_accessor
+#define DBWTL_VARIANT_ACCESSOR_SIZE 256
+
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////// inline_accessor
+///
+/// @since 0.0.1
+/// @brief Temporary value store for an inline Variant value
+/// @detail
+/// Constructs a const_ptr_value<> for the inline value inside a stack
+/// buffer, so the cast methods of the sv_accessor<> specializations can
+/// be used without allocating a value store on the heap.
+class DBWTL_EXPORT inline_accessor
+{
+public:
+    inline_accessor(const Variant &var);
+
+    ~inline_accessor(void);
+
+    inline const IVariantValue* get(void) const { return this->m_value; }
+
+private:
+    union
+    {
+        void*         align_ptr;
+        long long     align_ll;
+        double        align_d;
+        unsigned char raw[DBWTL_VARIANT_ACCESSOR_SIZE];
+    } m_buf;
+
+    IVariantValue *m_value;
+
+    inline_accessor(const inline_accessor&);
+    inline_accessor& operator=(const inline_accessor&);
+};
+
+
+
+//..............................................................................
+////////////////////////////////////////////////////////////// inline_conversion
+///
+/// @since 0.0.1
+/// @brief Conversion table for inline values
+/// @detail
+/// The table is indexed by the daltype of an inline value and holds the
+/// function which converts the value to T, or a null pointer if the
+/// sv_accessor<> of the source type does not support T. This replaces
+/// the dynamic_cast<> to supports<T> for inline values.
+/// loc is null if the caller did not pass a locale, the global locale
+/// is only constructed by conversions which use a locale then.
+/// The table is defined in types.hh.
+template<typename T>
+struct inline_conversion
+{
+    typedef T (*function_type)(const void *value, const std::locale *loc);
+
+    static const function_type table[DAL_TYPE_COUNT];
+};
+
+
+
 //..............................................................................
 ////////////////////////////////////////////////////////////////////// Converter
 ///
@@ -693,16 +862,20 @@ public:
         Variant(const T& value, const char *utf8name = 0)
         : m_storage(),
 	 m_name_ptr(utf8name),
-        m_type_ifnull(DAL_TYPE_UNKNOWN)
+        m_type_ifnull(DAL_TYPE_UNKNOWN),
+        m_inline(),
+        m_inline_type(DAL_TYPE_UNKNOWN)
         {
-            this->m_storage.reset(new typename value_traits<T>::stored_type(value));
+            this->init_value(value, inline_storage<T>());
         }
 
     ///
     Variant(const Variant& value)
         : m_storage(),
         m_name_ptr(value.m_name_ptr),
-        m_type_ifnull(value.m_type_ifnull)
+        m_type_ifnull(value.m_type_ifnull),
+        m_inline(),
+        m_inline_type(DAL_TYPE_UNKNOWN)
         {
             this->assign(value); // assign via deepcopy
         }
@@ -712,14 +885,18 @@ public:
     Variant(void) 
         : m_storage(),
         m_name_ptr(0),
-        m_type_ifnull(DAL_TYPE_UNKNOWN)
+        m_type_ifnull(DAL_TYPE_UNKNOWN),
+        m_inline(),
+        m_inline_type(DAL_TYPE_UNKNOWN)
         {}
     
     ///
     Variant(IVariantValue *value) 
         : m_storage(value),
         m_name_ptr(0),
-        m_type_ifnull(DAL_TYPE_UNKNOWN)
+        m_type_ifnull(DAL_TYPE_UNKNOWN),
+        m_inline(),
+        m_inline_type(DAL_TYPE_UNKNOWN)
         {}
 
 
@@ -729,7 +906,9 @@ public:
     : m_storage(),
      // m_name(String::fromUTF8(utf8name)),
      m_name_ptr(0),
-      m_type_ifnull(type)
+      m_type_ifnull(type),
+      m_inline(),
+      m_inline_type(DAL_TYPE_UNKNOWN)
     {}
 
     ///
@@ -749,6 +928,14 @@ public:
     ///
     template<typename T> inline bool can_convert(void) const
     {
+        if(this->is_inline())
+        {
+            if(inline_conversion<T>::table[this->m_inline_type])
+                return true;
+            else
+                return Converter<T>::can_convert(*this);
+        }
+
         if(const supports<T> *a = dynamic_cast<const supports<T>*>(this->get_storage()))
         {
             return true;
@@ -759,8 +946,25 @@ public:
 
 
     ///
-    template<typename T> inline T get(std::locale loc = std::locale()) const
+    /// For inline values the locale is only constructed by conversions
+    /// which use it, e.g. to String.
+    template<typename T> inline T get(void) const
     {
+        if(this->is_inline())
+            return this->get_inline<T>(0);
+        return this->get<T>(std::locale());
+    }
+
+
+    ///
+    /// Inline values are converted through inline_conversion<T>. Heap
+    /// value stores and engine accessors are resolved by dynamic_cast<>
+    /// to supports<T>, their accessor type is not known from the daltype.
+    template<typename T> inline T get(const std::locale &loc) const
+    {
+        if(this->is_inline())
+            return this->get_inline<T>(&loc);
+
         if(const supports<T> *a = dynamic_cast<const supports<T>*>(this->get_storage()))
         {
             return a->cast((T*)0, loc);
@@ -782,7 +986,7 @@ public:
     template<typename T> inline void set(const T& value)
     {
 
-        if((!this->isnull()) && this->get_storage()->flags() & VARIANT_PTR)
+        if((!this->isnull()) && !this->is_inline() && this->get_storage()->flags() & VARIANT_PTR)
         {
             if(variant_writter *vw = dynamic_cast<variant_writter*>(this->get_storage()))
             {
@@ -795,7 +999,7 @@ public:
         }
         else
         {
-            this->m_storage.reset(new typename value_traits<T>::stored_type(value));
+            this->init_value(value, inline_storage<T>());
         }
     }
 
@@ -826,15 +1030,32 @@ public:
     inline String getName(void) const { return String::fromUTF8(this->m_name_ptr); }
 
 
+    /// Inline values have no value store. get_storage() moves them
+    /// into a heap allocated store before the pointer is returned.
+    /// The const version never modifies the Variant and must not be
+    /// called for inline values, use inline_accessor or clone() instead.
     IVariantValue*       get_storage(void);
     const IVariantValue* get_storage(void) const;
 
+    /// Returns true if the value is stored inside the Variant
+    inline bool is_inline(void) const { return this->m_inline_type != DAL_TYPE_UNKNOWN; }
+
+    /// Pointer to the inline buffer, only valid if is_inline() is true
+    inline const void* inline_ptr(void) const { return this->m_inline.raw; }
+
 
     signed int          asInt(void) const;
     unsigned int        asUInt(void) const;
     signed char         asChar(void) const;
     unsigned char       asUChar(void) const;
     String              asStr(std::locale loc = std::locale()) const;
+
+    /// Sets view to the text of the value without copying it.
+    /// Returns false if the value store cannot lend the text as UTF-8,
+    /// callers must fall back to asStr() then.
+    /// The view is valid until the resultset moves to the next row or
+    /// the Variant is modified.
+    bool                get_utf8_view(utf8_view &view) const;
     bool                asBool(void) const;
     signed short        asSmallint(void) const;
     unsigned short      asUSmallint(void) const;
@@ -852,9 +1073,49 @@ public:
 
 
 protected:
+    template<typename T> inline void init_value(const T& value, std::true_type)
+    {
+        this->m_storage.reset(0);
+        new (this->m_inline.raw) T(value);
+        this->m_inline_type = value_traits<T>::info_type::type();
+    }
+
+    template<typename T> inline void init_value(const T& value, std::false_type)
+    {
+        this->m_storage.reset(new typename value_traits<T>::stored_type(value));
+        this->m_inline_type = DAL_TYPE_UNKNOWN;
+    }
+
+    void assign_inline(const Variant& value);
+
+    /// Converts an inline value, loc may be null
+    template<typename T> inline T get_inline(const std::locale *loc) const
+    {
+        if(inline_storage<T>::value && this->m_inline_type == value_traits<T>::info_type::type())
+            return *reinterpret_cast<const T*>(this->m_inline.raw);
+
+        if(typename inline_conversion<T>::function_type fn = inline_conversion<T>::table[this->m_inline_type])
+            return fn(this->m_inline.raw, loc);
+        else
+            return Converter<T>::convert(*this);
+    }
+
+    IVariantValue* new_inline_storage(void) const;
+
+
     std::auto_ptr<IVariantValue> m_storage;
     const char*    m_name_ptr;
     daltype_t m_type_ifnull;
+
+    union
+    {
+        void*         align_ptr;
+        long long     align_ll;
+        double        align_d;
+        unsigned char raw[DBWTL_VARIANT_INLINE_SIZE];
+    } m_inline;
+
+    daltype_t m_inline_type;
 };
 
 
@@ -889,21 +1150,72 @@ bool Converter<T>::can_convert(const Variant &v)
 
 
 
-struct binary_operator
+//--------------------------------------------------------------------------
+/// @brief Typed expression kernels on Variant values
+///
+/// @details
+/// All kernels dispatch through binary_operator_for(), so a call does not
+/// allocate an operator object. Inline values (see Variant::is_inline())
+/// are computed without any heap allocation.
+///
+/// The scalar kernels throw NullException if an operand is NULL.
+/// The column kernels apply an operator to each row of a column and
+/// return NULL for rows with a NULL operand, like SQL expressions.
+/// The result column is resized to the size of the input column(s).
+///
+/// Integer division and modulo by zero return NULL, like in SQL.
+struct DBWTL_EXPORT VariantExprHelper
 {
-        virtual Variant add(const Variant &a, const Variant &b) = 0;
-};
+    typedef std::vector<Variant> column_type;
 
-
-std::shared_ptr<binary_operator> handle(daltype_t a, daltype_t b);
-
-
-
-
-struct VariantExprHelper
-{
     static Variant binaryAdd(const Variant &a, const Variant &b);
+    static Variant binarySub(const Variant &a, const Variant &b);
+    static Variant binaryMul(const Variant &a, const Variant &b);
+    static Variant binaryDiv(const Variant &a, const Variant &b);
+    static Variant binaryMod(const Variant &a, const Variant &b);
+    static Variant binaryConcat(const Variant &a, const Variant &b);
+
+    static Variant binaryLess(const Variant &a, const Variant &b);
+    static Variant binaryLessEqual(const Variant &a, const Variant &b);
+    static Variant binaryEqual(const Variant &a, const Variant &b);
+    static Variant binaryNotEqual(const Variant &a, const Variant &b);
+    static Variant binaryGreater(const Variant &a, const Variant &b);
+    static Variant binaryGreaterEqual(const Variant &a, const Variant &b);
+
+    /// Returns a value < 0, 0 or > 0 if a is less, equal or greater than b
+    static int compare(const Variant &a, const Variant &b);
+
     static Variant unaryPositive(const Variant &a);
+    static Variant unaryNegative(const Variant &a);
+
+
+    /// Applies method to each pair a[i], b[i]. Both columns must have
+    /// the same size.
+    static void apply(const column_type &a, const column_type &b, column_type &result,
+                      BinaryOperatorVariant::memfun_type method);
+
+    /// Applies method to each pair a[i], b
+    static void apply(const column_type &a, const Variant &b, column_type &result,
+                      BinaryOperatorVariant::memfun_type method);
+
+    /// Three-way comparison of a[i] and b[i]. nulls[i] is set for rows
+    /// with a NULL operand, result[i] is 0 for these rows.
+    static void compare(const column_type &a, const column_type &b, std::vector<int> &result,
+                        std::vector<bool> &nulls);
+
+    static void binaryAdd(const column_type &a, const column_type &b, column_type &result);
+    static void binarySub(const column_type &a, const column_type &b, column_type &result);
+    static void binaryMul(const column_type &a, const column_type &b, column_type &result);
+    static void binaryDiv(const column_type &a, const column_type &b, column_type &result);
+    static void binaryMod(const column_type &a, const column_type &b, column_type &result);
+    static void binaryConcat(const column_type &a, const column_type &b, column_type &result);
+
+    static void binaryAdd(const column_type &a, const Variant &b, column_type &result);
+    static void binarySub(const column_type &a, const Variant &b, column_type &result);
+    static void binaryMul(const column_type &a, const Variant &b, column_type &result);
+    static void binaryDiv(const column_type &a, const Variant &b, column_type &result);
+    static void binaryMod(const column_type &a, const Variant &b, column_type &result);
+    static void binaryConcat(const column_type &a, const Variant &b, column_type &result);
 };
 
 
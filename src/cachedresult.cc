@@ -45,6 +45,7 @@
 #include "dbwtl/db_objects.hh"
 #include "dbwtl/exceptions.hh"
 #include "dal/dal_debug.hh"
+#include "recordcodec.hh"
 #include "utils.hh"
 
 #include <ctime>
@@ -53,6 +54,13 @@
 #include <sstream>
 #include <typeinfo>
 #include <locale>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
 
 #define IS_UNIMPL() assert(!"unimpl"); throw 1
 
@@ -62,15 +70,68 @@ DB_NAMESPACE_BEGIN
 #define ROWSET_SIZE 100
 
 
+//..............................................................................
+//////////////////////////////////////////////////////////////// cached_prefetch
+///
+/// @since 0.0.1
+/// @brief State shared between CachedResultBase and its prefetch worker
+///
+/// The worker only reads from the source and appends to the queue, the
+/// RecordSet cache is only modified by the thread using the CachedResultBase.
+struct cached_prefetch
+{
+    cached_prefetch(size_t rows, size_t bytes)
+        : thread(), mutex(), space(), data(), queue(),
+          queued_bytes(0), max_rows(rows), max_bytes(bytes),
+          stop(false), done(false), error()
+    {}
+
+    /// @brief Returns true if the worker may add another record
+    inline bool hasSpace(void) const
+    {
+        return this->queue.empty() ||
+            (this->queue.size() < this->max_rows &&
+             (this->max_bytes == 0 || this->queued_bytes < this->max_bytes));
+    }
+
+    typedef std::pair<ShrRecord, size_t> entry_type;
+
+    std::thread                 thread;
+    std::mutex                  mutex;
+    std::condition_variable     space;
+    std::condition_variable     data;
+    std::deque<entry_type>      queue;
+    size_t                      queued_bytes;
+    const size_t                max_rows;
+    const size_t                max_bytes;
+    bool                        stop;
+    bool                        done;
+    std::exception_ptr          error;
+};
+
+
+
 CachedResultBase::CachedResultBase(void)
     : m_source(0),
       m_rscache(),
-      m_current_row(0)
+      m_current_row(0),
+      m_rowset_size(ROWSET_SIZE),
+      m_prefetch_rows(0),
+      m_prefetch_bytes(0),
+      m_prefetch(0),
+      m_prefetch_error()
 {
 }
 
 CachedResultBase::~CachedResultBase(void)
 {
+    try
+    {
+        this->stopPrefetch();
+    }
+    catch(...)
+    {
+    }
 }
 
 bool
@@ -84,6 +145,7 @@ void
 CachedResultBase::attach(IStmt &statement) 
 {
     this->m_source = &statement.resultset();
+    this->m_prefetch_error = std::exception_ptr();
 
 
 }
@@ -112,6 +174,9 @@ CachedResultBase::open(void)
         assert(this->m_source->isPositioned());
 
         this->copyMetadata();
+
+        if(this->m_prefetch_rows > 0)
+            this->startPrefetch();
     }
 }
 
@@ -155,29 +220,243 @@ CachedResultBase::close(void)
 }
 
 
+/// @details
+/// Each value of the current source row is copied exactly once, the
+/// record buffer is handed over to the cache without another clone.
+ShrRecord
+CachedResultBase::readRecord(void)
+{
+    const colnum_t ncol = this->m_source->columnCount();
+    ShrRecord rec(ncol);
+    for(colnum_t i = 1; i <= ncol; ++i)
+    {
+        const Variant &v = this->m_source->column(i);
+        if(!v.isnull())
+            rec[i-1].assign(v);
+    }
+    return rec;
+}
+
+
 void
 CachedResultBase::copyRecord(void)
 {
-    ShrRecord rec(this->m_source->columnCount());
-    for(colnum_t i = 1; i <= this->m_source->columnCount(); ++i)
+    this->m_rscache.emplace(this->readRecord());
+}
+
+
+/// @details
+/// Without prefetching the record is read from the source. Otherwise
+/// the next record is taken from the queue, waiting for the worker if
+/// the queue is empty. Errors raised by the worker are rethrown here,
+/// even if the worker was stopped before the error was consumed.
+bool
+CachedResultBase::pullRecord(void)
+{
+    if(! this->m_prefetch)
     {
-        if(this->m_source->column(i).isnull())
+        if(this->m_prefetch_error)
         {
-            rec[i-1] = Variant();
-            continue;
+            std::exception_ptr error = this->m_prefetch_error;
+            this->m_prefetch_error = std::exception_ptr();
+            std::rethrow_exception(error);
         }
+        if(!this->sourceAvail() || this->m_source->eof())
+            return false;
+        this->copyRecord();
+        this->m_source->next();
+        return true;
+    }
+
+    cached_prefetch &pf = *this->m_prefetch;
+    std::unique_lock<std::mutex> lock(pf.mutex);
+    pf.data.wait(lock, [&pf]() { return !pf.queue.empty() || pf.done; });
+
+    if(pf.queue.empty())
+    {
+        if(pf.error)
+        {
+            std::exception_ptr error = pf.error;
+            pf.error = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+        return false;
+    }
+
+    ShrRecord rec = pf.queue.front().first;
+    pf.queued_bytes -= pf.queue.front().second;
+    pf.queue.pop_front();
+    lock.unlock();
+    pf.space.notify_one();
+
+    this->m_rscache.emplace(std::move(rec));
+    return true;
+}
+
+
+void
+CachedResultBase::setRowsetSize(rowcount_t rows)
+{
+    if(rows == 0)
+        throw EngineException("setRowsetSize() failed: rowset size must be greater than 0");
+    this->m_rowset_size = rows;
+}
+
+
+void
+CachedResultBase::setPrefetch(rowcount_t rows, size_t max_bytes)
+{
+    this->stopPrefetch();
+    this->m_prefetch_rows = rows;
+    this->m_prefetch_bytes = max_bytes;
+
+    if(rows > 0 && this->isOpen() && this->sourceAvail())
+        this->startPrefetch();
+}
+
+
+bool
+CachedResultBase::isPrefetching(void) const
+{
+    return this->m_prefetch != 0;
+}
+
+
+void
+CachedResultBase::createIndex(const String &name, RecordIndexType type,
+                              const std::vector<colnum_t> &columns)
+{
+    if(!this->isOpen())
+        throw EngineException("createIndex() failed: resultset is not open");
+    this->m_rscache.createIndex(name, type, columns);
+}
+
+
+void
+CachedResultBase::dropIndex(const String &name)
+{
+    this->m_rscache.dropIndex(name);
+}
+
+
+/// @details
+/// Rows not fetched so far may contain the key, so the source is
+/// read to the end first.
+RecordIndex::rowlist_type
+CachedResultBase::lookup(const String &index, const RecordIndex::key_type &key)
+{
+    if(this->sourceAvail())
+        this->fetchAll();
+    return this->m_rscache.lookup(index, key);
+}
+
+
+RecordIndex::rowlist_type
+CachedResultBase::lookupRange(const String &index, const RecordIndex::key_type &lower,
+                              const RecordIndex::key_type &upper)
+{
+    if(this->sourceAvail())
+        this->fetchAll();
+    return this->m_rscache.lookupRange(index, lower, upper);
+}
+
+
+bool
+CachedResultBase::seek(const String &index, const RecordIndex::key_type &key)
+{
+    RecordIndex::rowlist_type rows = this->lookup(index, key);
+    return ! rows.empty() && this->setpos(rows.front());
+}
+
+
+bool
+CachedResultBase::seek(const String &index, const Variant &key)
+{
+    return this->seek(index, RecordIndex::key_type(1, key));
+}
+
+
+/// @details
+/// The worker copies records until the source reaches EOF, an error
+/// occurs or stopPrefetch() is called. It waits while the queue is full.
+void
+CachedResultBase::startPrefetch(void)
+{
+    assert(!this->m_prefetch);
+    assert(this->sourceAvail());
 
+    assert(this->m_prefetch_rows > 0);
+
+    cached_prefetch *pf = new cached_prefetch(size_t(this->m_prefetch_rows), this->m_prefetch_bytes);
+    this->m_prefetch = pf;
+
+    pf->thread = std::thread([this, pf]()
+    {
         try
         {
-            rec[i-1] = this->m_source->column(i);
+            std::unique_lock<std::mutex> lock(pf->mutex);
+            while(true)
+            {
+                pf->space.wait(lock, [pf]() { return pf->stop || pf->hasSpace(); });
+                if(pf->stop)
+                    break;
+                lock.unlock();
+
+                if(this->m_source->eof())
+                {
+                    lock.lock();
+                    break;
+                }
+                ShrRecord rec = this->readRecord();
+                size_t size = record_memory_size(rec);
+                this->m_source->next();
+
+                lock.lock();
+                pf->queue.push_back(cached_prefetch::entry_type(rec, size));
+                pf->queued_bytes += size;
+                pf->data.notify_one();
+            }
+            pf->done = true;
         }
         catch(...)
         {
-            std::cout << "catch error X in copyRecord()" << std::endl;
-            throw;
+            std::lock_guard<std::mutex> guard(pf->mutex);
+            pf->error = std::current_exception();
+            pf->done = true;
         }
+        pf->data.notify_all();
+    });
+}
+
+
+/// @details
+/// Records already queued by the worker are moved into the cache,
+/// the source is positioned behind the last queued record. An error
+/// raised by the worker is kept and rethrown by the next fetch.
+void
+CachedResultBase::stopPrefetch(void)
+{
+    if(! this->m_prefetch)
+        return;
+
+    std::unique_ptr<cached_prefetch> pf(this->m_prefetch);
+    this->m_prefetch = 0;
+    {
+        std::lock_guard<std::mutex> guard(pf->mutex);
+        pf->stop = true;
+    }
+    pf->space.notify_all();
+    pf->thread.join();
+
+    if(pf->error)
+        this->m_prefetch_error = pf->error;
+
+    while(!pf->queue.empty())
+    {
+        if(this->m_rscache.isOpen())
+            this->m_rscache.emplace(std::move(pf->queue.front().first));
+        pf->queue.pop_front();
     }
-    this->m_rscache.insert(rec);
 }
 
 
@@ -185,14 +464,8 @@ CachedResultBase::copyRecord(void)
 bool
 CachedResultBase::last(void)
 {
-	if(this->sourceAvail())
-	{
-		while(!this->m_source->eof())
-		{
-			copyRecord();
-			this->m_source->next();
-		}
-	}
+	while(this->pullRecord())
+		;
 
 	if(this->m_rscache.rowCount() > 0)
 	{
@@ -206,14 +479,8 @@ CachedResultBase::last(void)
 bool
 CachedResultBase::setpos(rownum_t row)
 {
-	if(this->sourceAvail())
-	{
-        while(row > this->m_rscache.rowCount() && !this->m_source->eof())
-        {
-            copyRecord();
-            this->m_source->next();
-        }
-	}
+    while(row > this->m_rscache.rowCount() && this->pullRecord())
+        ;
 
 	if(row > this->m_rscache.rowCount())
 		return false;
@@ -297,6 +564,8 @@ CachedResultBase::describeColumn(String name) const
 void
 CachedResultBase::resetInternal(void)
 {
+	this->stopPrefetch();
+	this->m_prefetch_error = std::exception_ptr();
 	this->m_source = 0;
 	this->m_rscache.reset();
 }
@@ -306,18 +575,25 @@ rowcount_t
 CachedResultBase::fetchMore(void)
 {
 	rowcount_t c = 0;
-	while(c < ROWSET_SIZE && this->sourceAvail() && !this->m_source->eof())
-	{
-		copyRecord();
+	while(c < this->m_rowset_size && this->pullRecord())
 		++c;
-		this->m_source->next();
-	}
 	return c;
 }
 
+/// @details
+/// A pending worker error counts as more data, so the caller fetches
+/// again and gets the error rethrown.
 bool
 CachedResultBase::moreAvail(void)
 {
+	if(this->m_prefetch_error)
+		return true;
+	if(this->m_prefetch)
+	{
+		std::lock_guard<std::mutex> guard(this->m_prefetch->mutex);
+		return !this->m_prefetch->queue.empty() || !this->m_prefetch->done
+			|| this->m_prefetch->error;
+	}
 	return (this->sourceAvail() && !this->m_source->eof());
 }
 
@@ -327,11 +603,8 @@ CachedResultBase::fetchAll(void)
 {
 	if(!this->sourceAvail())
 		throw EngineException("fetchAll() failed: source is not available");
-	while(!this->m_source->eof())
-	{
-		this->copyRecord();
-		this->m_source->next();
-	}
+	while(this->pullRecord())
+		;
 
 }
 
@@ -339,6 +612,7 @@ CachedResultBase::fetchAll(void)
 void
 CachedResultBase::detach(void)
 {
+	this->stopPrefetch();
 	this->m_source = 0;
 }
 
@@ -0,0 +1,448 @@
+//
+// columnstore.cc - ColumnStore (definition)
+//
+// Copyright (C)         informave.org
+//   2013,               Daniel Vogelbacher <daniel@vogelbacher.name>
+//
+// BSD License
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the
+// distribution.
+//
+// Neither the name of the copyright holders nor the names of its
+// contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+/// @file
+/// @brief ColumnStore (definitions)
+/// @author Daniel Vogelbacher
+/// @since 0.0.1
+
+
+#include "dbwtl/dal/dal_fwd.hh"
+#include "dbwtl/db_objects.hh"
+#include "dbwtl/exceptions.hh"
+#include "dal/dal_debug.hh"
+#include "utils.hh"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+DB_NAMESPACE_BEGIN
+
+
+//..............................................................................
+////////////////////////////////////////////////////////////////// column_vector
+///
+/// @since 0.0.1
+/// @brief Base class for the column arrays of a ColumnStore
+struct column_vector
+{
+    column_vector(daltype_t t) : type(t), nulls()
+    {}
+
+    virtual ~column_vector(void)
+    {}
+
+    virtual column_vector* clone(void) const = 0;
+
+    /// Appends a non-null value, returns false if the value
+    /// does not fit into the array type
+    virtual bool push(const Variant &value) = 0;
+
+    virtual void push_null(void) = 0;
+
+    /// Copies a non-null value into dest
+    virtual void load(size_t row, Variant &dest) const = 0;
+
+    virtual size_t memory(void) const = 0;
+
+    /// Returns true for columns which have seen only NULL values
+    virtual bool placeholder(void) const { return false; }
+
+    daltype_t          type;
+    std::vector<bool>  nulls;
+};
+
+
+/// Column without any non-null value so far
+struct null_column : public column_vector
+{
+    null_column(void) : column_vector(DAL_TYPE_UNKNOWN)
+    {}
+
+    virtual column_vector* clone(void) const { return new null_column(*this); }
+
+    virtual bool push(const Variant &value) { return false; }
+
+    virtual void push_null(void) { this->nulls.push_back(true); }
+
+    virtual void load(size_t row, Variant &dest) const { dest.setNull(); }
+
+    virtual size_t memory(void) const { return this->nulls.capacity() / 8; }
+
+    virtual bool placeholder(void) const { return true; }
+};
+
+
+/// Contiguous array of a scalar type
+template<typename T>
+struct typed_column : public column_vector
+{
+    typed_column(daltype_t t) : column_vector(t), values()
+    {}
+
+    virtual column_vector* clone(void) const { return new typed_column<T>(*this); }
+
+    virtual bool push(const Variant &value)
+    {
+        if(value.datatype() != this->type)
+            return false;
+        this->values.push_back(value.get<T>());
+        this->nulls.push_back(false);
+        return true;
+    }
+
+    virtual void push_null(void)
+    {
+        this->values.push_back(T());
+        this->nulls.push_back(true);
+    }
+
+    virtual void load(size_t row, Variant &dest) const
+    {
+        dest.set<T>(this->values[row]);
+    }
+
+    virtual size_t memory(void) const
+    {
+        return this->values.capacity() * sizeof(T) + this->nulls.capacity() / 8;
+    }
+
+    std::vector<T> values;
+};
+
+
+/// Strings as UTF-8 in a single arena, offsets[row] to offsets[row+1]
+/// is the text of a row.
+struct string_column : public column_vector
+{
+    string_column(void) : column_vector(DAL_TYPE_STRING), arena(), offsets(1, 0)
+    {}
+
+    virtual column_vector* clone(void) const { return new string_column(*this); }
+
+    virtual bool push(const Variant &value)
+    {
+        if(value.datatype() != DAL_TYPE_STRING)
+            return false;
+        utf8_view view;
+        if(value.get_utf8_view(view))
+            this->arena.append(view.data(), view.size());
+        else
+        {
+            size_t len = 0;
+            String s = value.get<String>();
+            const char *p = s.utf8(len);
+            this->arena.append(p, len);
+        }
+        this->offsets.push_back(this->arena.size());
+        this->nulls.push_back(false);
+        return true;
+    }
+
+    virtual void push_null(void)
+    {
+        this->offsets.push_back(this->arena.size());
+        this->nulls.push_back(true);
+    }
+
+    virtual void load(size_t row, Variant &dest) const
+    {
+        String s;
+        s.loadUTF8(this->arena.data() + this->offsets[row],
+                   this->offsets[row+1] - this->offsets[row]);
+        dest.set<String>(s);
+    }
+
+    virtual size_t memory(void) const
+    {
+        return this->arena.capacity() + this->offsets.capacity() * sizeof(size_t)
+            + this->nulls.capacity() / 8;
+    }
+
+    std::string         arena;
+    std::vector<size_t> offsets;
+};
+
+
+/// Fallback for all other types and columns with mixed types
+struct variant_column : public column_vector
+{
+    variant_column(void) : column_vector(DAL_TYPE_UNKNOWN), values()
+    {}
+
+    virtual column_vector* clone(void) const { return new variant_column(*this); }
+
+    virtual bool push(const Variant &value)
+    {
+        this->values.push_back(value);
+        this->nulls.push_back(false);
+        return true;
+    }
+
+    virtual void push_null(void)
+    {
+        this->values.push_back(Variant());
+        this->nulls.push_back(true);
+    }
+
+    virtual void load(size_t row, Variant &dest) const
+    {
+        dest = this->values[row];
+    }
+
+    virtual size_t memory(void) const
+    {
+        return this->values.capacity() * sizeof(Variant) + this->nulls.capacity() / 8;
+    }
+
+    std::vector<Variant> values;
+};
+
+
+/// Creates the column array for values of the given type
+static column_vector* make_column(daltype_t type)
+{
+    switch(type)
+    {
+    case DAL_TYPE_INT:        return new typed_column<signed int>(type);
+    case DAL_TYPE_UINT:       return new typed_column<unsigned int>(type);
+    case DAL_TYPE_CHAR:       return new typed_column<signed char>(type);
+    case DAL_TYPE_UCHAR:      return new typed_column<unsigned char>(type);
+    case DAL_TYPE_BOOL:       return new typed_column<bool>(type);
+    case DAL_TYPE_SMALLINT:   return new typed_column<signed short>(type);
+    case DAL_TYPE_USMALLINT:  return new typed_column<unsigned short>(type);
+    case DAL_TYPE_BIGINT:     return new typed_column<signed long long>(type);
+    case DAL_TYPE_UBIGINT:    return new typed_column<unsigned long long>(type);
+    case DAL_TYPE_FLOAT:      return new typed_column<float>(type);
+    case DAL_TYPE_DOUBLE:     return new typed_column<double>(type);
+    case DAL_TYPE_DATE:       return new typed_column<TDate>(type);
+    case DAL_TYPE_TIME:       return new typed_column<TTime>(type);
+    case DAL_TYPE_TIMESTAMP:  return new typed_column<TTimestamp>(type);
+    case DAL_TYPE_STRING:     return new string_column();
+    default:                  return new variant_column();
+    }
+}
+
+
+/// Moves the values of col into a new column array of the given kind
+static column_vector* convert_column(const column_vector &col, column_vector *target, size_t rows)
+{
+    Variant tmp;
+    for(size_t row = 0; row < rows; ++row)
+    {
+        if(col.nulls[row])
+            target->push_null();
+        else
+        {
+            col.load(row, tmp);
+            target->push(tmp);
+        }
+    }
+    return target;
+}
+
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////////// ColumnStore
+
+/// @details
+/// 
+ColumnStore::ColumnStore(void)
+    : m_columns(),
+      m_rows(0)
+{}
+
+
+/// @details
+/// 
+ColumnStore::ColumnStore(const ColumnStore &orig)
+    : m_columns(),
+      m_rows(orig.m_rows)
+{
+    for(size_t i = 0; i < orig.m_columns.size(); ++i)
+        this->m_columns.push_back(orig.m_columns[i]->clone());
+}
+
+
+/// @details
+/// 
+ColumnStore&
+ColumnStore::operator=(const ColumnStore &orig)
+{
+    if(this != &orig)
+    {
+        ColumnStore tmp(orig);
+        std::swap(this->m_columns, tmp.m_columns);
+        std::swap(this->m_rows, tmp.m_rows);
+    }
+    return *this;
+}
+
+
+/// @details
+/// 
+ColumnStore::~ColumnStore(void)
+{
+    this->clear();
+}
+
+
+/// @details
+/// The first row defines the number of columns. Columns which have seen
+/// only NULL values get their array type from the first non-null value.
+/// If a value does not fit into the array type of its column, the column
+/// is converted to a Variant array.
+void
+ColumnStore::append(const ShrRecord &rec)
+{
+    if(this->m_columns.empty() && this->m_rows == 0)
+    {
+        for(size_t i = 0; i < rec.size(); ++i)
+            this->m_columns.push_back(new null_column());
+    }
+
+    if(rec.size() != this->m_columns.size())
+        throw EngineException(FORMAT2("append() failed, field count mismatch: %d vs. %d",
+                                      this->m_columns.size(), rec.size()));
+
+    for(size_t i = 0; i < rec.size(); ++i)
+    {
+        const Variant &value = rec[i];
+        column_vector *&col = this->m_columns[i];
+
+        if(value.isnull())
+        {
+            col->push_null();
+            continue;
+        }
+
+        if(col->placeholder())
+        {
+            column_vector *typed = make_column(value.datatype());
+            for(size_t row = 0; row < this->m_rows; ++row)
+                typed->push_null();
+            delete col;
+            col = typed;
+        }
+
+        if(! col->push(value))
+        {
+            column_vector *generic = convert_column(*col, new variant_column(), this->m_rows);
+            delete col;
+            col = generic;
+            col->push(value);
+        }
+    }
+    ++this->m_rows;
+}
+
+
+/// @details
+/// 
+void
+ColumnStore::load(size_t row, size_t col, Variant &dest) const
+{
+    DBWTL_BUGCHECK_EX(row < this->m_rows && col < this->m_columns.size(),
+                      "ColumnStore::load(): row or column out of range");
+
+    const column_vector *c = this->m_columns[col];
+    if(c->nulls[row])
+        dest.setNull();
+    else
+        c->load(row, dest);
+}
+
+
+/// @details
+/// 
+bool
+ColumnStore::isnull(size_t row, size_t col) const
+{
+    DBWTL_BUGCHECK_EX(row < this->m_rows && col < this->m_columns.size(),
+                      "ColumnStore::isnull(): row or column out of range");
+    return this->m_columns[col]->nulls[row];
+}
+
+
+/// @details
+/// 
+daltype_t
+ColumnStore::columnType(size_t col) const
+{
+    return this->m_columns.at(col)->type;
+}
+
+
+/// @details
+/// 
+void
+ColumnStore::clear(void)
+{
+    for(size_t i = 0; i < this->m_columns.size(); ++i)
+        delete this->m_columns[i];
+    this->m_columns.clear();
+    this->m_rows = 0;
+}
+
+
+/// @details
+/// 
+size_t
+ColumnStore::memoryUsage(void) const
+{
+    size_t bytes = 0;
+    for(size_t i = 0; i < this->m_columns.size(); ++i)
+        bytes += this->m_columns[i]->memory();
+    return bytes;
+}
+
+
+
+DB_NAMESPACE_END
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
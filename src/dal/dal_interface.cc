@@ -101,6 +101,54 @@ IDataset::columnByName(const String &name)
 
 
 
+//--------------------------------------------------------------------------
+///
+///
+ColumnIndex::ColumnIndex(void)
+    : m_exact(),
+      m_valid(false)
+{}
+
+
+///
+/// If a name occurs more than once, the first column wins like
+/// in the linear scan used before.
+void
+ColumnIndex::build(const IDataset &ds)
+{
+    this->clear();
+    const size_t count = ds.columnCount();
+    this->m_exact.reserve(count);
+    for(colnum_t i = 1; i <= count; ++i)
+    {
+        String name = ds.columnName(i);
+        this->m_exact.insert(map_type::value_type(name.utf8(), i));
+    }
+    this->m_valid = true;
+}
+
+
+///
+///
+void
+ColumnIndex::clear(void)
+{
+    this->m_exact.clear();
+    this->m_valid = false;
+}
+
+
+///
+///
+colnum_t
+ColumnIndex::find(const String &name) const
+{
+    map_type::const_iterator i = this->m_exact.find(name.utf8());
+    return i != this->m_exact.end() ? i->second : 0;
+}
+
+
+
 String
 CodePosInfo::str(void) const
 {
@@ -517,6 +517,12 @@ sv_accessor<FirebirdData*>::cast(String*, std::locale loc) const
         return Variant(this->deepcopy()).get<String>();
 }
 
+bool
+sv_accessor<FirebirdData*>::get_utf8_view(utf8_view &view) const
+{
+    return this->get_value()->getUTF8View(view);
+}
+
 bool
 sv_accessor<FirebirdData*>::valueNullCheck() const
 {
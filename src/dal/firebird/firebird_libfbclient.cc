@@ -569,6 +569,35 @@ FirebirdData_libfbclient::getText(void) const
 }
 
 
+/// @details
+/// The view points into the sqldata buffer of the XSQLVAR, which is
+/// overwritten by the next fetch. SQL_TEXT values keep their padding,
+/// like getText().
+bool
+FirebirdData_libfbclient::getUTF8View(utf8_view &view) const
+{
+    DALTRACE("VISIT");
+    if(this->isnull())
+        throw NullException(String("FirebirdData_libfbclient result column"));
+
+    if(! String::isUTF8Charset(this->m_resultset.getDbc().getDbcEncoding()))
+        return false;
+
+    switch(this->m_sqlvar->sqltype & ~1)
+    {
+    case SQL_VARYING:
+        view = utf8_view(this->m_sqlvar->sqldata + 2,
+                         reinterpret_cast<short*>(this->m_sqlvar->sqldata)[0]);
+        return true;
+    case SQL_TEXT:
+        view = utf8_view(this->m_sqlvar->sqldata, this->m_sqlvar->sqllen);
+        return true;
+    default:
+        return false;
+    }
+}
+
+
 /// @details
 /// 
 TDate
@@ -715,6 +744,7 @@ FirebirdResult_libfbclient::FirebirdResult_libfbclient(FirebirdStmt_libfbclient&
       m_last_row_status(100), // 100 signals EOF in isc API
       m_isopen(false),
       m_column_desc(),
+      m_column_index(),
       m_param_desc(),
       m_column_accessors(),
       m_allocated_accessors()
@@ -1643,11 +1673,11 @@ FirebirdResult_libfbclient::columnID(String name) const
     if(! this->isOpen())
         throw EngineException("Resultset is not open.");
 
-    for(colnum_t i = 1; i <= this->columnCount(); ++i)
-    {
-        if(name == this->columnName(i))
-            return i;
-    }
+    if(! this->m_column_index.isValid())
+        this->m_column_index.build(*this);
+
+    if(colnum_t num = this->m_column_index.find(name))
+        return num;
     throw NotFoundException(US("Column '") + String::Internal(name) + US("' not found."));
 }
 
@@ -1769,6 +1799,7 @@ FirebirdResult_libfbclient::refreshMetadata(void)
 {
     DALTRACE_ENTER;
     this->m_column_desc.clear();
+    this->m_column_index.clear();
     if(! this->getHandle())
         return;
     
@@ -2776,6 +2807,15 @@ void
 FirebirdDbc_libfbclient::setDbcEncoding(std::string encoding)
 {
 	this->m_dbc_encoding = encoding;
+    try
+    {
+        // open the converter now instead of on the first fetch
+        String::prepare_converter(encoding);
+    }
+    catch(ConversionError &)
+    {
+        // unknown charsets are reported by the first conversion
+    }
 }
 
 
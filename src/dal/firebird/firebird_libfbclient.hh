@@ -163,6 +163,8 @@ public:
     virtual bool         isnull(void) const;
     virtual rowid_t      getCurrentRowID(void) const;
 
+    virtual bool getUTF8View(utf8_view &view) const;
+
     virtual void refresh(void);
 
     virtual daltype_t daltype(void) const;
@@ -308,6 +310,10 @@ protected:
     /// @brief Stores the type information of all columns in the resultset
     std::map<colnum_t, FirebirdColumnDesc_libfbclient>     m_column_desc;
 
+    ///
+    /// @brief Maps column names to column numbers, invalidated by refreshMetadata()
+    mutable ColumnIndex                                m_column_index;
+
     ///
     /// @brief Stores the type information of all params in the query
     std::map<int, FirebirdParamDesc_libfbclient>           m_param_desc;
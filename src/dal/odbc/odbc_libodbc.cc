@@ -918,6 +918,29 @@ String OdbcData_libodbc::getString(void) const
     }
 }
 
+
+/// @details
+/// Only ANSI buffers with an UTF-8 connection charset are lent,
+/// the view points into the bound buffer of the column.
+bool
+OdbcData_libodbc::getUTF8View(utf8_view &view) const
+{
+    DALTRACE("VISIT");
+    assert(this->m_colnum > 0);
+    if(this->isnull())
+        throw NullException(String("OdbcData_libodbc result column"));
+
+    DBWTL_BUGCHECK(this->m_value.ind >= 0);
+    if(! m_value.strbufA.size()
+       || this->m_value.ind > m_value.strbufA.size()
+       || ! String::isUTF8Charset(this->m_resultset.getDbc().getDbcEncoding()))
+        return false;
+
+    view = utf8_view(reinterpret_cast<const char*>(m_value.strbufA.ptr()),
+                     this->m_value.ind / sizeof(SQLCHAR));
+    return true;
+}
+
 signed short int OdbcData_libodbc::getSShort(void) const
 {
     DALTRACE("VISIT");
@@ -1128,15 +1151,15 @@ TNumeric OdbcData_libodbc::getNumeric(void) const
         const SQL_NUMERIC_STRUCT &num = this->m_value.data.numeric;
 
         TNumeric res(0);
-        TNumeric denom(1);
 
-        for(size_t i = 0; i < SQL_MAX_NUMERIC_LEN; ++i)
+        // val[] is little endian, start with the most significant byte
+        // so res never exceeds the final coefficient.
+        for(size_t i = SQL_MAX_NUMERIC_LEN; i > 0; --i)
         {
-            res = res + num.val[i] * denom;
-            denom = denom * 256;
+            res = res * 256 + num.val[i - 1];
         }
 
-        res.rescale(num.scale);
+        res = res * TNumeric(1, num.scale);
         // NOTE: The ODBC 3.0 spec required drivers to return the sign as
         // 1 for positive numbers and 2 for negative number. This was changed in the
         // ODBC 3.5 spec to return 0 for negative instead of 2.
@@ -1952,6 +1975,7 @@ OdbcResult_libodbc::OdbcResult_libodbc(OdbcStmt_libodbc& stmt)
       m_cached_resultcol_count(-1),
       m_param_data(),
       m_column_desc(),
+      m_column_index(),
       m_column_accessors(),
       m_allocated_accessors()
 { }
@@ -3445,11 +3469,11 @@ OdbcResult_libodbc::columnID(String name) const
     if(! this->isOpen())
         throw EngineException("Resultset is not open.");
 
-    for(colnum_t i = 1; i <= this->columnCount(); ++i)
-    {
-        if(name == this->columnName(i))
-            return i;
-    }
+    if(! this->m_column_index.isValid())
+        this->m_column_index.build(*this);
+
+    if(colnum_t num = this->m_column_index.find(name))
+        return num;
     throw NotFoundException(US("Column '") + String::Internal(name) + US("' not found."));
 }
 
@@ -3697,6 +3721,7 @@ OdbcResult_libodbc::refreshMetadata(void)
 {
     DBWTL_TRACE0();
     this->m_column_desc.clear();
+    this->m_column_index.clear();
 
     this->m_column_accessors.clear();
     this->m_allocated_accessors.clear();
@@ -3941,7 +3966,7 @@ OdbcDbc_libodbc::connect(IDbc::Options& options)
                               " with a valid character set"
                               " like \"utf-8\" or \"iso-8859-1\".");
     }
-    this->m_ansics = options["charset"];
+    this->setDbcEncoding(options["charset"]);
 
     if(options["unicode"].empty())
     {
@@ -4724,6 +4749,15 @@ void
 OdbcDbc_libodbc::setDbcEncoding(std::string encoding)
 {
     this->m_ansics = encoding;
+    try
+    {
+        // open the converter now instead of on the first fetch
+        String::prepare_converter(encoding);
+    }
+    catch(ConversionError &)
+    {
+        // unknown charsets are reported by the first conversion
+    }
 }
 
 
@@ -448,6 +448,7 @@ public:
     virtual UnicodeStreamBuf*       getMemoStream(void) const;
 
     virtual String getString(void) const;
+    virtual bool getUTF8View(utf8_view &view) const;
     virtual signed short int getSShort(void) const;
     virtual unsigned short int getUShort(void) const;
     virtual signed long int getSLong(void) const;
@@ -622,6 +623,10 @@ protected:
     /// @brief Stores the type information of all columns in the resultset
     std::map<colnum_t, OdbcColumnDesc_libodbc>     m_column_desc;
 
+    ///
+    /// @brief Maps column names to column numbers, invalidated by refreshMetadata()
+    mutable ColumnIndex                                m_column_index;
+
     ///
     /// @brief Stores all column accessors (IVariants) requested by an user for
     /// the current resultset.
@@ -558,6 +558,14 @@ sv_accessor<SDIData*>::cast(String*, std::locale loc) const
     }
 }
 
+bool
+sv_accessor<SDIData*>::get_utf8_view(utf8_view &view) const
+{
+    if(this->get_value()->daltype() != DAL_TYPE_STRING)
+        return false;
+    return this->get_value()->getUTF8View(view);
+}
+
 bool
 sv_accessor<SDIData*>::valueNullCheck() const
 {
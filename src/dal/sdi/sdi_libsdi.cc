@@ -330,7 +330,9 @@ SDIData_libsdi::SDIData_libsdi(SDIDataProvider_libsdi& result, colnum_t colnum,
       m_colnum(colnum),
       m_blobbuf(),
       m_memo_stream(),
-      m_buf(0)
+      m_buf(0),
+      m_text_buf(),
+      m_text_valid(false)
 { }
 
 
@@ -590,6 +592,41 @@ SDIData_libsdi::getString(void) const
 }
 
 
+/// @details
+/// SDI drivers copy the data out, so the text is read into a buffer
+/// owned by this column. The buffer keeps its capacity across rows,
+/// so scanning a column allocates only for the longest value.
+bool
+SDIData_libsdi::getUTF8View(utf8_view &view) const
+{
+    DALTRACE_VISIT;
+    assert(this->m_colnum > 0);
+
+    if(this->sdi_type() != SDI_TYPE_STRING)
+        return false;
+
+    if(this->isnull())
+        throw NullException(String("SDIData_libsdi result column"));
+
+    SDIENV envh = dynamic_cast<SDIEnv_libsdi&>(this->m_resultset.getDbc().getEnv()).getHandle();
+    if(! String::isUTF8Charset(m_resultset.drv()->SDICharset(envh)))
+        return false;
+
+    if(! this->m_text_valid)
+    {
+        int ind;
+        m_resultset.drv()->SDIGetData(m_resultset.getHandle(), colnum(), 0, 0, &ind);
+        assert(ind != SDI_NULL_VALUE);
+        this->m_text_buf.resize(ind+1);
+        m_resultset.drv()->SDIGetData(m_resultset.getHandle(), colnum(), &this->m_text_buf[0], ind+1, &ind);
+        this->m_text_buf.resize(ind);
+        this->m_text_valid = true;
+    }
+    view = utf8_view(this->m_text_buf.data(), this->m_text_buf.size());
+    return true;
+}
+
+
 TDate 
 SDIData_libsdi::getDate(void) const
 {
@@ -690,6 +727,7 @@ SDIData_libsdi::refresh(void)
     {
         this->m_resultset.drv()->SDIFree(&this->m_buf);
     }
+    this->m_text_valid = false;
 }
 
 
@@ -718,6 +756,7 @@ SDIDataProvider_libsdi::SDIDataProvider_libsdi(SDIStmt_libsdi& stmt)
       m_isopen(false),
       m_isbad(false),
       m_column_desc(),
+      m_column_index(),
       m_column_accessors(),
       m_allocated_accessors()
 { }
@@ -966,11 +1005,11 @@ SDIDataProvider_libsdi::columnID(String name) const
     if(! this->isOpen())
         throw EngineException("Resultset is not open.");
 
-    for(colnum_t i = 1; i <= this->columnCount(); ++i)
-    {
-        if(name == this->columnName(i))
-            return i;
-    }
+    if(! this->m_column_index.isValid())
+        this->m_column_index.build(*this);
+
+    if(colnum_t num = this->m_column_index.find(name))
+        return num;
     throw NotFoundException(US("Column '") + String::Internal(name) + US("' not found."));
 }
 
@@ -1081,6 +1120,7 @@ SDIDataProvider_libsdi::refreshMetadata(void)
 {
     DALTRACE_ENTER;
     this->m_column_desc.clear();
+    this->m_column_index.clear();
     if(! this->getHandle())
         return;
     
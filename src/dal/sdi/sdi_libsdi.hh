@@ -179,6 +179,7 @@ public:
     virtual TNumeric getNumeric(void) const;
     virtual bool getBool(void) const;
     virtual String getString(void) const;
+    virtual bool getUTF8View(utf8_view &view) const;
     virtual TDate getDate(void) const;
     virtual TTime getTime(void) const;
     virtual TTimestamp getTimestamp(void) const;
@@ -201,6 +202,9 @@ protected:
     //mutable std::wstring m_memobuf_data;
     mutable std::wstringstream m_memo_stream;
     mutable void *m_buf;
+    /// Text buffer for getUTF8View(), reused for each row
+    mutable std::string m_text_buf;
+    mutable bool m_text_valid;
 
 };
 
@@ -304,6 +308,10 @@ protected:
     /// @brief Stores the type information of all columns in the resultset
     std::map<colnum_t, SDIColumnDesc_libsdi>     m_column_desc;
 
+    ///
+    /// @brief Maps column names to column numbers, invalidated by refreshMetadata()
+    mutable ColumnIndex                                m_column_index;
+
     ///
     /// @brief Stores all column accessors (IVariants) requested by an user for
     /// the current resultset.
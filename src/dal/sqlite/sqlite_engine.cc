@@ -406,6 +406,12 @@ sv_accessor<SqliteData*>::cast(bool*, std::locale loc) const
     return this->get_value()->getInt() > 0;
 }
 
+double
+sv_accessor<SqliteData*>::cast(double*, std::locale loc) const
+{
+    return this->get_value()->getDouble();
+}
+
 
 BlobStream
 sv_accessor<SqliteData*>::cast(BlobStream*, std::locale loc) const
@@ -508,6 +514,12 @@ sv_accessor<SqliteData*>::cast(String*, std::locale loc) const
     return this->get_value()->getString();
 }
 
+bool
+sv_accessor<SqliteData*>::get_utf8_view(utf8_view &view) const
+{
+    return this->get_value()->getUTF8View(view);
+}
+
 bool
 sv_accessor<SqliteData*>::valueNullCheck() const
 {
@@ -54,6 +54,10 @@
 #include <algorithm>
 #include <cstdlib>
 #include <sstream>
+#include <chrono>
+#include <thread>
+#include <limits>
+#include <vector>
 
 
 
@@ -80,6 +84,11 @@
 
 
 
+/// Chunk size for streaming BLOB data
+#define DAL_SQLITE_BLOB_CHUNK_SIZE  65536
+
+
+
 DAL_NAMESPACE_BEGIN
 
 
@@ -101,6 +110,28 @@ static void delete_resultset(SqliteResult_libsqlite* rs)
 }
 
 
+/// Destructor for BLOB buffers handed over to SQLite
+static void free_blob(void *ptr)
+{
+    std::free(ptr);
+}
+
+
+/// Gives access to the get area of any stream buffer
+struct streambuf_access : public std::streambuf
+{
+    static const char* gptr_of(std::streambuf *buf)
+    {
+        return (buf->*&streambuf_access::gptr)();
+    }
+
+    static const char* egptr_of(std::streambuf *buf)
+    {
+        return (buf->*&streambuf_access::egptr)();
+    }
+};
+
+
 
 
 SqliteDiag&
@@ -172,7 +203,6 @@ SqliteBlob_libsqlite::underflow()
 SqliteBlob_libsqlite::pos_type
 SqliteBlob_libsqlite::seekpos(SqliteBlob_libsqlite::pos_type p, std::ios_base::openmode m)
 {
-    std::cout << "seek" << std::endl;
     if(m & std::ios_base::in)
     {
         this->m_cur = this->m_buf + p > this->m_buf_end ? this->m_buf_end : this->m_buf + p;
@@ -278,6 +308,159 @@ SqliteBlob_libsqlite::isNull(void) const
 
 
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+
+//
+//
+SqliteBlobReader_libsqlite::SqliteBlobReader_libsqlite(SqliteDbc_libsqlite &dbc, ::sqlite3_blob *blob)
+    : SqliteBlob(),
+      m_dbc(dbc),
+      m_blob(blob),
+      m_size(dbc.drv()->sqlite3_blob_bytes(blob)),
+      m_offset(0),
+      m_chunk(std::min(this->m_size, DAL_SQLITE_BLOB_CHUNK_SIZE))
+{
+    this->setg(0, 0, 0);
+}
+
+
+//
+//
+SqliteBlobReader_libsqlite::~SqliteBlobReader_libsqlite(void)
+{
+    this->m_dbc.drv()->sqlite3_blob_close(this->m_blob);
+}
+
+
+//
+//
+void
+SqliteBlobReader_libsqlite::read(char_type *dest, int n, int offset)
+{
+    int err = this->m_dbc.drv()->sqlite3_blob_read(this->m_blob, dest, n, offset);
+    if(err != SQLITE_OK)
+    {
+        const char *msg = this->m_dbc.drv()->sqlite3_errmsg(this->m_dbc.getHandle());
+        throw EngineException(String("Can not read BLOB: ") + String(msg, "UTF-8"));
+    }
+}
+
+
+/// @details
+/// Loads the chunk following the current buffer.
+SqliteBlobReader_libsqlite::int_type
+SqliteBlobReader_libsqlite::underflow()
+{
+    if(this->gptr() < this->egptr())
+        return traits_type::to_int_type(*this->gptr());
+
+    int pos = this->position();
+    if(pos >= this->m_size)
+        return traits_type::eof();
+
+    int n = std::min(this->m_size - pos, int(this->m_chunk.size()));
+    this->read(&this->m_chunk[0], n, pos);
+    this->m_offset = pos;
+    this->setg(&this->m_chunk[0], &this->m_chunk[0], &this->m_chunk[0] + n);
+    return traits_type::to_int_type(*this->gptr());
+}
+
+
+//
+//
+std::streamsize
+SqliteBlobReader_libsqlite::showmanyc(void)
+{
+    return this->m_size - this->position();
+}
+
+
+/// @details
+/// Requests larger than a chunk are read directly into the
+/// destination after the buffered bytes are used up.
+std::streamsize
+SqliteBlobReader_libsqlite::xsgetn(char_type *ch, std::streamsize n)
+{
+    std::streamsize done = std::min(n, std::streamsize(this->egptr() - this->gptr()));
+    if(done > 0)
+    {
+        std::memcpy(ch, this->gptr(), size_t(done));
+        this->gbump(int(done));
+    }
+
+    std::streamsize rest = std::min(n - done, std::streamsize(this->m_size - this->position()));
+    if(rest > 0 && rest >= std::streamsize(this->m_chunk.size()))
+    {
+        int pos = this->position();
+        this->read(ch + done, int(rest), pos);
+        this->m_offset = pos + int(rest);
+        this->setg(0, 0, 0);
+        return done + rest;
+    }
+
+    for(; done < n && this->underflow() != traits_type::eof(); )
+    {
+        std::streamsize cp = std::min(n - done, std::streamsize(this->egptr() - this->gptr()));
+        std::memcpy(ch + done, this->gptr(), size_t(cp));
+        this->gbump(int(cp));
+        done += cp;
+    }
+    return done;
+}
+
+
+//
+//
+SqliteBlobReader_libsqlite::pos_type
+SqliteBlobReader_libsqlite::seekpos(pos_type p, std::ios_base::openmode m)
+{
+    return this->seekoff(off_type(p), std::ios_base::beg, m);
+}
+
+
+/// @details
+/// Positions inside the current chunk keep the buffer, all other
+/// positions are loaded by the next underflow().
+SqliteBlobReader_libsqlite::pos_type
+SqliteBlobReader_libsqlite::seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode m)
+{
+    if(!(m & std::ios_base::in))
+        return pos_type(off_type(-1));
+
+    off_type target;
+    switch(way)
+    {
+    case std::ios_base::beg:
+        target = off;
+        break;
+    case std::ios_base::cur:
+        target = this->position() + off;
+        break;
+    case std::ios_base::end:
+        target = this->m_size + off;
+        break;
+    default:
+        return pos_type(off_type(-1));
+    }
+    if(target < 0 || target > this->m_size)
+        return pos_type(off_type(-1));
+
+    if(this->eback() && target >= this->m_offset && target <= this->m_offset + (this->egptr() - this->eback()))
+    {
+        this->setg(this->eback(), this->eback() + (target - this->m_offset), this->egptr());
+    }
+    else
+    {
+        this->m_offset = int(target);
+        this->setg(0, 0, 0);
+    }
+    return pos_type(target);
+}
+
+
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -455,8 +638,36 @@ String
 SqliteData_libsqlite::getString(void) const
 {
     const char* s = this->getText();
+    int len = this->m_resultset.drv()->sqlite3_column_bytes(this->m_resultset.getHandle(),
+                                                            this->m_colnum - 1);
+    // the UTF-8 data is stored as is, UTF-16 is only built on demand
+    String str;
+    str.loadUTF8(s, len);
+    return str;
+}
+
 
-    return String(s, "UTF-8");
+/// @details
+/// The view points to the buffer returned by sqlite3_column_text(),
+/// which is owned by the statement and valid until the next step.
+/// Only TEXT values are lent. sqlite3_column_text() converts INTEGER
+/// and FLOAT values to text in place, later numeric reads would then
+/// see the converted value.
+bool
+SqliteData_libsqlite::getUTF8View(utf8_view &view) const
+{
+    DALTRACE("VISIT");
+
+    assert(this->m_colnum > 0);
+    if(this->m_resultset.drv()->sqlite3_column_type(this->m_resultset.getHandle(),
+                                                    this->m_colnum - 1) != SQLITE_TEXT)
+        return false;
+
+    const char* s = this->getText();
+    int len = this->m_resultset.drv()->sqlite3_column_bytes(this->m_resultset.getHandle(),
+                                                            this->m_colnum - 1);
+    view = utf8_view(s, len);
+    return true;
 }
 
 
@@ -464,7 +675,7 @@ SqliteData_libsqlite::getString(void) const
 daltype_t
 SqliteData_libsqlite::daltype(void) const
 {
-    return this->m_resultset.describeColumn(this->m_colnum).getDatatype();
+    return this->m_resultset.columnType(this->m_colnum);
 }
 
 
@@ -478,10 +689,14 @@ SqliteResult_libsqlite::SqliteResult_libsqlite(SqliteStmt_libsqlite& stmt)
     : SqliteResult(stmt.m_diag),
       m_stmt(stmt),
       m_handle(NULL),
+      m_sql(),
+      m_stale(false),
       m_current_tuple(DAL_TYPE_ROWID_NPOS),
       m_last_row_status(0),
       m_isopen(false),
       m_column_desc(),
+      m_column_sig(),
+      m_column_index(),
       m_column_accessors(),
       m_allocated_accessors()
 { }
@@ -515,10 +730,28 @@ SqliteResult_libsqlite::prepare(String sql)
     if(this->isPrepared())
         this->close();
 
-    const char *sql_cstr = sql.utf8();
+    this->m_sql = sql.utf8();
+    this->m_stale = false;
+    this->m_column_desc.clear();
+    this->m_column_sig.clear();
+    this->m_column_index.clear();
 
-    int err = this->drv()->sqlite3_prepare_v2(this->m_stmt.getDbc().getHandle(),
-                                              sql_cstr, -1, &this->m_handle,  NULL);
+    // reuse an idle statement with the same SQL text
+    this->m_handle = this->getDbc().acquireStmt(this->m_sql);
+    if(this->m_handle)
+    {
+        this->m_cursorstate |= DAL_CURSOR_PREPARED;
+        DALTRACE_LEAVE;
+        return;
+    }
+
+    int err, attempt = 0;
+    while(((err = this->drv()->sqlite3_prepare_v2(this->m_stmt.getDbc().getHandle(),
+                                                  this->m_sql.c_str(), int(this->m_sql.size()),
+                                                  &this->m_handle,  NULL)) == SQLITE_BUSY
+           || err == SQLITE_LOCKED)
+          && this->getDbc().busyBackoff(attempt))
+        ;
     switch(err)
     {
     case SQLITE_OK:
@@ -545,7 +778,6 @@ void
 SqliteResult_libsqlite::execute(StmtBase::ParamMap& params)
 {
     DALTRACE_ENTER;
-    std::map<int, std::string> tmp_strings;
 
     if(this->isBad())
         throw EngineException("Resultset is in bad state.");
@@ -566,8 +798,6 @@ SqliteResult_libsqlite::execute(StmtBase::ParamMap& params)
     for(param = params.begin(); param != params.end(); ++param)
     {
         Variant *var = param->second;
-        std::stringstream tmp_stream;
-
 
         int err = SQLITE_OK;
 
@@ -600,15 +830,9 @@ SqliteResult_libsqlite::execute(StmtBase::ParamMap& params)
                 break;
 
             case DAL_TYPE_BLOB:
+            case DAL_TYPE_BLOBSTREAM:
 	    	DBWTL_BUGCHECK(var->get<BlobStream>().rdbuf());
-                {
-                    tmp_stream << var->get<BlobStream>().rdbuf();
-                    
-                    std::string& tmp_string = tmp_strings[param->first];
-                    tmp_string = tmp_stream.str();
-                    err = this->drv()->sqlite3_bind_blob(this->getHandle(), param->first, tmp_string.c_str(),
-                                                         tmp_string.size(), NULL);
-                }
+                err = this->bindBlob(param->first, var->get<BlobStream>().rdbuf());
                 break;
 
             default:
@@ -642,7 +866,7 @@ SqliteResult_libsqlite::execute(StmtBase::ParamMap& params)
         };
     }
 
-    this->m_last_row_status = this->drv()->sqlite3_step(this->m_handle);
+    this->m_last_row_status = this->stepRetry();
     switch(this->m_last_row_status)
     {
     case SQLITE_OK:
@@ -653,6 +877,9 @@ SqliteResult_libsqlite::execute(StmtBase::ParamMap& params)
         this->refreshMetadata();
         break;
 
+    case SQLITE_SCHEMA:
+        this->invalidateHandle();
+        // fall through
     default:
         DAL_SET_CURSORSTATE(this->m_cursorstate, DAL_CURSOR_BAD);
         const char *msg = this->drv()->sqlite3_errmsg(this->m_stmt.getDbc().getHandle());
@@ -729,6 +956,9 @@ SqliteResult_libsqlite::next(void)
         break;
     case SQLITE_DONE:
         break;
+    case SQLITE_SCHEMA:
+        this->invalidateHandle();
+        // fall through
     case SQLITE_BUSY:
         //break;
     default:
@@ -773,28 +1003,107 @@ SqliteResult_libsqlite::close(void)
 
     if(this->m_handle)
     {
-        int err = this->drv()->sqlite3_finalize(this->m_handle);
-        /*
-        Do not check error code, because it returns the last error of step().
+        // Do not check error codes, because they return the last error of step().
+        if(this->m_stale)
+            this->drv()->sqlite3_finalize(this->m_handle);
+        else
+            this->getDbc().releaseStmt(this->m_sql, this->m_handle);
+        this->m_handle = NULL;
+    }
+}
 
-        switch(err)
-        {
-        case SQLITE_OK:
-            this->m_handle = 0;
-            break;
-        default:
 
-            const char *msg = this->drv()->sqlite3_errmsg(this->m_stmt.getDbc().getHandle());
-            String u_msg(msg, "UTF-8");
-            DAL_SQLITE_LIBSQLITE_DIAG_ERROR(this,
-                                            "Can not prepare query",
-                                            u_msg,
-                                            this->drv()->sqlite3_errcode(this->m_stmt.getDbc().getHandle()),
-                                            this->drv()->sqlite3_extended_errcode(this->m_stmt.getDbc().getHandle()));
-            break;
-        };
-        */
+
+/// @details
+/// A buffer that holds all remaining data in its get area, like a
+/// std::stringbuf, is bound without a copy (SQLITE_STATIC). It must stay
+/// unchanged until the statement is closed or executed again. Other
+/// seekable buffers are read once into a buffer owned by SQLite. In
+/// both cases the read position is not changed, so the statement can
+/// be executed again. Buffers that can not seek are read to the end.
+int
+SqliteResult_libsqlite::bindBlob(int num, ByteStreamBuf *buf)
+{
+    typedef std::streambuf::pos_type pos_type;
+    typedef std::streambuf::off_type off_type;
+
+    pos_type start = buf->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+    if(start != pos_type(off_type(-1)))
+    {
+        std::streamoff size = buf->pubseekoff(0, std::ios_base::end, std::ios_base::in) - start;
+        buf->pubseekpos(start, std::ios_base::in);
+
+        if(size > std::numeric_limits<int>::max())
+            return SQLITE_TOOBIG;
+        if(size <= 0)
+            return this->drv()->sqlite3_bind_zeroblob(this->getHandle(), num, 0);
+
+        const char *data = streambuf_access::gptr_of(buf);
+        if(data && streambuf_access::egptr_of(buf) - data >= size)
+            return this->drv()->sqlite3_bind_blob(this->getHandle(), num, data, int(size), SQLITE_STATIC);
+
+        char *copy = static_cast<char*>(std::malloc(size_t(size)));
+        if(! copy)
+            throw std::bad_alloc();
+        std::streamsize n = buf->sgetn(copy, size);
+        buf->pubseekpos(start, std::ios_base::in);
+        return this->drv()->sqlite3_bind_blob(this->getHandle(), num, copy, int(n), free_blob);
+    }
+
+    size_t size = 0, capacity = DAL_SQLITE_BLOB_CHUNK_SIZE;
+    char *copy = static_cast<char*>(std::malloc(capacity));
+    for(std::streamsize n = 1; copy && n > 0; size += size_t(n))
+    {
+        if(size == capacity)
+        {
+            char *grown = static_cast<char*>(std::realloc(copy, capacity * 2));
+            if(! grown)
+                std::free(copy);
+            copy = grown;
+            capacity *= 2;
+            if(! copy)
+                break;
+        }
+        n = buf->sgetn(copy + size, std::streamsize(capacity - size));
     }
+    if(! copy)
+        throw std::bad_alloc();
+    if(size > size_t(std::numeric_limits<int>::max()))
+    {
+        std::free(copy);
+        return SQLITE_TOOBIG;
+    }
+    return this->drv()->sqlite3_bind_blob(this->getHandle(), num, copy, int(size), free_blob);
+}
+
+
+
+/// @details
+/// Only the first step of an execution is retried. SQLite resets a
+/// statement after an error, so retrying a later step would silently
+/// restart the result at the first row.
+int
+SqliteResult_libsqlite::stepRetry(void)
+{
+    int err, attempt = 0;
+    while(((err = this->drv()->sqlite3_step(this->m_handle)) == SQLITE_BUSY
+           || err == SQLITE_LOCKED)
+          && this->getDbc().busyBackoff(attempt))
+        ;
+    return err;
+}
+
+
+
+/// @details
+/// SQLITE_SCHEMA is only returned if SQLite could not recompile the
+/// statement itself, so this statement and all idle statements of the
+/// connection are dropped instead of being reused.
+void
+SqliteResult_libsqlite::invalidateHandle(void)
+{
+    this->m_stale = true;
+    this->getDbc().clearStmtCache();
 }
 
 
@@ -927,11 +1236,11 @@ SqliteResult_libsqlite::columnID(String name) const
     if(! this->isOpen())
         throw EngineException("Resultset is not open.");
 
-    for(colnum_t i = 1; i <= this->columnCount(); ++i)
-    {
-        if(name == this->columnName(i))
-            return i;
-    }
+    if(! this->m_column_index.isValid())
+        this->m_column_index.build(*this);
+
+    if(colnum_t num = this->m_column_index.find(name))
+        return num;
     throw NotFoundException(US("Column '") + String::Internal(name) + US("' not found."));
 }
 
@@ -975,7 +1284,8 @@ SqliteResult_libsqlite::getDbc(void) const
 
 //
 //
-SqliteColumnDesc_libsqlite::SqliteColumnDesc_libsqlite(colnum_t i, SqliteResult_libsqlite &result)
+SqliteColumnDesc_libsqlite::SqliteColumnDesc_libsqlite(colnum_t i, SqliteResult_libsqlite &result,
+                                                       SqlTypeParser &parser)
     : SqliteColumnDesc()
 {
     if(i == 0)
@@ -992,14 +1302,12 @@ SqliteColumnDesc_libsqlite::SqliteColumnDesc_libsqlite(colnum_t i, SqliteResult_
         // set type
         const char *type = result.drv()->sqlite3_column_decltype(result.getHandle(), i-1);
 
-        SqlTypeParser pt;
-        pt.registerType(DAL_TYPE_STRING, US("TEXT*"));
-        pt.parse(String::fromUTF8(type));
-        this->m_type_name.set(daltype2sqlname(pt.getDaltype()));
-        this->m_daltype = pt.getDaltype();
-        this->m_size.set<signed int>(pt.getSize());
-        this->m_precision.set<unsigned short>(pt.getPrecision());
-        this->m_scale.set<unsigned short>(pt.getSize());
+        parser.parse(String::fromUTF8(type));
+        this->m_type_name.set(daltype2sqlname(parser.getDaltype()));
+        this->m_daltype = parser.getDaltype();
+        this->m_size.set<signed int>(parser.getSize());
+        this->m_precision.set<unsigned short>(parser.getPrecision());
+        this->m_scale.set<unsigned short>(parser.getSize());
     }
 }
 
@@ -1015,15 +1323,12 @@ SqliteResult_libsqlite::describeColumn(colnum_t num) const
         throw EngineException("Resultset is not open.");
 
 
-    std::map<colnum_t, SqliteColumnDesc_libsqlite>::const_iterator i =
-        this->m_column_desc.find(num);
-
-    if(i == this->m_column_desc.end())
+    if(num >= this->m_column_desc.size())
     {
         throw NotFoundException(US("Column '") + String::Internal(Variant(int(num)).asStr()) + US("' not found."));
     }
     else
-        return i->second;
+        return this->m_column_desc[num];
 }
 
 
@@ -1036,21 +1341,55 @@ SqliteResult_libsqlite::describeColumn(String name) const
 }
 
 
+/// @details
+/// The descriptors only depend on the prepared statement, so repeated
+/// executions reuse them. SQLite may recompile a statement after a
+/// schema change, a different column count rebuilds the descriptors.
 void
 SqliteResult_libsqlite::refreshMetadata(void)
 {
     DALTRACE_ENTER;
-    this->m_column_desc.clear();
     if(! this->getHandle())
+    {
+        this->m_column_desc.clear();
+        this->m_column_sig.clear();
+        this->m_column_index.clear();
         return;
+    }
     
+    // SQLite recompiles the statement after schema changes, the
+    // descriptors are only kept if names and declared types match
     size_t colcount = this->columnCount();
-    SqliteColumnDesc desc;
+    bool same = this->m_column_desc.size() == colcount + 1;
+    for(size_t i = 0; same && i < colcount; ++i)
+    {
+        const char *name = this->drv()->sqlite3_column_name(this->getHandle(), i);
+        const char *type = this->drv()->sqlite3_column_decltype(this->getHandle(), i);
+        same = this->m_column_sig[i].first == (name ? name : "")
+            && this->m_column_sig[i].second == (type ? type : "");
+    }
+    if(same)
+        return;
+
+    this->m_column_desc.clear();
+    this->m_column_sig.clear();
+    this->m_column_index.clear();
+    this->m_column_sig.reserve(colcount);
+    for(size_t i = 0; i < colcount; ++i)
+    {
+        const char *name = this->drv()->sqlite3_column_name(this->getHandle(), i);
+        const char *type = this->drv()->sqlite3_column_decltype(this->getHandle(), i);
+        this->m_column_sig.push_back(std::make_pair(std::string(name ? name : ""),
+                                                    std::string(type ? type : "")));
+    }
+    this->m_column_desc.reserve(colcount + 1);
+
+    SqlTypeParser pt;
+    pt.registerType(DAL_TYPE_STRING, US("TEXT*"));
     
     for(size_t i = 0; i <= colcount; ++i)
     {
-        SqliteColumnDesc_libsqlite x(i, *this);
-        this->m_column_desc.insert(std::pair<colnum_t, SqliteColumnDesc_libsqlite>(i, x));
+        this->m_column_desc.push_back(SqliteColumnDesc_libsqlite(i, *this, pt));
     }
 }
 
@@ -1108,8 +1447,16 @@ SqliteDbc_libsqlite::SqliteDbc_libsqlite(SqliteEnv_libsqlite& env)
     : SqliteDbc(),
       m_lib(env.drv()),
       m_dbh(0),
-	  m_env(env)
-{ }
+	  m_env(env),
+      m_stmt_cache(),
+      m_stmt_cache_index(),
+      m_stmt_cache_hits(0),
+      m_stmt_cache_misses(0),
+      m_busy_retries(0),
+      m_busy_backoff(10)
+{
+    this->m_options[DBWTL_SQLITE_STMT_CACHE_SIZE] = int(32);
+}
 
 IEnv&
 	SqliteDbc_libsqlite::getEnv(void)
@@ -1274,7 +1621,17 @@ SqliteDiag_libsqlite::str(void) const
 
 
 
-//
+/// @details
+/// Besides "database", the following options are supported:
+///  - busy_timeout: milliseconds SQLite waits for a lock (sqlite3_busy_timeout)
+///  - busy_retries: retries of prepare and execute after SQLITE_BUSY or
+///    SQLITE_LOCKED (default 0)
+///  - busy_backoff: initial wait between retries in milliseconds, doubled
+///    for each retry up to one second (default 10)
+///  - journal_mode: DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF
+///  - synchronous: OFF, NORMAL, FULL or EXTRA
+///  - cache_size: page cache size, negative values are KiB
+///  - mmap_size: maximum bytes of the database file to memory-map
 void
 SqliteDbc_libsqlite::connect(IDbc::Options& options)
 {
@@ -1310,13 +1667,185 @@ SqliteDbc_libsqlite::connect(IDbc::Options& options)
 
 
     if(this->isConnected())
+    {
         this->setDbcEncoding("UTF-8");
+        try
+        {
+            this->configure(options);
+        }
+        catch(...)
+        {
+            this->disconnect();
+            throw;
+        }
+    }
 
     DALTRACE_LEAVE;
 }
 
 
 
+/// Returns true and sets value if the option is given and not empty
+static bool get_option(IDbc::Options &options, const char *name, String &value)
+{
+    IDbc::Options::const_iterator i = options.find(name);
+    if(i == options.end() || i->second.empty())
+        return false;
+    value = i->second;
+    return true;
+}
+
+
+/// Returns the integer value of an option
+static long long int_option(const char *name, const String &value)
+{
+    try
+    {
+        return Variant(value).asBigint();
+    }
+    catch(ConvertException &)
+    {
+        throw EngineException(FORMAT2("Invalid value for option \"%s\": %s", String(name), value));
+    }
+}
+
+
+/// Returns the upper case value of an option if it is one of choices
+static String choice_option(const char *name, const String &value, const char **choices)
+{
+    String v = value.upper();
+    for(; *choices; ++choices)
+    {
+        if(v == String(*choices))
+            return v;
+    }
+    throw EngineException(FORMAT2("Invalid value for option \"%s\": %s", String(name), value));
+}
+
+
+
+//
+void
+SqliteDbc_libsqlite::configure(IDbc::Options &options)
+{
+    static const char *journal_modes[] = { "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF", 0 };
+    static const char *sync_levels[] = { "OFF", "NORMAL", "FULL", "EXTRA", 0 };
+    String value;
+
+    this->m_busy_retries = 0;
+    this->m_busy_backoff = 10;
+
+    if(get_option(options, "busy_timeout", value))
+        this->drv()->sqlite3_busy_timeout(this->m_dbh, int(int_option("busy_timeout", value)));
+    if(get_option(options, "busy_retries", value))
+        this->m_busy_retries = int(int_option("busy_retries", value));
+    if(get_option(options, "busy_backoff", value))
+        this->m_busy_backoff = int(int_option("busy_backoff", value));
+
+    if(get_option(options, "journal_mode", value))
+        this->directCmd(String("PRAGMA journal_mode=") + choice_option("journal_mode", value, journal_modes));
+    if(get_option(options, "synchronous", value))
+        this->directCmd(String("PRAGMA synchronous=") + choice_option("synchronous", value, sync_levels));
+    if(get_option(options, "cache_size", value))
+        this->directCmd(String("PRAGMA cache_size=") + Variant(int_option("cache_size", value)).asStr());
+    if(get_option(options, "mmap_size", value))
+        this->directCmd(String("PRAGMA mmap_size=") + Variant(int_option("mmap_size", value)).asStr());
+}
+
+
+
+/// @details
+/// Fails if the data is larger than the stored BLOB value.
+void
+SqliteDbc_libsqlite::writeBlob(String table, String column, int64_t rowid, ByteStreamBuf *data)
+{
+    DALTRACE_ENTER;
+
+    if(! this->isConnected())
+        throw EngineException("not connected");
+
+    ::sqlite3_blob *blob = NULL;
+    int err = this->drv()->sqlite3_blob_open(this->m_dbh, "main", table.utf8(), column.utf8(),
+                                             rowid, 1, &blob);
+
+    std::vector<char> chunk(DAL_SQLITE_BLOB_CHUNK_SIZE);
+    int offset = 0;
+    while(err == SQLITE_OK)
+    {
+        std::streamsize n = data->sgetn(&chunk[0], std::streamsize(chunk.size()));
+        if(n <= 0)
+            break;
+        err = this->drv()->sqlite3_blob_write(blob, &chunk[0], int(n), offset);
+        offset += int(n);
+    }
+
+    if(err != SQLITE_OK)
+    {
+        // blob_close() would overwrite the error information
+        String u_msg(this->drv()->sqlite3_errmsg(this->m_dbh), "UTF-8");
+        int code = this->drv()->sqlite3_errcode(this->m_dbh);
+        int excode = this->drv()->sqlite3_extended_errcode(this->m_dbh);
+        if(blob)
+            this->drv()->sqlite3_blob_close(blob);
+        DAL_SQLITE_LIBSQLITE_DIAG_ERROR(this,
+                                        String("Can not write BLOB: ") + table + String(".") + column,
+                                        u_msg, code, excode);
+    }
+    this->drv()->sqlite3_blob_close(blob);
+
+    DALTRACE_LEAVE;
+}
+
+
+
+//
+SqliteBlob*
+SqliteDbc_libsqlite::openBlob(String table, String column, int64_t rowid)
+{
+    DALTRACE_ENTER;
+
+    if(! this->isConnected())
+        throw EngineException("not connected");
+
+    ::sqlite3_blob *blob = NULL;
+    int err = this->drv()->sqlite3_blob_open(this->m_dbh, "main", table.utf8(), column.utf8(),
+                                             rowid, 0, &blob);
+    if(err != SQLITE_OK)
+    {
+        String u_msg(this->drv()->sqlite3_errmsg(this->m_dbh), "UTF-8");
+        int code = this->drv()->sqlite3_errcode(this->m_dbh);
+        int excode = this->drv()->sqlite3_extended_errcode(this->m_dbh);
+        if(blob)
+            this->drv()->sqlite3_blob_close(blob);
+        DAL_SQLITE_LIBSQLITE_DIAG_ERROR(this,
+                                        String("Can not open BLOB: ") + table + String(".") + column,
+                                        u_msg, code, excode);
+    }
+
+    DALTRACE_LEAVE;
+    return new SqliteBlobReader_libsqlite(*this, blob);
+}
+
+
+
+/// @details
+/// The wait starts at busy_backoff milliseconds and is doubled for
+/// each retry, but never exceeds one second.
+bool
+SqliteDbc_libsqlite::busyBackoff(int &attempt) const
+{
+    if(attempt >= this->m_busy_retries)
+        return false;
+
+    long long delay = this->m_busy_backoff > 0 ? this->m_busy_backoff : 1;
+    delay <<= std::min(attempt, 10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::min(delay, 1000LL)));
+    ++attempt;
+    return true;
+}
+
+
+
 //
 void
 SqliteDbc_libsqlite::disconnect(void)
@@ -1326,6 +1855,7 @@ SqliteDbc_libsqlite::disconnect(void)
     if(this->m_dbh)
     {
         DALTRACE("is connected, disconnecting...");
+        this->clearStmtCache();
         int err = this->drv()->sqlite3_close(this->m_dbh);
         switch(err)
         {
@@ -1399,6 +1929,112 @@ SqliteDbc_libsqlite::getCurrentCatalog(void)
 
 
 
+//
+size_t
+SqliteDbc_libsqlite::stmtCacheHits(void) const
+{
+    return this->m_stmt_cache_hits;
+}
+
+
+
+//
+size_t
+SqliteDbc_libsqlite::stmtCacheMisses(void) const
+{
+    return this->m_stmt_cache_misses;
+}
+
+
+
+//
+void
+SqliteDbc_libsqlite::clearStmtCache(void)
+{
+    for(StmtCacheListT::iterator i = this->m_stmt_cache.begin();
+        i != this->m_stmt_cache.end();
+        ++i)
+    {
+        this->drv()->sqlite3_finalize(i->second);
+    }
+    this->m_stmt_cache.clear();
+    this->m_stmt_cache_index.clear();
+}
+
+
+
+//
+::sqlite3_stmt*
+SqliteDbc_libsqlite::acquireStmt(const std::string &sql)
+{
+    StmtCacheIndexT::iterator i = this->m_stmt_cache_index.find(sql);
+    if(i == this->m_stmt_cache_index.end())
+    {
+        ++this->m_stmt_cache_misses;
+        return NULL;
+    }
+    ::sqlite3_stmt *stmt = i->second->second;
+    this->m_stmt_cache.erase(i->second);
+    this->m_stmt_cache_index.erase(i);
+    ++this->m_stmt_cache_hits;
+    return stmt;
+}
+
+
+
+/// @details
+/// If an idle statement with the same SQL text is already cached, the
+/// returned one is finalized. This happens if two statements with the
+/// same query were open at the same time.
+void
+SqliteDbc_libsqlite::releaseStmt(const std::string &sql, ::sqlite3_stmt *stmt)
+{
+    int capacity = this->getOption(DBWTL_SQLITE_STMT_CACHE_SIZE).asInt();
+
+    if(capacity <= 0 || this->m_stmt_cache_index.count(sql))
+    {
+        this->drv()->sqlite3_finalize(stmt);
+        return;
+    }
+
+    this->drv()->sqlite3_reset(stmt);
+    this->drv()->sqlite3_clear_bindings(stmt);
+
+    this->m_stmt_cache.push_front(StmtCacheListT::value_type(sql, stmt));
+    this->m_stmt_cache_index[sql] = this->m_stmt_cache.begin();
+    this->trimStmtCache();
+}
+
+
+
+//
+void
+SqliteDbc_libsqlite::trimStmtCache(void)
+{
+    int capacity = this->getOption(DBWTL_SQLITE_STMT_CACHE_SIZE).asInt();
+
+    while(! this->m_stmt_cache.empty() && this->m_stmt_cache.size() > size_t(capacity > 0 ? capacity : 0))
+    {
+        this->drv()->sqlite3_finalize(this->m_stmt_cache.back().second);
+        this->m_stmt_cache_index.erase(this->m_stmt_cache.back().first);
+        this->m_stmt_cache.pop_back();
+    }
+}
+
+
+
+/// @details
+/// A smaller statement cache size takes effect immediately.
+void
+SqliteDbc_libsqlite::setOption(std::string name, const Variant &data)
+{
+    SqliteDbc::setOption(name, data);
+    if(name == DBWTL_SQLITE_STMT_CACHE_SIZE)
+        this->trimStmtCache();
+}
+
+
+
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
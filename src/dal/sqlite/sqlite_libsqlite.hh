@@ -49,6 +49,9 @@
 #include "dbwtl/dal/engines/sqlite_engine.hh"
 #include "driver_libsqlite.hh"
 
+#include <cassert>
+#include <vector>
+
 
 DAL_NAMESPACE_BEGIN
 
@@ -58,6 +61,7 @@ class SqliteDbc_libsqlite;
 class SqliteEnv_libsqlite;
 class SqliteData_libsqlite;
 class SqliteDiag_libsqlite;
+class SqlTypeParser;
 
 
 
@@ -134,6 +138,58 @@ private:
 
 
 
+//------------------------------------------------------------------------------
+///
+/// @internal
+/// @brief Incremental BLOB reader for libsqlite
+///
+/// @details Reads a BLOB handle opened with sqlite3_blob_open() in
+/// chunks, only one chunk is held in memory.
+class SqliteBlobReader_libsqlite : public SqliteBlob
+{
+public:
+    SqliteBlobReader_libsqlite(SqliteDbc_libsqlite &dbc, ::sqlite3_blob *blob);
+
+    virtual ~SqliteBlobReader_libsqlite(void);
+
+protected:
+    virtual int_type underflow();
+
+    virtual std::streamsize showmanyc();
+
+    virtual std::streamsize xsgetn(char_type *ch, std::streamsize n);
+
+    virtual pos_type seekpos(pos_type p,
+                             std::ios_base::openmode m = std::ios_base::in | std::ios_base::out);
+
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir way,
+                             std::ios_base::openmode m = std::ios_base::in | std::ios_base::out);
+
+    /// Reads n bytes at offset from the BLOB, throws on errors
+    void read(char_type *dest, int n, int offset);
+
+    /// Current read position in the BLOB
+    inline int position(void) const { return this->m_offset + int(this->gptr() - this->eback()); }
+
+    SqliteDbc_libsqlite    &m_dbc;
+    ::sqlite3_blob         *m_blob;
+    int                     m_size;
+
+    ///
+    /// @brief Offset of the buffered chunk in the BLOB
+    int                     m_offset;
+    std::vector<char_type>  m_chunk;
+
+private:
+    SqliteBlobReader_libsqlite(const SqliteBlobReader_libsqlite&);
+    SqliteBlobReader_libsqlite& operator=(const SqliteBlobReader_libsqlite&);
+};
+
+
+
+
+
+
 //------------------------------------------------------------------------------
 ///
 /// @internal
@@ -159,6 +215,8 @@ public:
 
     virtual String getString(void) const;
 
+    virtual bool getUTF8View(utf8_view &view) const;
+
     virtual daltype_t daltype(void) const;
 
 protected:
@@ -178,7 +236,7 @@ protected:
 class SqliteColumnDesc_libsqlite : public SqliteColumnDesc
 {
 public:
-    SqliteColumnDesc_libsqlite(colnum_t i, SqliteResult_libsqlite &result);
+    SqliteColumnDesc_libsqlite(colnum_t i, SqliteResult_libsqlite &result, SqlTypeParser &parser);
 
     virtual ~SqliteColumnDesc_libsqlite(void)
     {}
@@ -226,6 +284,13 @@ public:
 
     virtual const SqliteColumnDesc& describeColumn(String name) const;
 
+    /// @brief Returns the type of a column without any state checks
+    inline daltype_t columnType(colnum_t num) const
+    {
+        assert(num < this->m_column_desc.size());
+        return this->m_column_desc[num].getDatatype();
+    }
+
 
     virtual SqliteDbc_libsqlite& getDbc(void) const;
 
@@ -243,10 +308,27 @@ protected:
 
     virtual void         refreshMetadata(void);
     virtual size_t       paramCount(void) const;
+
+    /// Drops the handle from the statement cache after SQLITE_SCHEMA
+    void                 invalidateHandle(void);
+
+    /// Steps the statement, retries on SQLITE_BUSY and SQLITE_LOCKED
+    int                  stepRetry(void);
+
+    /// Binds the data of a BLOB parameter
+    int                  bindBlob(int num, ByteStreamBuf *buf);
     
 
     SqliteStmt_libsqlite    &m_stmt;
     mutable ::sqlite3_stmt  *m_handle;
+
+    ///
+    /// @brief UTF-8 text of the prepared query, used as statement cache key
+    std::string              m_sql;
+
+    ///
+    /// @brief Set if the handle must be finalized instead of returned to the cache
+    bool                     m_stale;
     rowid_t                  m_current_tuple;
     int                      m_last_row_status;
     bool                     m_isopen;
@@ -254,7 +336,20 @@ protected:
 
     ///
     /// @brief Stores the type information of all columns in the resultset
-    std::map<colnum_t, SqliteColumnDesc_libsqlite>     m_column_desc;
+    ///
+    /// @details Indexed by column number, entry 0 describes the bookmark
+    /// column. The descriptors are built by the first execute() and
+    /// kept until the statement is prepared again or SQLite reports
+    /// other column names or declared types.
+    std::vector<SqliteColumnDesc_libsqlite>            m_column_desc;
+
+    ///
+    /// @brief Name and declared type of each column as seen by refreshMetadata()
+    std::vector<std::pair<std::string, std::string> >  m_column_sig;
+
+    ///
+    /// @brief Maps column names to column numbers, invalidated by refreshMetadata()
+    mutable ColumnIndex                                m_column_index;
 
     ///
     /// @brief Stores all column accessors (IVariants) requested by an user for
@@ -381,13 +476,64 @@ public:
 
     virtual Variant        getCurrentCatalog(void);
 
+    virtual void           setOption(std::string name, const Variant &data);
+
+    virtual size_t         stmtCacheHits(void) const;
+    virtual size_t         stmtCacheMisses(void) const;
+    virtual void           clearStmtCache(void);
+
+    virtual void           writeBlob(String table, String column, int64_t rowid,
+                                     ByteStreamBuf *data);
+
+    virtual SqliteBlob*    openBlob(String table, String column, int64_t rowid);
+
+    /// @brief Takes a prepared statement for sql out of the cache
+    /// @details Returns NULL on a miss, the caller prepares the
+    /// statement itself and hands it back with releaseStmt().
+    ::sqlite3_stmt*        acquireStmt(const std::string &sql);
+
+    /// @brief Returns a statement to the cache
+    /// @details The statement is reset and its bindings are cleared.
+    /// If the cache is full, the least recently used statement is
+    /// finalized.
+    void                   releaseStmt(const std::string &sql, ::sqlite3_stmt *stmt);
+
+    /// @brief Waits before a call is retried after SQLITE_BUSY or SQLITE_LOCKED
+    /// @details attempt counts the retries of one call and starts at 0.
+    /// Returns false if all retries are used up.
+    bool                   busyBackoff(int &attempt) const;
+
 protected:
     virtual void           setDbcEncoding(std::string encoding);
 
+    /// Applies the busy handling and PRAGMA options of connect()
+    void                   configure(IDbc::Options &options);
+
+    /// Finalizes least recently used statements above the cache capacity
+    void                   trimStmtCache(void);
+
+    typedef std::list<std::pair<std::string, ::sqlite3_stmt*> >      StmtCacheListT;
+    typedef std::map<std::string, StmtCacheListT::iterator>          StmtCacheIndexT;
+
     SQLite3Drv           *m_lib; /* lib is stored in ENV */
     mutable ::sqlite3    *m_dbh;
 	SqliteEnv_libsqlite  &m_env;
 
+    ///
+    /// @brief Idle prepared statements, most recently used first
+    StmtCacheListT        m_stmt_cache;
+    StmtCacheIndexT       m_stmt_cache_index;
+    size_t                m_stmt_cache_hits;
+    size_t                m_stmt_cache_misses;
+
+    ///
+    /// @brief Retries after SQLITE_BUSY or SQLITE_LOCKED, 0 disables retries
+    int                   m_busy_retries;
+
+    ///
+    /// @brief Initial wait between retries in milliseconds, doubled per retry
+    int                   m_busy_backoff;
+
 
 private:
     SqliteDbc_libsqlite(const SqliteDbc_libsqlite&);
@@ -974,6 +974,7 @@ SqlCursor::close(void)
         throw EngineException("Resultset is in bad state.");
 
     this->m_fields.clear();
+    this->m_column_index.clear();
     //this->m_params.clear();
 
     this->m_objects.clear();
@@ -1037,11 +1038,11 @@ SqlCursor::columnID(String name) const
     if(! this->isOpen())
         throw EngineException("Resultset is not open.");
 
-    for(colnum_t i = 1; i <= this->columnCount(); ++i)
-    {
-        if(name == this->columnName(i))
-            return i;
-    }
+    if(! this->m_column_index.isValid())
+        this->m_column_index.build(*this);
+
+    if(colnum_t num = this->m_column_index.find(name))
+        return num;
     throw NotFoundException(US("Column '") + String::Internal(name) + US("' not found."));
 }
 
@@ -1125,6 +1126,7 @@ SqlCursor::SqlCursor(IStmt &stmt)
     m_objects(),
     m_objects_vector(),
     m_fields(),
+    m_column_index(),
     m_identifiers(),
     m_params(),
     m_tree(),
@@ -1283,6 +1285,7 @@ ParserAdaptor::addComputedField(ExprNode *node, const String &alias)
     assert(alias.length());
     f->m_name = alias;
     this->cursor().m_fields[this->cursor().m_fields.size() + 1] = f;
+    this->cursor().m_column_index.clear();
 }
 
 
@@ -1296,6 +1299,7 @@ ParserAdaptor::addStaticField(const String &alias, const Variant &var)
     assert(alias.length());
     f->m_name = alias;
     this->cursor().m_fields[this->cursor().m_fields.size() + 1] = f;
+    this->cursor().m_column_index.clear();
 }
 
 
@@ -1347,6 +1351,7 @@ ParserAdaptor::addDataField(colnum_t colnum, DBObject &obj, const String &alias)
     if(!alias.empty())
         f->m_name = alias;
     this->cursor().m_fields[this->cursor().m_fields.size() + 1] = f;
+    this->cursor().m_column_index.clear();
 }
 
 
@@ -1359,6 +1364,7 @@ ParserAdaptor::addParamField( const String &alias, size_t param_num)
     assert(alias.length());
     f->m_name = alias;
     this->cursor().m_fields[this->cursor().m_fields.size() + 1] = f;
+    this->cursor().m_column_index.clear();
 }
 
 
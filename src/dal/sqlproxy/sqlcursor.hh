@@ -183,6 +183,7 @@ protected:
     object_map_type               m_objects;
     object_vector_type            m_objects_vector;
     field_map_type                m_fields;
+    mutable ColumnIndex           m_column_index;
     identifier_map_type           m_identifiers;
     param_map_type                m_params;
     std::auto_ptr<ParseTree>      m_tree;
@@ -0,0 +1,402 @@
+//
+// recordcodec.cc - Binary record format (definition)
+//
+// Copyright (C)         informave.org
+//   2013,               Daniel Vogelbacher <daniel@vogelbacher.name>
+//
+// BSD License
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the
+// distribution.
+//
+// Neither the name of the copyright holders nor the names of its
+// contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief Binary record format (definitions)
+/// @author Daniel Vogelbacher
+/// @since 0.0.1
+
+
+#include "dbwtl/dal/dal_fwd.hh"
+#include "dbwtl/db_objects.hh"
+#include "dbwtl/exceptions.hh"
+#include "dal/dal_debug.hh"
+#include "recordcodec.hh"
+#include "utils.hh"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+
+
+DB_NAMESPACE_BEGIN
+
+
+/// @brief Throws if the buffer ends before n bytes are available
+static inline void need(const char *ptr, const char *end, size_t n)
+{
+    if(size_t(end - ptr) < n)
+        throw EngineException("Corrupt record data: unexpected end of buffer");
+}
+
+
+template<typename T>
+static inline void put_raw(std::string &buf, const Variant &value)
+{
+    T v = value.get<T>();
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+
+template<typename T>
+static inline const char* get_raw(const char *ptr, const char *end, Variant &dest)
+{
+    T v;
+    need(ptr, end, sizeof(T));
+    std::memcpy(&v, ptr, sizeof(T));
+    dest = Variant(v);
+    return ptr + sizeof(T);
+}
+
+
+static inline void put_bytes(std::string &buf, const char *ptr, size_t len)
+{
+    encode_length(buf, len);
+    buf.append(ptr, len);
+}
+
+
+static inline void put_string(std::string &buf, const Variant &value)
+{
+    utf8_view view;
+    if(value.get_utf8_view(view))
+        put_bytes(buf, view.data(), view.size());
+    else
+    {
+        size_t len = 0;
+        String s = value.get<String>();
+        const char *p = s.utf8(len);
+        put_bytes(buf, p, len);
+    }
+}
+
+
+/// @brief Converts text back into the original type, keeps the
+/// string if there is no conversion
+template<typename T>
+static inline void from_text(const String &s, Variant &dest)
+{
+    Variant tmp(s);
+    if(tmp.can_convert<T>())
+        dest = Variant(tmp.get<T>());
+    else
+        dest = tmp;
+}
+
+
+
+/// @details
+/// 
+void
+encode_length(std::string &buf, size_t len)
+{
+    while(len >= 0x80)
+    {
+        buf.push_back(static_cast<char>((len & 0x7F) | 0x80));
+        len >>= 7;
+    }
+    buf.push_back(static_cast<char>(len));
+}
+
+
+/// @details
+/// 
+const char*
+decode_length(const char *ptr, const char *end, size_t &len)
+{
+    len = 0;
+    for(int shift = 0; ; shift += 7)
+    {
+        need(ptr, end, 1);
+        if(shift >= int(sizeof(size_t) * 8))
+            throw EngineException("Corrupt record data: invalid length");
+        unsigned char c = static_cast<unsigned char>(*ptr++);
+        len |= size_t(c & 0x7F) << shift;
+        if(! (c & 0x80))
+            return ptr;
+    }
+}
+
+
+/// @details
+/// 
+void
+encode_value(std::string &buf, const Variant &value)
+{
+    if(value.isnull())
+    {
+        buf.push_back(static_cast<char>(DBWTL_CODEC_NULL));
+        return;
+    }
+
+    daltype_t type = value.datatype();
+    switch(type)
+    {
+    case DAL_TYPE_BLOBSTREAM:   type = DAL_TYPE_BLOB; break;
+    case DAL_TYPE_MEMOSTREAM:   type = DAL_TYPE_MEMO; break;
+    case DAL_TYPE_CUSTOM:
+    case DAL_TYPE_UNKNOWN:      type = DAL_TYPE_STRING; break;
+    default: break;
+    }
+    buf.push_back(static_cast<char>(type));
+
+    switch(type)
+    {
+    case DAL_TYPE_INT:          put_raw<signed int>(buf, value); break;
+    case DAL_TYPE_UINT:         put_raw<unsigned int>(buf, value); break;
+    case DAL_TYPE_CHAR:         put_raw<signed char>(buf, value); break;
+    case DAL_TYPE_UCHAR:        put_raw<unsigned char>(buf, value); break;
+    case DAL_TYPE_BOOL:         put_raw<bool>(buf, value); break;
+    case DAL_TYPE_SMALLINT:     put_raw<signed short>(buf, value); break;
+    case DAL_TYPE_USMALLINT:    put_raw<unsigned short>(buf, value); break;
+    case DAL_TYPE_BIGINT:       put_raw<signed long long>(buf, value); break;
+    case DAL_TYPE_UBIGINT:      put_raw<unsigned long long>(buf, value); break;
+    case DAL_TYPE_FLOAT:        put_raw<float>(buf, value); break;
+    case DAL_TYPE_DOUBLE:       put_raw<double>(buf, value); break;
+    case DAL_TYPE_BLOB:
+    {
+        std::stringstream ss;
+        Blob blob = value.get<Blob>();
+        ss << blob.rdbuf();
+        const std::string &data = ss.str();
+        put_bytes(buf, data.data(), data.size());
+        break;
+    }
+    default:
+        put_string(buf, value);
+    }
+}
+
+
+/// @details
+/// 
+const char*
+decode_value(const char *ptr, const char *end, Variant &dest)
+{
+    need(ptr, end, 1);
+    unsigned char tag = static_cast<unsigned char>(*ptr++);
+
+    if(tag == DBWTL_CODEC_NULL)
+    {
+        dest.setNull();
+        return ptr;
+    }
+
+    switch(daltype_t(tag))
+    {
+    case DAL_TYPE_INT:          return get_raw<signed int>(ptr, end, dest);
+    case DAL_TYPE_UINT:         return get_raw<unsigned int>(ptr, end, dest);
+    case DAL_TYPE_CHAR:         return get_raw<signed char>(ptr, end, dest);
+    case DAL_TYPE_UCHAR:        return get_raw<unsigned char>(ptr, end, dest);
+    case DAL_TYPE_BOOL:         return get_raw<bool>(ptr, end, dest);
+    case DAL_TYPE_SMALLINT:     return get_raw<signed short>(ptr, end, dest);
+    case DAL_TYPE_USMALLINT:    return get_raw<unsigned short>(ptr, end, dest);
+    case DAL_TYPE_BIGINT:       return get_raw<signed long long>(ptr, end, dest);
+    case DAL_TYPE_UBIGINT:      return get_raw<unsigned long long>(ptr, end, dest);
+    case DAL_TYPE_FLOAT:        return get_raw<float>(ptr, end, dest);
+    case DAL_TYPE_DOUBLE:       return get_raw<double>(ptr, end, dest);
+    default:
+        break;
+    }
+
+    size_t len = 0;
+    ptr = decode_length(ptr, end, len);
+    need(ptr, end, len);
+
+    if(tag == DAL_TYPE_BLOB)
+    {
+        dest = Variant(Blob(ptr, len));
+        return ptr + len;
+    }
+
+    String s;
+    s.loadUTF8(ptr, len);
+
+    switch(daltype_t(tag))
+    {
+    case DAL_TYPE_STRING:       dest = Variant(s); break;
+    case DAL_TYPE_MEMO:         dest = Variant(Memo(Variant(s))); break;
+    case DAL_TYPE_NUMERIC:      from_text<TNumeric>(s, dest); break;
+    case DAL_TYPE_DATE:         from_text<TDate>(s, dest); break;
+    case DAL_TYPE_TIME:         from_text<TTime>(s, dest); break;
+    case DAL_TYPE_TIMESTAMP:    from_text<TTimestamp>(s, dest); break;
+    case DAL_TYPE_INTERVAL:     from_text<TInterval>(s, dest); break;
+    case DAL_TYPE_VARBINARY:    from_text<TVarbinary>(s, dest); break;
+    default:
+        throw EngineException(FORMAT1("Corrupt record data: invalid type tag %d", int(tag)));
+    }
+    return ptr + len;
+}
+
+
+/// @details
+/// 
+void
+encode_record(std::string &buf, const ShrRecord &rec)
+{
+    encode_length(buf, rec.size());
+    for(size_t i = 0; i < rec.size(); ++i)
+        encode_value(buf, rec[i]);
+}
+
+
+/// @details
+/// 
+const char*
+decode_record(const char *ptr, const char *end, ShrRecord &rec)
+{
+    size_t ncol = 0;
+    ptr = decode_length(ptr, end, ncol);
+    ShrRecord tmp(ncol);
+    for(size_t i = 0; i < ncol; ++i)
+        ptr = decode_value(ptr, end, tmp[i]);
+    rec = tmp;
+    return ptr;
+}
+
+
+/// @details
+/// Strings are counted with their UTF-8 length, in-memory BLOB and
+/// MEMO values with the size of their buffer. All other values count
+/// with the size of the Variant only.
+size_t
+record_memory_size(const ShrRecord &rec)
+{
+    size_t size = sizeof(Variant) * rec.size();
+    for(size_t i = 0; i < rec.size(); ++i)
+    {
+        const Variant &value = rec[i];
+        if(value.isnull() || value.is_inline())
+            continue;
+
+        switch(value.datatype())
+        {
+        case DAL_TYPE_STRING:
+        {
+            utf8_view view;
+            if(value.get_utf8_view(view))
+                size += view.size();
+            break;
+        }
+        case DAL_TYPE_BLOB:
+            if(const sa_base<Blob> *a = dynamic_cast<const sa_base<Blob>*>(value.get_storage()))
+                size += a->get_value().size();
+            break;
+        case DAL_TYPE_MEMO:
+            if(const sa_base<Memo> *a = dynamic_cast<const sa_base<Memo>*>(value.get_storage()))
+                size += a->get_value().size();
+            break;
+        default:
+            break;
+        }
+    }
+    return size;
+}
+
+
+template<typename T>
+static inline void append_raw(std::string &buf, char tag, T value)
+{
+    buf.push_back(tag);
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+
+/// @details
+/// Strings are length prefixed, so the keys of several values can be
+/// concatenated without ambiguity.
+void encode_hash_key(std::string &buf, const Variant &value)
+{
+    if(value.isnull())
+    {
+        buf.push_back('N');
+        return;
+    }
+
+    switch(value.datatype())
+    {
+    case DAL_TYPE_INT:
+    case DAL_TYPE_UINT:
+    case DAL_TYPE_CHAR:
+    case DAL_TYPE_UCHAR:
+    case DAL_TYPE_BOOL:
+    case DAL_TYPE_SMALLINT:
+    case DAL_TYPE_USMALLINT:
+    case DAL_TYPE_BIGINT:
+        return append_raw(buf, 'I', value.get<signed long long>());
+    case DAL_TYPE_UBIGINT:
+    {
+        unsigned long long u = value.get<unsigned long long>();
+        if(u <= static_cast<unsigned long long>(std::numeric_limits<signed long long>::max()))
+            return append_raw(buf, 'I', static_cast<signed long long>(u));
+        return append_raw(buf, 'U', u);
+    }
+    case DAL_TYPE_FLOAT:
+    case DAL_TYPE_DOUBLE:
+    {
+        double d = value.get<double>();
+        if(d == std::floor(d) && std::fabs(d) < 9.2e18)
+            return append_raw(buf, 'I', static_cast<signed long long>(d));
+        return append_raw(buf, 'D', d);
+    }
+    default:
+    {
+        size_t len = 0;
+        String s = value.get<String>();
+        const char *p = s.utf8(len);
+        buf.push_back('S');
+        buf.push_back(static_cast<char>(value.datatype()));
+        encode_length(buf, len);
+        buf.append(p, len);
+    }
+    }
+}
+
+
+
+DB_NAMESPACE_END
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
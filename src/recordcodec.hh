@@ -0,0 +1,105 @@
+//
+// recordcodec.hh - Binary record format (internal)
+//
+// Copyright (C)         informave.org
+//   2013,               Daniel Vogelbacher <daniel@vogelbacher.name>
+//
+// BSD License
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the
+// distribution.
+//
+// Neither the name of the copyright holders nor the names of its
+// contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief Binary record format (internal)
+/// @author Daniel Vogelbacher
+/// @since 0.0.1
+
+#ifndef INFORMAVE_DB_RECORDCODEC_HH
+#define INFORMAVE_DB_RECORDCODEC_HH
+
+#include "dbwtl/db_objects.hh"
+
+#include <string>
+
+
+DB_NAMESPACE_BEGIN
+
+
+/// @brief Tag of a NULL value in the binary format
+#define DBWTL_CODEC_NULL 0xFF
+
+
+/// @brief Appends the binary form of value to buf
+/// @details
+/// Each value starts with a tag byte (the daltype_t or DBWTL_CODEC_NULL).
+/// Scalar types follow as raw bytes in native byte order, strings and
+/// BLOBs as a length prefixed byte sequence (UTF-8 for strings). All other
+/// types are stored by their string representation.
+void encode_value(std::string &buf, const Variant &value);
+
+/// @brief Decodes the value at ptr into dest
+/// @return pointer behind the value
+const char* decode_value(const char *ptr, const char *end, Variant &dest);
+
+/// @brief Appends the column count and all values of rec to buf
+void encode_record(std::string &buf, const ShrRecord &rec);
+
+/// @brief Decodes a record written by encode_record()
+/// @return pointer behind the record
+const char* decode_record(const char *ptr, const char *end, ShrRecord &rec);
+
+/// @brief Appends an unsigned integer with a variable length to buf
+void encode_length(std::string &buf, size_t len);
+
+/// @brief Decodes a length written by encode_length()
+const char* decode_length(const char *ptr, const char *end, size_t &len);
+
+/// @brief Appends a normalized key of value to buf, used for hashing
+/// @details
+/// Integral values of all numeric types share one representation,
+/// so INT 1, BIGINT 1 and DOUBLE 1.0 produce the same key. Other types
+/// are keyed by type and string representation.
+void encode_hash_key(std::string &buf, const Variant &value);
+
+/// @brief Returns the approximate number of bytes used by a record in memory
+size_t record_memory_size(const ShrRecord &rec);
+
+
+DB_NAMESPACE_END
+
+#endif
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
@@ -0,0 +1,258 @@
+//
+// recordindex.cc - RecordIndex (definition)
+//
+// Copyright (C)         informave.org
+//   2013,               Daniel Vogelbacher <daniel@vogelbacher.name>
+//
+// BSD License
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the
+// distribution.
+//
+// Neither the name of the copyright holders nor the names of its
+// contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief RecordIndex (definitions)
+/// @author Daniel Vogelbacher
+/// @since 0.0.1
+
+
+#include "dbwtl/dal/dal_fwd.hh"
+#include "dbwtl/db_objects.hh"
+#include "dbwtl/exceptions.hh"
+#include "recordcodec.hh"
+#include "utils.hh"
+
+#include <algorithm>
+
+
+DB_NAMESPACE_BEGIN
+
+
+/// @brief Copies the key columns of rec
+static inline void extract_key(const ShrRecord &rec, const std::vector<colnum_t> &columns,
+                               RecordIndex::key_type &key)
+{
+    key.resize(columns.size());
+    for(size_t i = 0; i < columns.size(); ++i)
+        key[i] = rec[columns[i]-1];
+}
+
+
+/// @details
+/// NULL is less than all other values.
+bool
+RecordIndex::key_less::operator()(const key_type &a, const key_type &b) const
+{
+    const size_t n = std::min(a.size(), b.size());
+    for(size_t i = 0; i < n; ++i)
+    {
+        if(a[i].isnull() || b[i].isnull())
+        {
+            if(a[i].isnull() != b[i].isnull())
+                return a[i].isnull();
+            continue;
+        }
+        int c = VariantExprHelper::compare(a[i], b[i]);
+        if(c != 0)
+            return c < 0;
+    }
+    return false;
+}
+
+
+
+RecordIndex::RecordIndex(RecordIndexType type, const std::vector<colnum_t> &columns)
+    : m_type(type),
+      m_columns(columns),
+      m_hash(),
+      m_tree(),
+      m_rows(0)
+{
+    if(columns.empty())
+        throw EngineException("Index needs at least one column");
+}
+
+
+void
+RecordIndex::add(const ShrRecord &rec, rownum_t row)
+{
+    key_type key;
+    extract_key(rec, this->m_columns, key);
+
+    if(this->m_type == DBWTL_INDEX_HASH)
+    {
+        std::string hkey;
+        for(size_t i = 0; i < key.size(); ++i)
+            encode_hash_key(hkey, key[i]);
+        this->m_hash[hkey].push_back(row);
+    }
+    else
+        this->m_tree.insert(tree_type::value_type(key, row));
+    ++this->m_rows;
+}
+
+
+void
+RecordIndex::clear(void)
+{
+    this->m_hash.clear();
+    this->m_tree.clear();
+    this->m_rows = 0;
+}
+
+
+RecordIndex::rowlist_type
+RecordIndex::find(const key_type &key) const
+{
+    if(this->m_type == DBWTL_INDEX_HASH)
+    {
+        if(key.size() != this->m_columns.size())
+            throw EngineException(FORMAT2("Hash index lookup needs %d key values, got %d",
+                                          this->m_columns.size(), key.size()));
+        std::string hkey;
+        for(size_t i = 0; i < key.size(); ++i)
+            encode_hash_key(hkey, key[i]);
+        hash_type::const_iterator i = this->m_hash.find(hkey);
+        return i != this->m_hash.end() ? i->second : rowlist_type();
+    }
+
+    rowlist_type rows;
+    std::pair<tree_type::const_iterator, tree_type::const_iterator> r = this->m_tree.equal_range(key);
+    for(tree_type::const_iterator i = r.first; i != r.second; ++i)
+        rows.push_back(i->second);
+    // rows with the same prefix but a different full key are in key order
+    if(key.size() < this->m_columns.size())
+        std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+
+RecordIndex::rowlist_type
+RecordIndex::range(const key_type &lower, const key_type &upper) const
+{
+    if(this->m_type != DBWTL_INDEX_ORDERED)
+        throw EngineException("Range lookups require an ordered index");
+
+    tree_type::const_iterator begin = lower.empty() ? this->m_tree.begin() : this->m_tree.lower_bound(lower);
+    tree_type::const_iterator end = upper.empty() ? this->m_tree.end() : this->m_tree.upper_bound(upper);
+
+    rowlist_type rows;
+    for(tree_type::const_iterator i = begin; i != end; ++i)
+        rows.push_back(i->second);
+    return rows;
+}
+
+
+
+void
+RecordSet::createIndex(const String &name, RecordIndexType type,
+                       const std::vector<colnum_t> &columns)
+{
+    for(size_t i = 0; i < columns.size(); ++i)
+    {
+        if(columns[i] < 1 || columns[i] > this->columnCount())
+            throw EngineException(FORMAT1("Column number out of range: %d", columns[i]));
+    }
+
+    RecordIndex index(type, columns);
+    for(rownum_t row = 1; row <= this->rowCount(); ++row)
+        index.add(this->getRecord(row), row);
+
+    std::pair<index_map_type::iterator, bool> r =
+        this->m_indexes.insert(index_map_type::value_type(name.utf8(), index));
+    if(! r.second)
+        throw EngineException(FORMAT1("Index already exists: %s", name));
+}
+
+
+void
+RecordSet::dropIndex(const String &name)
+{
+    if(this->m_indexes.erase(name.utf8()) == 0)
+        throw NotFoundException(FORMAT1("Index not found: %s", name));
+}
+
+
+const RecordIndex&
+RecordSet::getIndex(const String &name) const
+{
+    index_map_type::const_iterator i = this->m_indexes.find(name.utf8());
+    if(i == this->m_indexes.end())
+        throw NotFoundException(FORMAT1("Index not found: %s", name));
+    return i->second;
+}
+
+
+RecordIndex::rowlist_type
+RecordSet::lookup(const String &index, const RecordIndex::key_type &key) const
+{
+    return this->getIndex(index).find(key);
+}
+
+
+RecordIndex::rowlist_type
+RecordSet::lookupRange(const String &index, const RecordIndex::key_type &lower,
+                       const RecordIndex::key_type &upper) const
+{
+    return this->getIndex(index).range(lower, upper);
+}
+
+
+bool
+RecordSet::seek(const String &index, const RecordIndex::key_type &key)
+{
+    RecordIndex::rowlist_type rows = this->lookup(index, key);
+    return ! rows.empty() && this->setpos(rows.front());
+}
+
+
+bool
+RecordSet::seek(const String &index, const Variant &key)
+{
+    return this->seek(index, RecordIndex::key_type(1, key));
+}
+
+
+void
+RecordSet::updateIndexes(const ShrRecord &rec)
+{
+    for(index_map_type::iterator i = this->m_indexes.begin(); i != this->m_indexes.end(); ++i)
+        i->second.add(rec, this->rowCount());
+}
+
+
+DB_NAMESPACE_END
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
@@ -64,8 +64,39 @@ RecordSet::RecordSet(void)
       m_bm_records(),
       m_count(),
       m_cursorstate(DAL_CURSOR_CLOSED),
-      m_cursor(),
-      m_column_descriptors()
+      m_pos(0),
+      m_storage(DBWTL_STORAGE_ROWS),
+      m_column_store(),
+      m_spill_store(),
+      m_snapshot(),
+      m_spill_row(),
+      m_spill_row_pos(size_t(-1)),
+      m_rowbuf(),
+      m_rowbuf_pos(),
+      m_column_descriptors(),
+      m_column_index(),
+      m_indexes()
+{
+}
+
+RecordSet::RecordSet(RecordSetStorage storage)
+    : ScrollableDataset(),
+      m_records(),
+      m_bm_records(),
+      m_count(),
+      m_cursorstate(DAL_CURSOR_CLOSED),
+      m_pos(0),
+      m_storage(storage),
+      m_column_store(),
+      m_spill_store(),
+      m_snapshot(),
+      m_spill_row(),
+      m_spill_row_pos(size_t(-1)),
+      m_rowbuf(),
+      m_rowbuf_pos(),
+      m_column_descriptors(),
+      m_column_index(),
+      m_indexes()
 {
 }
 
@@ -89,6 +120,15 @@ RecordSet::allocRecord(const Bookmark &bm)
 */
 
 
+void
+RecordSet::setStorage(RecordSetStorage storage)
+{
+    if(this->rowCount() > 0)
+        throw EngineException("setStorage() failed, RecordSet is not empty");
+    this->m_storage = storage;
+}
+
+
 void
 RecordSet::open(void)
 {
@@ -112,9 +152,9 @@ RecordSet::first(void)
 
     DAL_SET_CURSORSTATE(this->m_cursorstate, DAL_CURSOR_POSITIONED);
 
-    this->m_cursor = this->rows().begin();
+    this->m_pos = 0;
     
-    if(this->m_cursor == this->rows().end())
+    if(this->m_pos == size_t(this->rowCount()))
     	DAL_SET_CURSORSTATE(this->m_cursorstate, DAL_CURSOR_EOF);
 }
 
@@ -129,8 +169,8 @@ RecordSet::next(void)
 
     if(!eof())
     {
-        ++this->m_cursor;
-        if(this->m_cursor == this->rows().end())
+        ++this->m_pos;
+        if(this->m_pos == size_t(this->rowCount()))
             DAL_SET_CURSORSTATE(this->m_cursorstate, DAL_CURSOR_EOF);
         return !eof();
     }
@@ -145,7 +185,7 @@ RecordSet::next(void)
 bool
 RecordSet::last(void)
 {
-    this->m_cursor = this->end()-1;
+    this->m_pos = this->rowCount()-1;
     return true;
 }
 
@@ -156,9 +196,7 @@ RecordSet::setpos(rownum_t row)
     if(row > rowCount() || row < 1)
         return false;
 
-    RecordSet::iterator i = this->begin();
-    i += row-1;
-    this->m_cursor = i;
+    this->m_pos = row-1;
 	DAL_SET_CURSORSTATE(this->m_cursorstate, DAL_CURSOR_POSITIONED);
     return true;
 }
@@ -167,9 +205,9 @@ bool
 RecordSet::prev(void)
 {
     
-    if(this->m_cursor != this->begin())
+    if(this->m_pos != 0)
     {
-        --this->m_cursor;
+        --this->m_pos;
         return true;
     }
     else
@@ -224,6 +262,12 @@ RecordSet::close(void)
 rowcount_t     
 RecordSet::rowCount(void) const
 {
+    if(this->m_storage == DBWTL_STORAGE_COLUMNS)
+        return this->m_column_store.rowCount();
+    if(this->m_storage == DBWTL_STORAGE_SPILL)
+        return this->m_spill_store.rowCount();
+    if(this->m_storage == DBWTL_STORAGE_SNAPSHOT)
+        return this->m_snapshot.rowCount();
     return this->rows().size();
 }
 
@@ -239,8 +283,41 @@ RecordSet::column(colnum_t num)
     if(num < 1)
     	throw EngineException("RecordSet has no support for bookmark columns");
 
-    assert(this->m_cursor != this->rows().end());
-    return (*m_cursor)[num-1];
+    assert(this->m_pos < size_t(this->rowCount()));
+
+    if(this->m_storage == DBWTL_STORAGE_COLUMNS || this->m_storage == DBWTL_STORAGE_SNAPSHOT)
+    {
+        const bool snapshot = this->m_storage == DBWTL_STORAGE_SNAPSHOT;
+        const size_t ncol = snapshot ? this->m_snapshot.columnCount() : this->m_column_store.columnCount();
+        if(num > ncol)
+            throw NotFoundException(US("Column '") + String::Internal(Variant(int(num)).asStr()) + US("' not found."));
+        if(this->m_rowbuf.size() < ncol)
+        {
+            this->m_rowbuf.resize(ncol);
+            this->m_rowbuf_pos.resize(ncol, size_t(-1));
+        }
+        if(this->m_rowbuf_pos[num-1] != this->m_pos)
+        {
+            if(snapshot)
+                this->m_snapshot.load(this->m_pos, num-1, this->m_rowbuf[num-1]);
+            else
+                this->m_column_store.load(this->m_pos, num-1, this->m_rowbuf[num-1]);
+            this->m_rowbuf_pos[num-1] = this->m_pos;
+        }
+        return this->m_rowbuf[num-1];
+    }
+    if(this->m_storage == DBWTL_STORAGE_SPILL)
+    {
+        if(this->m_spill_row_pos != this->m_pos)
+        {
+            this->m_spill_row = this->m_spill_store.get(this->m_pos);
+            this->m_spill_row_pos = this->m_pos;
+        }
+        const ShrRecord &row = this->m_spill_row;
+        return row[num-1];
+    }
+    const storage_type &records = this->m_records;
+    return records[this->m_pos][num-1];
 }
 
 const IResult::value_type&   
@@ -266,11 +343,11 @@ RecordSet::columnID(String name) const
     if(! this->isOpen())
         throw EngineException("Resultset is not open.");
 
-    for(colnum_t i = 1; i <= this->columnCount(); ++i)
-    {
-        if(name == this->columnName(i))
-            return i;
-    }
+    if(! this->m_column_index.isValid())
+        this->m_column_index.build(*this);
+
+    if(colnum_t num = this->m_column_index.find(name))
+        return num;
     throw NotFoundException(US("Column '") + String::Internal(name) + US("' not found."));
 }
 
@@ -349,6 +426,7 @@ RecordSet::updateDescriptors(void)
 	}
 	// Remove dropped columns if any
 	this->m_column_descriptors.resize(this->m_count);
+	this->m_column_index.clear();
 
 
 }
@@ -358,6 +436,15 @@ void
 RecordSet::clear(void)
 {
 	this->m_records.clear();
+	this->m_column_store.clear();
+	this->m_spill_store.clear();
+	this->m_snapshot.close();
+	this->m_spill_row.clear();
+	this->m_spill_row_pos = size_t(-1);
+	this->m_rowbuf.clear();
+	this->m_rowbuf_pos.clear();
+	for(index_map_type::iterator i = this->m_indexes.begin(); i != this->m_indexes.end(); ++i)
+		i->second.clear();
 	//DAL_SET_CURSORSTATE(this->m_cursorstate, DAL_CURSOR_CLOSED);
 	this->m_cursorstate = DAL_CURSOR_CLOSED;
 }
@@ -368,34 +455,84 @@ RecordSet::reset(void)
 	this->clear();
 	this->m_count = 0;
 	this->m_column_descriptors.clear();
+	this->m_column_index.clear();
+	this->m_indexes.clear();
 }
 
 
 
 void
-RecordSet::insert(const ShrRecord &rec)
+RecordSet::prepareInsert(size_t ncol)
 {
-    if(!this->isOpen())
-        throw EngineException("Insert not possible because RecordSet is not open"); 
+	if(!this->isOpen())
+		throw EngineException("Insert not possible because RecordSet is not open"); 
 
+	if(this->m_storage == DBWTL_STORAGE_SNAPSHOT)
+		throw EngineException("Insert not possible because RecordSet is a read-only snapshot");
 
-	if(!this->m_records.empty() || (this->m_records.empty() && this->m_count > 0))
+	if(this->rowCount() > 0 || this->m_count > 0)
 	{
-		if(this->m_count != rec.size())
+		if(this->m_count != ncol)
 			throw EngineException(FORMAT2("insert() failed, field count mismatch: %d vs. %d",
-				this->m_count, rec.size()));
-		assert(this->m_count == rec.size());
-	        this->m_records.push_back(rec.clone());
+				this->m_count, ncol));
+		assert(this->m_count == ncol);
 	}
 	else
 	{
-		this->m_count = rec.size();
+		this->m_count = ncol;
 		this->updateDescriptors();
-		this->m_records.push_back(rec.clone());
-
 	}
 }
 
+void
+RecordSet::insert(const ShrRecord &rec)
+{
+	this->prepareInsert(rec.size());
+
+	if(this->m_storage == DBWTL_STORAGE_COLUMNS)
+		this->m_column_store.append(rec);
+	else if(this->m_storage == DBWTL_STORAGE_SPILL)
+		this->m_spill_store.append(rec);
+	else
+		this->m_records.push_back(rec);
+	this->updateIndexes(rec);
+}
+
+void
+RecordSet::emplace(ShrRecord &&rec)
+{
+	this->insert(rec);
+}
+
+ShrRecord
+RecordSet::getRecord(rownum_t row) const
+{
+    if(row < 1 || row > this->rowCount())
+        throw EngineException(FORMAT1("getRecord() failed, row %d out of range", row));
+
+    switch(this->m_storage)
+    {
+    case DBWTL_STORAGE_SPILL:
+        return this->m_spill_store.get(row-1);
+    case DBWTL_STORAGE_COLUMNS:
+    {
+        ShrRecord rec(this->m_column_store.columnCount());
+        for(size_t i = 0; i < rec.size(); ++i)
+            this->m_column_store.load(row-1, i, rec[i]);
+        return rec;
+    }
+    case DBWTL_STORAGE_SNAPSHOT:
+    {
+        ShrRecord rec(this->m_snapshot.columnCount());
+        for(size_t i = 0; i < rec.size(); ++i)
+            this->m_snapshot.load(row-1, i, rec[i]);
+        return rec;
+    }
+    default:
+        return this->m_records[row-1];
+    }
+}
+
 void
 RecordSet::modifyColumnDesc(colnum_t num, ColumnDescEntry entry, const IColumnDesc::value_type &v)
 {
@@ -403,6 +540,8 @@ RecordSet::modifyColumnDesc(colnum_t num, ColumnDescEntry entry, const IColumnDe
 		throw EngineException(FORMAT1("Column number out of range: %d", num));
 	assert(num <= this->m_column_descriptors.size());
 	this->m_column_descriptors[num-1].changeEntry(entry, v);
+	if(entry == DBWTL_COLUMNDESC_NAME)
+		this->m_column_index.clear();
 }
 
 void
@@ -0,0 +1,661 @@
+//
+// recordsetops.cc - RecordSetOps (definition)
+//
+// Copyright (C)         informave.org
+//   2013,               Daniel Vogelbacher <daniel@vogelbacher.name>
+//
+// BSD License
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the
+// distribution.
+//
+// Neither the name of the copyright holders nor the names of its
+// contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief RecordSetOps (definitions)
+/// @author Daniel Vogelbacher
+/// @since 0.0.1
+
+
+#include "dbwtl/dal/dal_fwd.hh"
+#include "dbwtl/db_objects.hh"
+#include "dbwtl/exceptions.hh"
+#include "recordcodec.hh"
+#include "utils.hh"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+DB_NAMESPACE_BEGIN
+
+
+/// @brief Returns true for types sorted and summed as signed long long
+static inline bool is_integral(daltype_t type)
+{
+    switch(type)
+    {
+    case DAL_TYPE_INT:
+    case DAL_TYPE_UINT:
+    case DAL_TYPE_CHAR:
+    case DAL_TYPE_UCHAR:
+    case DAL_TYPE_BOOL:
+    case DAL_TYPE_SMALLINT:
+    case DAL_TYPE_USMALLINT:
+    case DAL_TYPE_BIGINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+static inline bool is_real(daltype_t type)
+{
+    return type == DAL_TYPE_FLOAT || type == DAL_TYPE_DOUBLE;
+}
+
+
+static void check_column(const RecordSet &src, colnum_t col)
+{
+    if(col < 1 || col > src.columnCount())
+        throw EngineException(FORMAT1("Column number out of range: %d", col));
+}
+
+
+/// @brief Resets dest and copies the descriptors of the given columns of src
+static void copy_descriptors(const RecordSet &src, const std::vector<colnum_t> &columns,
+                             size_t extra, RecordSet &dest)
+{
+    dest.reset();
+    dest.setColumnCount(columns.size() + extra);
+    for(size_t i = 0; i < columns.size(); ++i)
+    {
+        const IColumnDesc &desc = src.describeColumn(columns[i]);
+        dest.modifyColumnDesc(i+1, DBWTL_COLUMNDESC_NAME, desc.getName());
+        dest.setDatatype(i+1, desc.getDatatype());
+    }
+}
+
+
+/// @brief Resets dest and copies all descriptors of src
+static void copy_descriptors(const RecordSet &src, RecordSet &dest)
+{
+    std::vector<colnum_t> columns;
+    for(colnum_t i = 1; i <= src.columnCount(); ++i)
+        columns.push_back(i);
+    copy_descriptors(src, columns, 0, dest);
+    dest.open();
+}
+
+
+
+/// Minimum number of rows per worker thread
+#define PARALLEL_MIN_ROWS 1024
+
+
+/// @brief Returns the number of threads used for rows, threads = 0
+/// selects one thread per core
+static size_t worker_count(const RecordSet &src, size_t threads, size_t rows)
+{
+    if(src.getStorage() == DBWTL_STORAGE_SPILL)
+        return 1; // pages are loaded on access
+    if(threads == 0)
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    return std::max<size_t>(std::min(threads, rows / PARALLEL_MIN_ROWS), 1);
+}
+
+
+/// @brief Returns the bounds of parts equally sized parts of [0, rows)
+static std::vector<size_t> split_rows(size_t rows, size_t parts)
+{
+    std::vector<size_t> bounds(parts + 1);
+    for(size_t i = 0; i <= parts; ++i)
+        bounds[i] = rows * i / parts;
+    return bounds;
+}
+
+
+/// @brief Calls fn(i) for i = 0..count-1, each call in its own thread
+/// @details
+/// The first call runs in the calling thread. All threads are joined
+/// before the first exception thrown by a call is rethrown.
+template<typename F>
+static void run_tasks(size_t count, F fn)
+{
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> workers;
+
+    auto task = [&fn, &errors](size_t i)
+    {
+        try
+        {
+            fn(i);
+        }
+        catch(...)
+        {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    try
+    {
+        for(size_t i = 1; i < count; ++i)
+            workers.push_back(std::thread(task, i));
+    }
+    catch(...)
+    {
+        for(size_t i = 0; i < workers.size(); ++i)
+            workers[i].join();
+        throw;
+    }
+    if(count > 0)
+        task(0);
+    for(size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+
+    for(size_t i = 0; i < count; ++i)
+    {
+        if(errors[i])
+            std::rethrow_exception(errors[i]);
+    }
+}
+
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////////// sort_column
+///
+/// @since 0.0.1
+/// @brief Sort key values of one column, extracted once before sorting
+///
+/// The values are stored in the narrowest array that covers all non-NULL
+/// values of the column. Columns with mixed types keep the Variants.
+struct sort_column
+{
+    enum kind_type { KIND_INTEGER, KIND_REAL, KIND_TEXT, KIND_VARIANT };
+
+    /// Selects the array type for the values, load() fills it
+    sort_column(const std::vector<Variant> &values, bool desc)
+        : kind(KIND_INTEGER),
+          descending(desc),
+          nulls(values.size()),
+          ints(),
+          reals(),
+          texts(),
+          variants()
+    {
+        bool integral = true, real = true, text = true;
+        for(size_t i = 0; i < values.size(); ++i)
+        {
+            if(values[i].isnull())
+                continue;
+            daltype_t type = values[i].datatype();
+            integral = integral && is_integral(type);
+            real = real && (is_integral(type) || is_real(type));
+            text = text && type == DAL_TYPE_STRING;
+        }
+
+        if(integral)
+            this->kind = KIND_INTEGER, this->ints.resize(values.size());
+        else if(real)
+            this->kind = KIND_REAL, this->reals.resize(values.size());
+        else if(text)
+            this->kind = KIND_TEXT, this->texts.resize(values.size());
+        else
+            this->kind = KIND_VARIANT, this->variants.resize(values.size());
+    }
+
+    /// Converts the values of rows [begin, end)
+    void load(const std::vector<Variant> &values, size_t begin, size_t end)
+    {
+        for(size_t i = begin; i < end; ++i)
+        {
+            this->nulls[i] = values[i].isnull();
+            if(this->nulls[i])
+                continue;
+            switch(this->kind)
+            {
+            case KIND_INTEGER:  this->ints[i] = values[i].get<signed long long>(); break;
+            case KIND_REAL:     this->reals[i] = values[i].get<double>(); break;
+            case KIND_TEXT:     this->texts[i] = values[i].get<String>().utf8(); break;
+            case KIND_VARIANT:  this->variants[i] = values[i]; break;
+            }
+        }
+    }
+
+    /// Three-way comparison of the values of rows a and b (0-based)
+    inline int compare(size_t a, size_t b) const
+    {
+        int c;
+        if(this->nulls[a] || this->nulls[b])
+            c = this->nulls[b] - this->nulls[a];
+        else
+        {
+            switch(this->kind)
+            {
+            case KIND_INTEGER:
+                c = this->ints[a] < this->ints[b] ? -1 : this->ints[b] < this->ints[a];
+                break;
+            case KIND_REAL:
+                c = this->reals[a] < this->reals[b] ? -1 : this->reals[b] < this->reals[a];
+                break;
+            case KIND_TEXT:
+                c = this->texts[a].compare(this->texts[b]);
+                break;
+            default:
+                c = VariantExprHelper::compare(this->variants[a], this->variants[b]);
+            }
+        }
+        return this->descending ? -c : c;
+    }
+
+    kind_type                       kind;
+    bool                            descending;
+    std::vector<char>               nulls;
+    std::vector<signed long long>   ints;
+    std::vector<double>             reals;
+    std::vector<std::string>        texts;
+    std::vector<Variant>            variants;
+};
+
+
+struct sort_less
+{
+    sort_less(const std::vector<sort_column> &cols)
+        : columns(cols)
+    {}
+
+    inline bool operator()(rownum_t a, rownum_t b) const
+    {
+        for(size_t i = 0; i < this->columns.size(); ++i)
+        {
+            int c = this->columns[i].compare(a-1, b-1);
+            if(c != 0)
+                return c < 0;
+        }
+        return false;
+    }
+
+    const std::vector<sort_column> &columns;
+};
+
+
+
+//..............................................................................
+////////////////////////////////////////////////////////////// aggregate_state
+///
+/// @since 0.0.1
+/// @brief Running state of one aggregate in one group
+struct aggregate_state
+{
+    aggregate_state(void)
+        : count(0), integral(true), isum(0), dsum(0), min(), max()
+    {}
+
+    void add(const Variant &value)
+    {
+        ++this->count;
+        if(this->integral && is_integral(value.datatype()))
+            this->isum += value.get<signed long long>();
+        else
+        {
+            if(this->integral)
+            {
+                this->dsum = double(this->isum);
+                this->integral = false;
+            }
+            this->dsum += value.get<double>();
+        }
+        if(this->min.isnull() || VariantExprHelper::compare(value, this->min) < 0)
+            this->min = value;
+        if(this->max.isnull() || VariantExprHelper::compare(value, this->max) > 0)
+            this->max = value;
+    }
+
+    /// Adds the state of another part of the same group
+    void merge(const aggregate_state &other)
+    {
+        if(other.count == 0)
+            return;
+        this->count += other.count;
+        if(this->integral && other.integral)
+            this->isum += other.isum;
+        else
+        {
+            if(this->integral)
+                this->dsum = double(this->isum);
+            this->dsum += other.integral ? double(other.isum) : other.dsum;
+            this->integral = false;
+        }
+        if(this->min.isnull() || (!other.min.isnull() && VariantExprHelper::compare(other.min, this->min) < 0))
+            this->min = other.min;
+        if(this->max.isnull() || (!other.max.isnull() && VariantExprHelper::compare(other.max, this->max) > 0))
+            this->max = other.max;
+    }
+
+    signed long long   count;
+    bool               integral;
+    signed long long   isum;
+    double             dsum;
+    Variant            min;
+    Variant            max;
+};
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////////// group_table
+///
+/// @since 0.0.1
+/// @brief Groups and aggregate states of a part of the rows
+///
+/// Groups are kept in the order of their first row.
+struct group_table
+{
+    typedef std::unordered_map<std::string, size_t> map_type;
+
+    /// Returns the states of the group with the hash key hkey,
+    /// a new group takes its key values from rec
+    std::vector<aggregate_state>& get(const std::string &hkey, const ShrRecord &rec,
+                                      const std::vector<colnum_t> &columns, size_t naggs)
+    {
+        std::pair<map_type::iterator, bool> g = this->map.insert(map_type::value_type(hkey, this->keys.size()));
+        if(g.second)
+        {
+            ShrRecord key(columns.size());
+            for(size_t k = 0; k < columns.size(); ++k)
+                key[k] = rec[columns[k]-1];
+            this->hkeys.push_back(hkey);
+            this->keys.push_back(key);
+            this->states.push_back(std::vector<aggregate_state>(naggs));
+        }
+        return this->states[g.first->second];
+    }
+
+    /// Adds the groups of a table built from later rows
+    void merge(const group_table &other)
+    {
+        for(size_t g = 0; g < other.keys.size(); ++g)
+        {
+            std::pair<map_type::iterator, bool> r =
+                this->map.insert(map_type::value_type(other.hkeys[g], this->keys.size()));
+            if(r.second)
+            {
+                this->hkeys.push_back(other.hkeys[g]);
+                this->keys.push_back(other.keys[g]);
+                this->states.push_back(other.states[g]);
+            }
+            else
+            {
+                std::vector<aggregate_state> &state = this->states[r.first->second];
+                for(size_t a = 0; a < state.size(); ++a)
+                    state[a].merge(other.states[g][a]);
+            }
+        }
+    }
+
+    map_type                                    map;
+    std::vector<std::string>                    hkeys;
+    std::vector<ShrRecord>                      keys;
+    std::vector< std::vector<aggregate_state> > states;
+};
+
+
+/// @brief Adds the rows [begin, end) (0-based) of src to table
+static void accumulate(const RecordSet &src, const std::vector<colnum_t> &keys,
+                       const std::vector<RecordAggregate> &aggregates,
+                       size_t begin, size_t end, group_table &table)
+{
+    std::string hkey;
+    for(size_t r = begin; r < end; ++r)
+    {
+        const ShrRecord rec = src.getRecord(r+1);
+
+        hkey.clear();
+        for(size_t k = 0; k < keys.size(); ++k)
+            encode_hash_key(hkey, rec[keys[k]-1]);
+
+        std::vector<aggregate_state> &state = table.get(hkey, rec, keys, aggregates.size());
+        for(size_t a = 0; a < aggregates.size(); ++a)
+        {
+            if(aggregates[a].column == 0)
+                ++state[a].count;
+            else if(! rec[aggregates[a].column-1].isnull())
+                state[a].add(rec[aggregates[a].column-1]);
+        }
+    }
+}
+
+
+static String default_name(const RecordSet &src, const RecordAggregate &agg)
+{
+    static const char *names[] = { "COUNT", "SUM", "MIN", "MAX", "AVG" };
+    String column = agg.column ? src.columnName(agg.column) : String("*");
+    return String(names[agg.type]) + String("(") + column + String(")");
+}
+
+
+
+/// @details
+/// The key values are extracted and converted in parallel. Each thread
+/// sorts a part of the row numbers, the sorted parts are merged pairwise
+/// in parallel rounds. std::merge() prefers the left part on equal keys,
+/// so the result is the same stable order as with one thread.
+void
+RecordSetOps::sortRows(const RecordSet &src, const std::vector<RecordSortKey> &keys,
+                       rowlist_type &order, size_t threads)
+{
+    const size_t rows = src.rowCount();
+    const size_t parts = worker_count(src, threads, rows);
+    const std::vector<size_t> bounds = split_rows(rows, parts);
+
+    for(size_t k = 0; k < keys.size(); ++k)
+        check_column(src, keys[k].column);
+
+    std::vector< std::vector<Variant> > values(keys.size(), std::vector<Variant>(rows));
+    run_tasks(parts, [&](size_t p)
+    {
+        for(size_t r = bounds[p]; r < bounds[p+1]; ++r)
+        {
+            const ShrRecord rec = src.getRecord(r+1);
+            for(size_t k = 0; k < keys.size(); ++k)
+                values[k][r] = rec[keys[k].column-1];
+        }
+    });
+
+    std::vector<sort_column> columns;
+    columns.reserve(keys.size());
+    for(size_t k = 0; k < keys.size(); ++k)
+        columns.push_back(sort_column(values[k], keys[k].descending));
+    run_tasks(parts, [&](size_t p)
+    {
+        for(size_t k = 0; k < keys.size(); ++k)
+            columns[k].load(values[k], bounds[p], bounds[p+1]);
+    });
+    values.clear();
+
+    const sort_less less(columns);
+    order.resize(rows);
+    for(size_t r = 0; r < rows; ++r)
+        order[r] = r+1;
+    run_tasks(parts, [&](size_t p)
+    {
+        std::stable_sort(order.begin() + bounds[p], order.begin() + bounds[p+1], less);
+    });
+
+    std::vector<size_t> runs(bounds);
+    rowlist_type buffer(rows);
+    while(runs.size() > 2)
+    {
+        const size_t pairs = (runs.size() - 1) / 2;
+        run_tasks(pairs, [&](size_t i)
+        {
+            std::merge(order.begin() + runs[2*i], order.begin() + runs[2*i+1],
+                       order.begin() + runs[2*i+1], order.begin() + runs[2*i+2],
+                       buffer.begin() + runs[2*i], less);
+        });
+        // an odd run at the end is moved unchanged
+        if((runs.size() - 1) % 2)
+            std::copy(order.begin() + runs[runs.size()-2], order.end(),
+                      buffer.begin() + runs[runs.size()-2]);
+        order.swap(buffer);
+
+        std::vector<size_t> next;
+        for(size_t i = 0; i < runs.size(); i += 2)
+            next.push_back(runs[i]);
+        if(next.back() != rows)
+            next.push_back(rows);
+        runs.swap(next);
+    }
+}
+
+
+void
+RecordSetOps::sort(const RecordSet &src, const std::vector<RecordSortKey> &keys,
+                   RecordSet &dest, size_t threads)
+{
+    rowlist_type order;
+    sortRows(src, keys, order, threads);
+    select(src, order, dest);
+}
+
+
+void
+RecordSetOps::select(const RecordSet &src, const rowlist_type &rows, RecordSet &dest)
+{
+    copy_descriptors(src, dest);
+    for(size_t i = 0; i < rows.size(); ++i)
+        dest.insert(src.getRecord(rows[i]));
+}
+
+
+void
+RecordSetOps::filter(RecordSet &src, const DatasetFilter &filter, RecordSet &dest)
+{
+    copy_descriptors(src, dest);
+    rownum_t row = 1;
+    for(src.first(); !src.eof(); src.next(), ++row)
+    {
+        if(filter(src))
+            dest.insert(src.getRecord(row));
+    }
+}
+
+
+/// @details
+/// The groups are found through a hash table on the normalized key
+/// values, so numbers of different types with the same value fall
+/// into the same group. Each thread fills its own table, the tables
+/// are merged in row order, so the order of the groups does not depend
+/// on the number of threads.
+void
+RecordSetOps::groupBy(const RecordSet &src, const std::vector<colnum_t> &keys,
+                      const std::vector<RecordAggregate> &aggregates, RecordSet &dest,
+                      size_t threads)
+{
+    for(size_t k = 0; k < keys.size(); ++k)
+        check_column(src, keys[k]);
+    for(size_t a = 0; a < aggregates.size(); ++a)
+    {
+        if(aggregates[a].column != 0 || aggregates[a].type != DBWTL_AGGREGATE_COUNT)
+            check_column(src, aggregates[a].column);
+    }
+
+    const size_t rows = src.rowCount();
+    const size_t parts = worker_count(src, threads, rows);
+    const std::vector<size_t> bounds = split_rows(rows, parts);
+
+    std::vector<group_table> tables(parts);
+    run_tasks(parts, [&](size_t p)
+    {
+        accumulate(src, keys, aggregates, bounds[p], bounds[p+1], tables[p]);
+    });
+    group_table &groups = tables[0];
+    for(size_t p = 1; p < parts; ++p)
+        groups.merge(tables[p]);
+
+    copy_descriptors(src, keys, aggregates.size(), dest);
+    for(size_t a = 0; a < aggregates.size(); ++a)
+    {
+        const RecordAggregate &agg = aggregates[a];
+        const colnum_t num = keys.size() + a + 1;
+        daltype_t source_type = agg.column ? src.describeColumn(agg.column).getDatatype() : DAL_TYPE_UNKNOWN;
+        daltype_t type = DAL_TYPE_DOUBLE;
+        if(agg.type == DBWTL_AGGREGATE_COUNT)
+            type = DAL_TYPE_BIGINT;
+        else if(agg.type == DBWTL_AGGREGATE_SUM && is_integral(source_type))
+            type = DAL_TYPE_BIGINT;
+        else if(agg.type == DBWTL_AGGREGATE_MIN || agg.type == DBWTL_AGGREGATE_MAX)
+            type = source_type;
+
+        dest.modifyColumnDesc(num, DBWTL_COLUMNDESC_NAME, agg.name.empty() ? default_name(src, agg) : agg.name);
+        dest.setDatatype(num, type);
+    }
+    dest.open();
+
+    for(size_t g = 0; g < groups.keys.size(); ++g)
+    {
+        ShrRecord rec(keys.size() + aggregates.size());
+        for(size_t k = 0; k < keys.size(); ++k)
+            rec[k] = groups.keys[g][k];
+
+        for(size_t a = 0; a < aggregates.size(); ++a)
+        {
+            const aggregate_state &s = groups.states[g][a];
+            Variant &v = rec[keys.size() + a];
+            if(aggregates[a].type == DBWTL_AGGREGATE_COUNT)
+                v = Variant(s.count);
+            else if(s.count == 0)
+                continue;
+            else if(aggregates[a].type == DBWTL_AGGREGATE_SUM)
+                v = s.integral ? Variant(s.isum) : Variant(s.dsum);
+            else if(aggregates[a].type == DBWTL_AGGREGATE_AVG)
+                v = Variant((s.integral ? double(s.isum) : s.dsum) / s.count);
+            else if(aggregates[a].type == DBWTL_AGGREGATE_MIN)
+                v = s.min;
+            else
+                v = s.max;
+        }
+        dest.emplace(std::move(rec));
+    }
+}
+
+
+DB_NAMESPACE_END
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
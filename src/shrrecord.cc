@@ -97,6 +97,7 @@ Variant&
 ShrRecord::operator[](size_t index)
 {
 	assert(this->m_data);
+    this->detach();
     return this->m_data->at(index);
 }
 
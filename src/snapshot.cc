@@ -0,0 +1,660 @@
+//
+// snapshot.cc - RecordSet snapshots (definition)
+//
+// Copyright (C)         informave.org
+//   2013,               Daniel Vogelbacher <daniel@vogelbacher.name>
+//
+// BSD License
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the
+// distribution.
+//
+// Neither the name of the copyright holders nor the names of its
+// contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief RecordSet snapshots (definitions)
+/// @author Daniel Vogelbacher
+/// @since 0.0.1
+
+
+#include "dbwtl/dal/dal_fwd.hh"
+#include "dbwtl/db_objects.hh"
+#include "dbwtl/exceptions.hh"
+#include "dal/dal_debug.hh"
+#include "recordcodec.hh"
+#include "utils.hh"
+
+#include <cstring>
+#include <memory>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef DBWTL_ON_UNIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+DB_NAMESPACE_BEGIN
+
+
+#define SNAPSHOT_MAGIC "DBWTLSN1"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTEORDER 0x01020304
+
+
+/// File header, followed by one snapshot_column per column
+struct snapshot_header
+{
+    char                 magic[8];
+    unsigned int         byteorder;
+    unsigned int         version;
+    unsigned long long   rows;
+    unsigned long long   columns;
+    unsigned long long   meta_offset;    ///< column names and types
+    unsigned long long   meta_length;
+};
+
+
+/// Directory entry of a column, offsets are relative to the file start
+struct snapshot_column
+{
+    unsigned int         fixed_type;     ///< DAL_TYPE_UNKNOWN for encoded values
+    unsigned int         reserved;
+    unsigned long long   nulls_offset;
+    unsigned long long   data_offset;
+    unsigned long long   data_length;
+};
+
+
+
+//..............................................................................
+/////////////////////////////////////////////////////////////////// snapshot_map
+///
+/// @since 0.0.1
+/// @brief Read-only mapping of a snapshot file
+///
+/// Platforms without mmap() read the whole file into memory.
+struct snapshot_map
+{
+    snapshot_map(const std::string &path)
+        : data(0), size(0)
+#ifdef DBWTL_ON_UNIX
+        , addr(MAP_FAILED)
+#else
+        , buf()
+#endif
+    {
+#ifdef DBWTL_ON_UNIX
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            throw EngineException(FORMAT1("Can't open snapshot file: %s", String(path)));
+        struct stat st;
+        if(::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw EngineException(FORMAT1("Can't open snapshot file: %s", String(path)));
+        }
+        this->size = st.st_size;
+        if(this->size > 0)
+            this->addr = ::mmap(0, this->size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(this->size > 0 && this->addr == MAP_FAILED)
+            throw EngineException(FORMAT1("Can't map snapshot file: %s", String(path)));
+        this->data = static_cast<const char*>(this->addr);
+#else
+        std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+        if(! in)
+            throw EngineException(FORMAT1("Can't open snapshot file: %s", String(path)));
+        this->buf.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        this->data = this->buf.data();
+        this->size = this->buf.size();
+#endif
+    }
+
+    ~snapshot_map(void)
+    {
+#ifdef DBWTL_ON_UNIX
+        if(this->addr != MAP_FAILED)
+            ::munmap(this->addr, this->size);
+#endif
+    }
+
+    const char   *data;
+    size_t        size;
+
+private:
+#ifdef DBWTL_ON_UNIX
+    void         *addr;
+#else
+    std::string   buf;
+#endif
+
+    snapshot_map(const snapshot_map&);
+    snapshot_map& operator=(const snapshot_map&);
+};
+
+
+
+/// @brief Returns the size of a scalar type stored as native array,
+/// 0 if values of the type are stored encoded
+static size_t fixed_size(daltype_t type)
+{
+    switch(type)
+    {
+    case DAL_TYPE_INT:          return sizeof(signed int);
+    case DAL_TYPE_UINT:         return sizeof(unsigned int);
+    case DAL_TYPE_CHAR:         return sizeof(signed char);
+    case DAL_TYPE_UCHAR:        return sizeof(unsigned char);
+    case DAL_TYPE_BOOL:         return sizeof(bool);
+    case DAL_TYPE_SMALLINT:     return sizeof(signed short);
+    case DAL_TYPE_USMALLINT:    return sizeof(unsigned short);
+    case DAL_TYPE_BIGINT:       return sizeof(signed long long);
+    case DAL_TYPE_UBIGINT:      return sizeof(unsigned long long);
+    case DAL_TYPE_FLOAT:        return sizeof(float);
+    case DAL_TYPE_DOUBLE:       return sizeof(double);
+    default:                    return 0;
+    }
+}
+
+
+template<typename T>
+static inline void get_fixed(const char *ptr, Variant &dest)
+{
+    T v;
+    std::memcpy(&v, ptr, sizeof(T));
+    dest = Variant(v);
+}
+
+
+template<typename T>
+static inline void put_fixed(std::string &buf, const Variant &value)
+{
+    T v = value.isnull() ? T() : value.get<T>();
+    buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+
+/// @brief Appends value as stored in a column of the given fixed type
+/// @details
+/// For DAL_TYPE_UNKNOWN the encoded value is appended, nothing for NULL.
+static void put_value(std::string &buf, daltype_t type, const Variant &value)
+{
+    switch(type)
+    {
+    case DAL_TYPE_INT:          return put_fixed<signed int>(buf, value);
+    case DAL_TYPE_UINT:         return put_fixed<unsigned int>(buf, value);
+    case DAL_TYPE_CHAR:         return put_fixed<signed char>(buf, value);
+    case DAL_TYPE_UCHAR:        return put_fixed<unsigned char>(buf, value);
+    case DAL_TYPE_BOOL:         return put_fixed<bool>(buf, value);
+    case DAL_TYPE_SMALLINT:     return put_fixed<signed short>(buf, value);
+    case DAL_TYPE_USMALLINT:    return put_fixed<unsigned short>(buf, value);
+    case DAL_TYPE_BIGINT:       return put_fixed<signed long long>(buf, value);
+    case DAL_TYPE_UBIGINT:      return put_fixed<unsigned long long>(buf, value);
+    case DAL_TYPE_FLOAT:        return put_fixed<float>(buf, value);
+    case DAL_TYPE_DOUBLE:       return put_fixed<double>(buf, value);
+    default:
+        if(! value.isnull())
+            encode_value(buf, value);
+    }
+}
+
+
+/// @brief Returns offset rounded up to a multiple of 8
+static inline unsigned long long aligned(unsigned long long offset)
+{
+    return (offset + 7) / 8 * 8;
+}
+
+
+/// @brief Checks that [offset, offset+length) lies in the file
+static inline const char* file_range(const snapshot_map &map, unsigned long long offset,
+                                     unsigned long long length)
+{
+    if(offset > map.size || length > map.size - offset)
+        throw EngineException("Corrupt snapshot file: section out of range");
+    return map.data + offset;
+}
+
+
+
+//..............................................................................
+///////////////////////////////////////////////////////////////// snapshot_writer
+///
+/// @since 0.0.1
+/// @brief Sequential writer for snapshot files
+///
+/// Keeps track of the file offset, so the sections can be checked
+/// against the layout computed before writing.
+struct snapshot_writer
+{
+    snapshot_writer(const std::string &path)
+        : file(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc),
+          pos(0)
+    {
+        if(! this->file)
+            throw EngineException(FORMAT1("Can't create snapshot file: %s", String(path)));
+    }
+
+    inline void write(const char *ptr, size_t len)
+    {
+        this->file.write(ptr, len);
+        this->pos += len;
+    }
+
+    template<typename T>
+    inline void write_pod(const T &value)
+    {
+        this->write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /// Pads with zero bytes up to offset
+    inline void pad(unsigned long long offset)
+    {
+        static const char zeros[8] = { 0 };
+        DBWTL_BUGCHECK_EX(offset >= this->pos && offset - this->pos < sizeof(zeros),
+                          "snapshot section overlaps the previous one");
+        this->write(zeros, offset - this->pos);
+    }
+
+    std::ofstream        file;
+    unsigned long long   pos;
+};
+
+
+
+SnapshotStore::SnapshotStore(void)
+    : m_map(),
+      m_columns(),
+      m_rows(0)
+{}
+
+
+SnapshotStore::SnapshotStore(const SnapshotStore &other)
+    : m_map(other.m_map),
+      m_columns(other.m_columns),
+      m_rows(other.m_rows)
+{}
+
+
+SnapshotStore::~SnapshotStore(void)
+{
+    this->close();
+}
+
+
+SnapshotStore&
+SnapshotStore::operator=(const SnapshotStore &other)
+{
+    this->m_map = other.m_map;
+    this->m_columns = other.m_columns;
+    this->m_rows = other.m_rows;
+    return *this;
+}
+
+
+/// @details
+/// Only the header, the column directory and the column names are read,
+/// the data sections are accessed on demand.
+void
+SnapshotStore::open(const std::string &path)
+{
+    this->close();
+
+    std::shared_ptr<snapshot_map> map(new snapshot_map(path));
+
+    snapshot_header header;
+    std::memcpy(&header, file_range(*map, 0, sizeof(header)), sizeof(header));
+    if(std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0)
+        throw EngineException(FORMAT1("Not a snapshot file: %s", String(path)));
+    if(header.byteorder != SNAPSHOT_BYTEORDER)
+        throw EngineException(FORMAT1("Snapshot file has a different byte order: %s", String(path)));
+    if(header.version != SNAPSHOT_VERSION)
+        throw EngineException(FORMAT1("Unsupported snapshot version: %d", header.version));
+
+    const char *dir = file_range(*map, sizeof(header), header.columns * sizeof(snapshot_column));
+    const char *meta = file_range(*map, header.meta_offset, header.meta_length);
+    const char *meta_end = meta + header.meta_length;
+    const size_t bitmap_size = (header.rows + 7) / 8;
+
+    std::vector<column_info> columns(header.columns);
+    for(size_t i = 0; i < columns.size(); ++i)
+    {
+        snapshot_column entry;
+        std::memcpy(&entry, dir + i * sizeof(entry), sizeof(entry));
+
+        size_t len = 0;
+        meta = decode_length(meta, meta_end, len);
+        if(size_t(meta_end - meta) < len + 1)
+            throw EngineException("Corrupt snapshot file: invalid column names");
+        columns[i].name.loadUTF8(meta, len);
+        columns[i].desc_type = daltype_t(static_cast<unsigned char>(meta[len]));
+        meta += len + 1;
+
+        columns[i].fixed_type = daltype_t(entry.fixed_type);
+        columns[i].nulls = file_range(*map, entry.nulls_offset, bitmap_size);
+        columns[i].data = file_range(*map, entry.data_offset, entry.data_length);
+        columns[i].length = entry.data_length;
+
+        size_t width = fixed_size(columns[i].fixed_type);
+        if(width ? entry.data_length < header.rows * width
+           : entry.data_length < (header.rows + 1) * sizeof(unsigned long long))
+            throw EngineException("Corrupt snapshot file: column data too short");
+    }
+
+    this->m_columns.swap(columns);
+    this->m_rows = header.rows;
+    this->m_map = map;
+}
+
+
+void
+SnapshotStore::close(void)
+{
+    this->m_map.reset();
+    this->m_columns.clear();
+    this->m_rows = 0;
+}
+
+
+const String&
+SnapshotStore::columnName(size_t col) const
+{
+    return this->m_columns.at(col).name;
+}
+
+
+daltype_t
+SnapshotStore::columnType(size_t col) const
+{
+    return this->m_columns.at(col).desc_type;
+}
+
+
+bool
+SnapshotStore::isnull(size_t row, size_t col) const
+{
+    const column_info &c = this->m_columns.at(col);
+    return c.nulls[row / 8] & (1 << (row % 8));
+}
+
+
+/// @details
+/// Scalar values are copied from the native array, encoded values
+/// are decoded from the mapping.
+void
+SnapshotStore::load(size_t row, size_t col, Variant &dest) const
+{
+    DBWTL_BUGCHECK_EX(row < this->m_rows, "snapshot row out of range");
+
+    if(this->isnull(row, col))
+    {
+        dest.setNull();
+        return;
+    }
+
+    const column_info &c = this->m_columns[col];
+    const char *ptr = c.data + row * fixed_size(c.fixed_type);
+
+    switch(c.fixed_type)
+    {
+    case DAL_TYPE_INT:          return get_fixed<signed int>(ptr, dest);
+    case DAL_TYPE_UINT:         return get_fixed<unsigned int>(ptr, dest);
+    case DAL_TYPE_CHAR:         return get_fixed<signed char>(ptr, dest);
+    case DAL_TYPE_UCHAR:        return get_fixed<unsigned char>(ptr, dest);
+    case DAL_TYPE_BOOL:         return get_fixed<bool>(ptr, dest);
+    case DAL_TYPE_SMALLINT:     return get_fixed<signed short>(ptr, dest);
+    case DAL_TYPE_USMALLINT:    return get_fixed<unsigned short>(ptr, dest);
+    case DAL_TYPE_BIGINT:       return get_fixed<signed long long>(ptr, dest);
+    case DAL_TYPE_UBIGINT:      return get_fixed<unsigned long long>(ptr, dest);
+    case DAL_TYPE_FLOAT:        return get_fixed<float>(ptr, dest);
+    case DAL_TYPE_DOUBLE:       return get_fixed<double>(ptr, dest);
+    default:
+        break;
+    }
+
+    unsigned long long offsets[2];
+    std::memcpy(offsets, c.data + row * sizeof(offsets[0]), sizeof(offsets));
+    const char *values = c.data + (this->m_rows + 1) * sizeof(offsets[0]);
+    const char *end = c.data + c.length;
+    if(offsets[0] > offsets[1] || offsets[1] > size_t(end - values))
+        throw EngineException("Corrupt snapshot file: invalid value offset");
+    decode_value(values + offsets[0], values + offsets[1], dest);
+}
+
+
+
+/// @details
+/// A column is stored as native array if all non-null values have the
+/// same scalar type, otherwise the values are stored encoded.
+/// The offsets of all sections are computed first, then the file is
+/// written sequentially, column by column. Column and snapshot storage
+/// are read by cell. Reading a spilled row loads its page from disk,
+/// so spill storage is read once row by row into per column buffers.
+void
+RecordSet::saveSnapshot(const std::string &path) const
+{
+    const size_t rows = this->rowCount();
+    const size_t ncol = this->columnCount();
+    const size_t bitmap_size = (rows + 7) / 8;
+
+    std::vector<daltype_t> types(ncol, DAL_TYPE_UNKNOWN);
+    std::vector<bool> mixed(ncol, false);
+    std::vector<std::string> nulls(ncol, std::string(bitmap_size, '\0'));
+    for(size_t r = 1; r <= rows; ++r)
+    {
+        const ShrRecord rec = this->getRecord(r);
+        for(size_t i = 0; i < ncol; ++i)
+        {
+            if(rec[i].isnull())
+            {
+                nulls[i][(r-1) / 8] |= char(1 << ((r-1) % 8));
+                continue;
+            }
+            if(mixed[i])
+                continue;
+            daltype_t t = rec[i].datatype();
+            if(types[i] == DAL_TYPE_UNKNOWN)
+                types[i] = t;
+            else if(types[i] != t)
+                mixed[i] = true;
+        }
+    }
+    bool encoded = false;
+    for(size_t i = 0; i < ncol; ++i)
+    {
+        if(mixed[i] || ! fixed_size(types[i]))
+        {
+            types[i] = DAL_TYPE_UNKNOWN;
+            encoded = true;
+        }
+    }
+
+    // offset table of each encoded column, the last entry is the
+    // length of the encoded values
+    const bool spill = this->m_storage == DBWTL_STORAGE_SPILL;
+    std::vector<std::string> spill_data(spill ? ncol : 0);
+    std::vector<std::vector<unsigned long long> > offsets(ncol);
+    std::string buf;
+    for(size_t i = 0; i < ncol; ++i)
+    {
+        if(types[i] == DAL_TYPE_UNKNOWN)
+        {
+            offsets[i].reserve(rows + 1);
+            offsets[i].push_back(0);
+        }
+    }
+    for(size_t r = 1; (encoded || spill) && r <= rows; ++r)
+    {
+        const ShrRecord rec = this->getRecord(r);
+        for(size_t i = 0; i < ncol; ++i)
+        {
+            std::string &dest = spill ? spill_data[i] : buf;
+            const size_t start = spill ? dest.size() : 0;
+            if(! spill)
+            {
+                if(types[i] != DAL_TYPE_UNKNOWN)
+                    continue;
+                buf.clear();
+            }
+            put_value(dest, types[i], rec[i]);
+            if(types[i] == DAL_TYPE_UNKNOWN)
+                offsets[i].push_back(offsets[i].back() + dest.size() - start);
+        }
+    }
+
+    std::string meta;
+    for(size_t i = 0; i < ncol; ++i)
+    {
+        const IColumnDesc &desc = this->describeColumn(i+1);
+        size_t len = 0;
+        String name = desc.getName().asStr();
+        const char *p = name.utf8(len);
+        encode_length(meta, len);
+        meta.append(p, len);
+        meta.push_back(static_cast<char>(desc.getDatatype()));
+    }
+
+    // layout: header, directory, names, then nulls and data of each column
+    snapshot_header header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.byteorder = SNAPSHOT_BYTEORDER;
+    header.version = SNAPSHOT_VERSION;
+    header.rows = rows;
+    header.columns = ncol;
+    header.meta_offset = sizeof(header) + ncol * sizeof(snapshot_column);
+    header.meta_length = meta.size();
+
+    std::vector<snapshot_column> dir(ncol);
+    unsigned long long end = header.meta_offset + header.meta_length;
+    for(size_t i = 0; i < ncol; ++i)
+    {
+        dir[i].fixed_type = types[i];
+        dir[i].reserved = 0;
+        dir[i].nulls_offset = aligned(end);
+        dir[i].data_offset = aligned(dir[i].nulls_offset + bitmap_size);
+        if(types[i] == DAL_TYPE_UNKNOWN)
+            dir[i].data_length = offsets[i].size() * sizeof(unsigned long long) + offsets[i].back();
+        else
+            dir[i].data_length = rows * fixed_size(types[i]);
+        end = dir[i].data_offset + dir[i].data_length;
+    }
+
+    snapshot_writer out(path);
+    out.write_pod(header);
+    if(ncol > 0)
+        out.write(reinterpret_cast<const char*>(&dir[0]), ncol * sizeof(snapshot_column));
+    out.write(meta.data(), meta.size());
+
+    Variant tmp;
+    for(size_t i = 0; i < ncol; ++i)
+    {
+        out.pad(dir[i].nulls_offset);
+        out.write(nulls[i].data(), nulls[i].size());
+        std::string().swap(nulls[i]);
+
+        out.pad(dir[i].data_offset);
+        if(types[i] == DAL_TYPE_UNKNOWN)
+        {
+            out.write(reinterpret_cast<const char*>(&offsets[i][0]),
+                      offsets[i].size() * sizeof(unsigned long long));
+            std::vector<unsigned long long>().swap(offsets[i]);
+        }
+
+        if(spill)
+        {
+            out.write(spill_data[i].data(), spill_data[i].size());
+            std::string().swap(spill_data[i]);
+        }
+        for(size_t r = 1; ! spill && r <= rows; ++r)
+        {
+            buf.clear();
+            switch(this->m_storage)
+            {
+            case DBWTL_STORAGE_COLUMNS:
+                this->m_column_store.load(r-1, i, tmp);
+                put_value(buf, types[i], tmp);
+                break;
+            case DBWTL_STORAGE_SNAPSHOT:
+                this->m_snapshot.load(r-1, i, tmp);
+                put_value(buf, types[i], tmp);
+                break;
+            default:
+                {
+                    const ShrRecord rec = this->getRecord(r);
+                    put_value(buf, types[i], rec[i]);
+                }
+            }
+            out.write(buf.data(), buf.size());
+        }
+        DBWTL_BUGCHECK_EX(out.pos == dir[i].data_offset + dir[i].data_length,
+                          "snapshot column size differs from the computed layout");
+    }
+
+    out.file.close();
+    if(! out.file)
+        throw EngineException(FORMAT1("Writing snapshot file failed: %s", String(path)));
+}
+
+
+/// @details
+/// The column descriptors are restored from the snapshot, values are
+/// read from the mapped file on access.
+void
+RecordSet::loadSnapshot(const std::string &path)
+{
+    if(this->rowCount() > 0)
+        throw EngineException("loadSnapshot() failed, RecordSet is not empty");
+
+    this->reset();
+    this->m_snapshot.open(path);
+    this->m_storage = DBWTL_STORAGE_SNAPSHOT;
+
+    this->setColumnCount(this->m_snapshot.columnCount());
+    for(size_t i = 0; i < this->m_snapshot.columnCount(); ++i)
+    {
+        this->modifyColumnDesc(i+1, DBWTL_COLUMNDESC_NAME, this->m_snapshot.columnName(i));
+        this->setDatatype(i+1, this->m_snapshot.columnType(i));
+    }
+    this->open();
+}
+
+
+DB_NAMESPACE_END
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
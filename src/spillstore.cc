@@ -0,0 +1,370 @@
+//
+// spillstore.cc - SpillStore (definition)
+//
+// Copyright (C)         informave.org
+//   2013,               Daniel Vogelbacher <daniel@vogelbacher.name>
+//
+// BSD License
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the
+// distribution.
+//
+// Neither the name of the copyright holders nor the names of its
+// contributors may be used to endorse or promote products derived
+// from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/// @file
+/// @brief SpillStore (definitions)
+/// @author Daniel Vogelbacher
+/// @since 0.0.1
+
+
+#include "dbwtl/dal/dal_fwd.hh"
+#include "dbwtl/db_objects.hh"
+#include "dbwtl/exceptions.hh"
+#include "dal/dal_debug.hh"
+#include "recordcodec.hh"
+#include "utils.hh"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+DB_NAMESPACE_BEGIN
+
+
+#define SPILL_PAGE_ROWS 512
+#define SPILL_MEMORY_LIMIT (64 * 1024 * 1024)
+#define SPILL_NPOS (static_cast<unsigned long long>(-1))
+
+
+#if defined(_WIN32)
+#define spill_seek _fseeki64
+#define spill_tell _ftelli64
+#else
+#define spill_seek fseeko
+#define spill_tell ftello
+#endif
+
+
+//..............................................................................
+///////////////////////////////////////////////////////////////////// spill_page
+///
+/// @since 0.0.1
+/// @brief A page of rows
+///
+/// offset is SPILL_NPOS until the page is written to the file.
+struct spill_page
+{
+    spill_page(void) : rows(), bytes(0), offset(SPILL_NPOS), length(0), used(0), resident(true)
+    {}
+
+    std::vector<ShrRecord>  rows;
+    size_t                  bytes;
+    unsigned long long      offset;
+    size_t                  length;
+    size_t                  used;
+    bool                    resident;
+};
+
+
+
+//..............................................................................
+///////////////////////////////////////////////////////////////////// spill_file
+///
+/// @since 0.0.1
+/// @brief Temporary file for released pages, removed on close
+struct spill_file
+{
+    spill_file(void) : fp(std::tmpfile()), size(0)
+    {
+        if(! this->fp)
+            throw EngineException("SpillStore: can't create temporary file");
+    }
+
+    ~spill_file(void)
+    {
+        std::fclose(this->fp);
+    }
+
+    /// @brief Appends data, returns the offset
+    unsigned long long write(const std::string &data)
+    {
+        unsigned long long offset = this->size;
+        if(spill_seek(this->fp, offset, SEEK_SET) != 0 ||
+           std::fwrite(data.data(), 1, data.size(), this->fp) != data.size())
+            throw EngineException("SpillStore: writing temporary file failed");
+        this->size += data.size();
+        return offset;
+    }
+
+    void read(unsigned long long offset, size_t length, std::string &data)
+    {
+        data.resize(length);
+        if(spill_seek(this->fp, offset, SEEK_SET) != 0 ||
+           std::fread(&data[0], 1, length, this->fp) != length)
+            throw EngineException("SpillStore: reading temporary file failed");
+    }
+
+    std::FILE           *fp;
+    unsigned long long   size;
+
+private:
+    spill_file(const spill_file&);
+    spill_file& operator=(const spill_file&);
+};
+
+
+
+SpillStore::SpillStore(void)
+    : m_pages(),
+      m_file(0),
+      m_rows(0),
+      m_page_rows(SPILL_PAGE_ROWS),
+      m_memory_limit(SPILL_MEMORY_LIMIT),
+      m_resident_bytes(0),
+      m_clock(0)
+{}
+
+
+SpillStore::SpillStore(const SpillStore &orig)
+    : m_pages(),
+      m_file(0),
+      m_rows(0),
+      m_page_rows(orig.m_page_rows),
+      m_memory_limit(orig.m_memory_limit),
+      m_resident_bytes(0),
+      m_clock(0)
+{
+    for(size_t i = 0; i < orig.rowCount(); ++i)
+        this->append(orig.get(i));
+}
+
+
+SpillStore&
+SpillStore::operator=(const SpillStore &orig)
+{
+    if(this != &orig)
+    {
+        this->clear();
+        this->m_page_rows = orig.m_page_rows;
+        this->m_memory_limit = orig.m_memory_limit;
+        for(size_t i = 0; i < orig.rowCount(); ++i)
+            this->append(orig.get(i));
+    }
+    return *this;
+}
+
+
+SpillStore::~SpillStore(void)
+{
+    this->clear();
+}
+
+
+void
+SpillStore::setMemoryLimit(size_t bytes)
+{
+    this->m_memory_limit = bytes;
+    if(! this->m_pages.empty())
+        this->evict(this->m_pages.back());
+}
+
+
+void
+SpillStore::setPageSize(size_t rows)
+{
+    if(rows == 0)
+        throw EngineException("setPageSize() failed, page size must be greater than 0");
+    if(this->m_rows > 0)
+        throw EngineException("setPageSize() failed, SpillStore is not empty");
+    this->m_page_rows = rows;
+}
+
+
+/// @details
+/// 
+void
+SpillStore::append(const ShrRecord &rec)
+{
+    if(this->m_pages.empty() || this->m_pages.back()->rows.size() == this->m_page_rows)
+    {
+        this->m_pages.push_back(new spill_page());
+        this->m_pages.back()->rows.reserve(this->m_page_rows);
+    }
+
+    spill_page &page = *this->m_pages.back();
+    size_t bytes = record_memory_size(rec);
+    page.rows.push_back(rec);
+    page.bytes += bytes;
+    this->m_resident_bytes += bytes;
+    ++this->m_rows;
+
+    this->touch(page);
+    if(this->m_resident_bytes > this->m_memory_limit)
+        this->evict(&page);
+}
+
+
+/// @details
+/// 
+ShrRecord
+SpillStore::get(size_t row) const
+{
+    if(row >= this->m_rows)
+        throw EngineException(FORMAT1("SpillStore: row %d out of range", row));
+
+    spill_page &page = *this->m_pages[row / this->m_page_rows];
+    if(! page.resident)
+    {
+        this->load(page);
+        this->touch(page);
+        this->evict(&page);
+    }
+    else
+        this->touch(page);
+
+    return page.rows[row % this->m_page_rows];
+}
+
+
+void
+SpillStore::clear(void)
+{
+    for(std::vector<spill_page*>::iterator i = this->m_pages.begin();
+        i != this->m_pages.end();
+        ++i)
+    {
+        delete *i;
+    }
+    this->m_pages.clear();
+    delete this->m_file;
+    this->m_file = 0;
+    this->m_rows = 0;
+    this->m_resident_bytes = 0;
+    this->m_clock = 0;
+}
+
+
+size_t
+SpillStore::residentPages(void) const
+{
+    size_t n = 0;
+    for(size_t i = 0; i < this->m_pages.size(); ++i)
+        if(this->m_pages[i]->resident)
+            ++n;
+    return n;
+}
+
+
+size_t
+SpillStore::spilledPages(void) const
+{
+    size_t n = 0;
+    for(size_t i = 0; i < this->m_pages.size(); ++i)
+        if(this->m_pages[i]->offset != SPILL_NPOS)
+            ++n;
+    return n;
+}
+
+
+void
+SpillStore::touch(spill_page &page) const
+{
+    page.used = ++this->m_clock;
+}
+
+
+/// @details
+/// Releases the least recently used pages until the memory limit
+/// is satisfied. The last page and keep are never released.
+void
+SpillStore::evict(const spill_page *keep) const
+{
+    while(this->m_resident_bytes > this->m_memory_limit)
+    {
+        spill_page *victim = 0;
+        for(size_t i = 0; i + 1 < this->m_pages.size(); ++i)
+        {
+            spill_page *p = this->m_pages[i];
+            if(p->resident && p != keep && (!victim || p->used < victim->used))
+                victim = p;
+        }
+        if(! victim)
+            return;
+
+        if(victim->offset == SPILL_NPOS)
+        {
+            std::string data;
+            for(size_t i = 0; i < victim->rows.size(); ++i)
+                encode_record(data, victim->rows[i]);
+            if(! this->m_file)
+                this->m_file = new spill_file();
+            victim->offset = this->m_file->write(data);
+            victim->length = data.size();
+        }
+
+        std::vector<ShrRecord>().swap(victim->rows);
+        victim->resident = false;
+        this->m_resident_bytes -= victim->bytes;
+    }
+}
+
+
+/// @details
+/// 
+void
+SpillStore::load(spill_page &page) const
+{
+    DBWTL_BUGCHECK_EX(page.offset != SPILL_NPOS && this->m_file, "page not spilled");
+
+    std::string data;
+    this->m_file->read(page.offset, page.length, data);
+
+    const char *ptr = data.data();
+    const char *end = ptr + data.size();
+    page.rows.reserve(this->m_page_rows);
+    while(ptr != end)
+    {
+        ShrRecord rec;
+        ptr = decode_record(ptr, end, rec);
+        page.rows.push_back(rec);
+    }
+    page.resident = true;
+    this->m_resident_bytes += page.bytes;
+}
+
+
+DB_NAMESPACE_END
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
@@ -125,6 +125,17 @@ Blob::rdbuf(void) const
 }
 
 
+/// @details
+/// Measured by moving the put position to the end of the buffer,
+/// which is where further writes append anyway.
+size_t
+Blob::size(void) const
+{
+    std::streamoff off = this->m_data.rdbuf()->pubseekoff(0, std::ios_base::end, std::ios_base::out);
+    return off > 0 ? size_t(off) : 0;
+}
+
+
 
 
 ///
@@ -52,6 +52,7 @@
 #include <iostream>
 #include <algorithm>
 #include <sstream>
+#include <stdexcept>
 #include <typeinfo>
 
 DB_NAMESPACE_BEGIN
@@ -73,6 +74,30 @@ sv_accessor<TNumeric>::cast(bool*, std::locale loc) const
 }
 
 
+/// 
+signed long long
+sv_accessor<TNumeric>::cast(signed long long*, std::locale loc) const
+{
+    try
+    {
+        return this->get_value().asLongLong();
+    }
+    catch(std::out_of_range &e)
+    {
+        internal_helper__throw_ConvertException(DAL_TYPE_NUMERIC, DAL_TYPE_BIGINT, e.what());
+        throw;
+    }
+}
+
+
+/// 
+double
+sv_accessor<TNumeric>::cast(double*, std::locale loc) const
+{
+    return this->get_value().asDouble();
+}
+
+
 /*
 /// 
 TDate
@@ -196,5 +196,18 @@ sv_accessor<String>::cast(Memo*, std::locale loc) const
 }
 
 
+/// @details
+/// The view points to the UTF-8 buffer of the String, which is the
+/// original data for strings loaded from UTF-8.
+bool
+sv_accessor<String>::get_utf8_view(utf8_view &view) const
+{
+    size_t len = 0;
+    const char *s = this->get_value().utf8(len);
+    view = utf8_view(s, len);
+    return true;
+}
+
+
 
 DB_NAMESPACE_END
@@ -57,8 +57,11 @@
 #include <unicode/ustring.h>
 //#endif
 
+#include <algorithm>
 #include <iostream>
 #include <map>
+#include <mutex>
+#include <vector>
 
 namespace informave
 {
@@ -69,38 +72,198 @@ namespace informave
 
 
 
-typedef std::map<std::string, UConverter*> converter_map_type;
+//..............................................................................
+/////////////////////////////////////////////////////////////// charset_registry
+///
+/// @since 0.0.1
+/// @brief Process wide table of interned charset names
+class charset_registry
+{
+public:
+    static charset_registry& instance(void)
+    {
+        static charset_registry reg;
+        return reg;
+    }
 
-#ifdef _WIN32
-__declspec( thread ) converter_map_type *converterMap = 0;
-#else
- __thread converter_map_type *converterMap = 0;
-#endif
+    ustring_icu::charset_id_t intern(const std::string &charset)
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        std::map<std::string, ustring_icu::charset_id_t>::iterator i = this->m_ids.find(charset);
+        if(i != this->m_ids.end())
+            return i->second;
+        this->m_names.push_back(charset);
+        ustring_icu::charset_id_t id = static_cast<ustring_icu::charset_id_t>(this->m_names.size());
+        this->m_ids.insert(std::make_pair(charset, id));
+        return id;
+    }
 
+    /// Returns the charset name for an id returned by intern()
+    std::string name(ustring_icu::charset_id_t id)
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        assert(id > 0 && id <= this->m_names.size());
+        return this->m_names[id - 1];
+    }
 
+private:
+    charset_registry(void) : m_mutex(), m_ids(), m_names() {}
 
-size_t
-ustring_icu::from_wide(char *cdest, size_t cdestbuf,
-                       const UCharT *wsrc, size_t wlen,
-                       const std::string &charset) const
+    std::mutex m_mutex;
+    std::map<std::string, ustring_icu::charset_id_t> m_ids;
+    std::vector<std::string> m_names;
+};
+
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////// converter_cache
+///
+/// @since 0.0.1
+/// @brief Fixed size LRU cache of ICU converters for one thread
+/// @details
+/// Slots are keyed by the interned charset id, so a hit only compares
+/// integers and requires no allocation or lock. Misses look up the
+/// charset name, open the converter and replace the least recently
+/// used slot. All converters are closed when the thread exits.
+class converter_cache
 {
-    if(!converterMap)
-        converterMap = new converter_map_type();
+public:
+    struct slot
+    {
+        slot(void) : id(0), conv(0), used(0)
+        {}
+
+        ustring_icu::charset_id_t  id;
+        UConverter                *conv;
+        unsigned long              used;
+    };
+
+    converter_cache(void) : m_slots(), m_tick(0)
+    {}
 
-    converter_map_type::iterator p = converterMap->find(std::string(charset));
-    if(p == converterMap->end())
+    ~converter_cache(void)
     {
+        for(size_t i = 0; i < USTRING_CONVERTER_CACHE_SIZE; ++i)
+        {
+            if(this->m_slots[i].conv)
+                ::ucnv_close(this->m_slots[i].conv);
+        }
+    }
+
+    /// Returns the converter for charset, opens it on a miss
+    UConverter* get(ustring_icu::charset_id_t charset)
+    {
+        slot *victim = &this->m_slots[0];
+        for(size_t i = 0; i < USTRING_CONVERTER_CACHE_SIZE; ++i)
+        {
+            slot &sl = this->m_slots[i];
+            if(sl.conv && sl.id == charset)
+            {
+                sl.used = ++this->m_tick;
+                return sl.conv;
+            }
+            if(!sl.conv || (victim->conv && sl.used < victim->used))
+                victim = &sl;
+        }
+
         UErrorCode errcode = U_ZERO_ERROR;
-        UConverter *conv = ::ucnv_open(charset.c_str(), &errcode);
-		if(! U_SUCCESS(errcode))
-		{
-			throw ConversionError();
-		}
-		(*converterMap)[charset] = conv;
-		p = converterMap->find(charset);
+        UConverter *conv = ::ucnv_open(charset_registry::instance().name(charset).c_str(),
+                                       &errcode);
+        if(! U_SUCCESS(errcode))
+        {
+            throw ConversionError();
+        }
+
+        if(victim->conv)
+            ::ucnv_close(victim->conv);
+        victim->conv = conv;
+        victim->id = charset;
+        victim->used = ++this->m_tick;
+        return conv;
     }
 
-    UConverter *conv = p->second;
+private:
+    slot          m_slots[USTRING_CONVERTER_CACHE_SIZE];
+    unsigned long m_tick;
+
+    converter_cache(const converter_cache&);
+    converter_cache& operator=(const converter_cache&);
+};
+
+
+static thread_local converter_cache threadConverters;
+
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////// charset_id_cache
+///
+/// @since 0.0.1
+/// @brief Recently interned charset names of one thread
+/// @details
+/// Conversions intern the charset name for every value. A hit compares
+/// the name with a few cached names and requires no allocation or lock,
+/// only a miss goes to the charset_registry.
+class charset_id_cache
+{
+public:
+    charset_id_cache(void) : m_names(), m_ids(), m_next(0)
+    {
+        std::fill(this->m_ids, this->m_ids + USTRING_CONVERTER_CACHE_SIZE, 0);
+    }
+
+    ustring_icu::charset_id_t get(const std::string &charset)
+    {
+        for(size_t i = 0; i < USTRING_CONVERTER_CACHE_SIZE; ++i)
+        {
+            if(this->m_ids[i] && this->m_names[i] == charset)
+                return this->m_ids[i];
+        }
+        ustring_icu::charset_id_t id = charset_registry::instance().intern(charset);
+        this->m_names[this->m_next] = charset;
+        this->m_ids[this->m_next] = id;
+        this->m_next = (this->m_next + 1) % USTRING_CONVERTER_CACHE_SIZE;
+        return id;
+    }
+
+private:
+    std::string                m_names[USTRING_CONVERTER_CACHE_SIZE];
+    ustring_icu::charset_id_t  m_ids[USTRING_CONVERTER_CACHE_SIZE];
+    size_t                     m_next;
+
+    charset_id_cache(const charset_id_cache&);
+    charset_id_cache& operator=(const charset_id_cache&);
+};
+
+
+static thread_local charset_id_cache threadCharsetIds;
+
+
+
+ustring_icu::charset_id_t
+ustring_icu::intern_charset(const std::string &charset)
+{
+    return threadCharsetIds.get(charset);
+}
+
+
+ustring_icu::charset_id_t
+ustring_icu::prepare_converter(const std::string &charset)
+{
+    charset_id_t id = threadCharsetIds.get(charset);
+    threadConverters.get(id);
+    return id;
+}
+
+
+
+size_t
+ustring_icu::from_wide(char *cdest, size_t cdestbuf,
+                       const UCharT *wsrc, size_t wlen,
+                       charset_id_t charset) const
+{
+    UConverter *conv = threadConverters.get(charset);
     UErrorCode errcode = U_ZERO_ERROR;
 
     int32_t c = ::ucnv_fromUChars(conv,
@@ -118,25 +281,9 @@ ustring_icu::from_wide(char *cdest, size_t cdestbuf,
 size_t
 ustring_icu::to_wide(UCharT *wdest, size_t wbuflen,
                      const char *csrc, size_t clen,
-                     const std::string &charset) const
+                     charset_id_t charset) const
 {
-    if(!converterMap)
-        converterMap = new converter_map_type();
-
-    converter_map_type::iterator p = converterMap->find(charset);
-    if(p == converterMap->end())
-    {
-        UErrorCode errcode = U_ZERO_ERROR;
-        UConverter *conv = ::ucnv_open(charset.c_str(), &errcode);
-		if(! U_SUCCESS(errcode))
-		{
-			throw ConversionError();
-		}
-		(*converterMap)[std::string(charset)] = conv;
-		p = converterMap->find(charset);
-    }
-
-    UConverter *conv = p->second;
+    UConverter *conv = threadConverters.get(charset);
     UErrorCode errcode = U_ZERO_ERROR;
 
     int32_t c = ::ucnv_toUChars(conv,
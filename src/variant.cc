@@ -53,6 +53,8 @@
 #include <sstream>
 #include <typeinfo>
 #include <locale>
+#include <cassert>
+#include <new>
 
 
 DB_NAMESPACE_BEGIN
@@ -62,6 +64,151 @@ DB_NAMESPACE_BEGIN
 
 
 
+//..............................................................................
+//////////////////////////////////////////////////////////////////////// Variant
+
+//..............................................................................
+///////////////////////////////////////////////////////////////// inline values
+
+static_assert(sizeof(TTimestamp) <= DBWTL_VARIANT_INLINE_SIZE,
+              "DBWTL_VARIANT_INLINE_SIZE is too small for TTimestamp");
+
+// Inline values are never destructed, so all of them must be trivial.
+static_assert(std::is_trivially_destructible<TDate>::value
+              && std::is_trivially_destructible<TTime>::value
+              && std::is_trivially_destructible<TTimestamp>::value,
+              "Inline types must be trivially destructible");
+
+
+/// @details
+/// Calls Op<T>::apply() with T set to the C++ type of the inline
+/// daltype.
+template<template<typename> class Op, typename R, typename A1, typename A2>
+static inline R dispatch_inline(daltype_t type, A1 a1, A2 a2)
+{
+    switch(type)
+    {
+    case DAL_TYPE_INT:        return Op<signed int>::apply(a1, a2);
+    case DAL_TYPE_UINT:       return Op<unsigned int>::apply(a1, a2);
+    case DAL_TYPE_CHAR:       return Op<signed char>::apply(a1, a2);
+    case DAL_TYPE_UCHAR:      return Op<unsigned char>::apply(a1, a2);
+    case DAL_TYPE_BOOL:       return Op<bool>::apply(a1, a2);
+    case DAL_TYPE_SMALLINT:   return Op<signed short>::apply(a1, a2);
+    case DAL_TYPE_USMALLINT:  return Op<unsigned short>::apply(a1, a2);
+    case DAL_TYPE_BIGINT:     return Op<signed long long>::apply(a1, a2);
+    case DAL_TYPE_UBIGINT:    return Op<unsigned long long>::apply(a1, a2);
+    case DAL_TYPE_FLOAT:      return Op<float>::apply(a1, a2);
+    case DAL_TYPE_DOUBLE:     return Op<double>::apply(a1, a2);
+    case DAL_TYPE_DATE:       return Op<TDate>::apply(a1, a2);
+    case DAL_TYPE_TIME:       return Op<TTime>::apply(a1, a2);
+    case DAL_TYPE_TIMESTAMP:  return Op<TTimestamp>::apply(a1, a2);
+    default:
+        DBWTL_BUG_EX("dispatch_inline(): Given type is not an inline type");
+    }
+}
+
+
+/// Constructs a const_ptr_value<T> accessor in the given buffer
+template<typename T>
+struct inline_make_accessor
+{
+    static_assert(sizeof(const_ptr_value<T>) <= DBWTL_VARIANT_ACCESSOR_SIZE,
+                  "DBWTL_VARIANT_ACCESSOR_SIZE is too small");
+
+    static IVariantValue* apply(void *buf, const void *value)
+    {
+        return new (buf) const_ptr_value<T>(static_cast<const T*>(value));
+    }
+};
+
+
+/// Creates a heap allocated value store for the inline value
+template<typename T>
+struct inline_make_storage
+{
+    static IVariantValue* apply(const void *value, int)
+    {
+        return new typename value_traits<T>::stored_type(*static_cast<const T*>(value));
+    }
+};
+
+
+/// Copies an inline value to another inline buffer
+template<typename T>
+struct inline_copy
+{
+    static bool apply(void *dest, const void *src)
+    {
+        new (dest) T(*static_cast<const T*>(src));
+        return true;
+    }
+};
+
+
+/// Converts a value store into an inline value of type T
+template<typename T>
+struct inline_convert
+{
+    static bool apply(void *dest, const Variant *src)
+    {
+        new (dest) T(src->get<T>());
+        return true;
+    }
+};
+
+
+/// @details
+/// 
+static inline bool is_inline_type(daltype_t type)
+{
+    switch(type)
+    {
+    case DAL_TYPE_INT:
+    case DAL_TYPE_UINT:
+    case DAL_TYPE_CHAR:
+    case DAL_TYPE_UCHAR:
+    case DAL_TYPE_BOOL:
+    case DAL_TYPE_SMALLINT:
+    case DAL_TYPE_USMALLINT:
+    case DAL_TYPE_BIGINT:
+    case DAL_TYPE_UBIGINT:
+    case DAL_TYPE_FLOAT:
+    case DAL_TYPE_DOUBLE:
+    case DAL_TYPE_DATE:
+    case DAL_TYPE_TIME:
+    case DAL_TYPE_TIMESTAMP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+//..............................................................................
+//////////////////////////////////////////////////////////////// inline_accessor
+
+/// @details
+/// 
+inline_accessor::inline_accessor(const Variant &var)
+    : m_buf(),
+      m_value(0)
+{
+    assert(var.is_inline());
+    this->m_value = dispatch_inline<inline_make_accessor, IVariantValue*>(var.datatype(),
+                                                                         static_cast<void*>(this->m_buf.raw),
+                                                                         var.inline_ptr());
+}
+
+
+/// @details
+/// 
+inline_accessor::~inline_accessor(void)
+{
+    this->m_value->~IVariantValue();
+}
+
+
+
 //..............................................................................
 //////////////////////////////////////////////////////////////////////// Variant
 
@@ -70,6 +217,8 @@ DB_NAMESPACE_BEGIN
 const char*
 Variant::get_typename(void) const
 {
+    if(this->is_inline())
+        return inline_accessor(*this).get()->get_typename();
     return this->get_storage()->get_typename();
 }
 
@@ -79,6 +228,7 @@ void
 Variant::replace_storage(IVariantValue* value)
 {
     this->m_storage.reset(value);
+    this->m_inline_type = DAL_TYPE_UNKNOWN;
 }
 
 
@@ -87,7 +237,9 @@ Variant::replace_storage(IVariantValue* value)
 IVariantValue*
 Variant::clone(void) const
 {
-    if(this->m_storage.get())
+    if(this->is_inline())
+        return this->new_inline_storage();
+    else if(this->m_storage.get())
         return this->get_storage()->clone();
     else
         return 0;
@@ -101,7 +253,9 @@ Variant::clone(void) const
 daltype_t 
 Variant::datatype(void) const
 {
-    if(this->m_storage.get())
+    if(this->is_inline())
+        return this->m_inline_type;
+    else if(this->m_storage.get())
         return this->get_storage()->datatype();
     else
         return this->m_type_ifnull;
@@ -112,31 +266,83 @@ Variant::datatype(void) const
 bool
 Variant::isnull(void) const
 {
+    if(this->is_inline())
+        return false;
     return (this->m_storage.get() == 0 || this->m_storage->isNull());
 }
 
 
 /// @details
-/// 
+/// Inline values are copied directly. Value stores for an inline type
+/// (e.g. a column of a resultset) are converted to an inline value, so
+/// copying a record from a resultset requires no heap allocations for
+/// scalar types.
 void
 Variant::assign(const Variant& value)
 {
+    if(this == &value)
+        return;
+
     if(!value.isnull())
     {
-        this->m_storage.reset(value.get_storage()->deepcopy());        
+        if(value.is_inline() || is_inline_type(value.datatype()))
+        {
+            this->assign_inline(value);
+        }
+        else
+        {
+            this->m_storage.reset(value.get_storage()->deepcopy());
+            this->m_inline_type = DAL_TYPE_UNKNOWN;
+        }
     }
     else
     {
         this->m_storage.reset(0);
+        this->m_inline_type = DAL_TYPE_UNKNOWN;
+    }
+}
+
+
+/// @details
+/// 
+void
+Variant::assign_inline(const Variant& value)
+{
+    const daltype_t type = value.datatype();
 
+    if(value.is_inline())
+    {
+        dispatch_inline<inline_copy, bool>(type, static_cast<void*>(this->m_inline.raw),
+                                           value.inline_ptr());
+    }
+    else
+    {
+        dispatch_inline<inline_convert, bool>(type, static_cast<void*>(this->m_inline.raw),
+                                              &value);
     }
+    this->m_storage.reset(0);
+    this->m_inline_type = type;
+}
+
+
+/// @details
+/// 
+IVariantValue*
+Variant::new_inline_storage(void) const
+{
+    return dispatch_inline<inline_make_storage, IVariantValue*>(this->m_inline_type,
+                                                                this->inline_ptr(), 0);
 }
 
 
 /// @details
 /// 
 void
-Variant::setNull(void) { this->m_storage.reset(0); }
+Variant::setNull(void)
+{
+    this->m_storage.reset(0);
+    this->m_inline_type = DAL_TYPE_UNKNOWN;
+}
 
 
 /// @details
@@ -144,16 +350,23 @@ Variant::setNull(void) { this->m_storage.reset(0); }
 IVariantValue*
 Variant::get_storage(void)
 {
+    if(this->is_inline())
+    {
+        this->m_storage.reset(this->new_inline_storage());
+        this->m_inline_type = DAL_TYPE_UNKNOWN;
+    }
     if(this->m_storage.get() == 0) throw db::NullException(*this);
     return this->m_storage.get();
 }
 
 
 /// @details
-/// 
+/// A const Variant is never modified, so inline values can't be moved
+/// to the heap here. Callers dispatch them through inline_accessor.
 const IVariantValue*
 Variant::get_storage(void) const
 {
+    DBWTL_BUGCHECK_EX(! this->is_inline(), "get_storage() const called on an inline value");
     if(this->m_storage.get() == 0) throw db::NullException(*this);
     return this->m_storage.get();
 }
@@ -191,6 +404,21 @@ Variant::asStr(std::locale loc) const
     return this->get<String>(loc);
 }
 
+
+/// @details
+/// Inline values are never text, so only the value store is asked.
+bool
+Variant::get_utf8_view(utf8_view &view) const
+{
+    if(this->isnull())
+        throw db::NullException(*this);
+    if(this->is_inline())
+        return false;
+    if(const supports_utf8_view *a = dynamic_cast<const supports_utf8_view*>(this->get_storage()))
+        return a->get_utf8_view(view);
+    return false;
+}
+
 bool
 Variant::asBool(void) const
 {
@@ -403,18 +631,22 @@ void throw_convert_error(daltype_t src, daltype_t dest)
 Variant::Variant(const signed long int &value)
         : m_storage(),
                 m_name_ptr(0),
-                m_type_ifnull(DAL_TYPE_UNKNOWN)
+                m_type_ifnull(DAL_TYPE_UNKNOWN),
+                m_inline(),
+                m_inline_type(DAL_TYPE_UNKNOWN)
         {
-                this->m_storage.reset(new value_traits<signed int>::stored_type(value));
+                this->init_value<signed int>(value, std::true_type());
         }
 
 
 Variant::Variant(const unsigned long int &value)
         : m_storage(),
                 m_name_ptr(0),
-                m_type_ifnull(DAL_TYPE_UNKNOWN)
+                m_type_ifnull(DAL_TYPE_UNKNOWN),
+                m_inline(),
+                m_inline_type(DAL_TYPE_UNKNOWN)
         {
-                this->m_storage.reset(new value_traits<unsigned int>::stored_type(value));
+                this->init_value<unsigned int>(value, std::true_type());
         }
 
 
@@ -86,9 +86,7 @@ struct binary_op : public BinaryOperatorVariant
     virtual Variant binary_xor           (const Variant &v0, const Variant &v1) const { return v0.get<bool>() ^ v1.get<bool>(); }
     virtual Variant binary_or            (const Variant &v0, const Variant &v1) const { return v0.get<bool>() || v1.get<bool>(); }
     virtual Variant binary_and           (const Variant &v0, const Variant &v1) const { return v0.get<bool>() && v1.get<bool>(); }
-    virtual Variant binary_mod           (const Variant &v0, const Variant &v1) const { return v0.get<T>() % v1.get<T>(); }
     virtual Variant binary_mul           (const Variant &v0, const Variant &v1) const { return v0.get<T>() * v1.get<T>(); }
-    virtual Variant binary_div           (const Variant &v0, const Variant &v1) const { return v0.get<T>() / v1.get<T>(); }
     virtual Variant binary_add           (const Variant &v0, const Variant &v1) const { return v0.get<T>() + v1.get<T>(); }
     virtual Variant binary_concat        (const Variant &v0, const Variant &v1) const { return v0.get<String>() + v1.get<String>(); }
     virtual Variant binary_sub           (const Variant &v0, const Variant &v1) const { return v0.get<T>() - v1.get<T>(); }
@@ -99,6 +97,18 @@ struct binary_op : public BinaryOperatorVariant
     virtual Variant binary_greater       (const Variant &v0, const Variant &v1) const { return v0.get<T>() > v1.get<T>(); }
     virtual Variant binary_greater_equal (const Variant &v0, const Variant &v1) const { return v0.get<T>() >= v1.get<T>(); }
 
+    /// Division and modulo by zero are NULL, like in SQL
+    virtual Variant binary_mod           (const Variant &v0, const Variant &v1) const
+    {
+        const T d = v1.get<T>();
+        return d == T() ? Variant() : Variant(v0.get<T>() % d);
+    }
+
+    virtual Variant binary_div           (const Variant &v0, const Variant &v1) const
+    {
+        const T d = v1.get<T>();
+        return d == T() ? Variant() : Variant(v0.get<T>() / d);
+    }
 };
 
 
@@ -148,13 +158,38 @@ template<> struct binary_op_impl<String> : public binary_op_unsupported<String>
     virtual Variant binary_concat(const Variant &v0, const Variant &v1) const { return v0.get<String>() + v1.get<String>(); }
     virtual Variant binary_equal(const Variant &v0, const Variant &v1) const { return v0.get<String>() == v1.get<String>(); }
     virtual Variant binary_not_equal(const Variant &v0, const Variant &v1) const { return ! (v0.get<String>() == v1.get<String>()); }
+    virtual Variant binary_less(const Variant &v0, const Variant &v1) const { return v0.get<String>() < v1.get<String>(); }
+    virtual Variant binary_less_equal(const Variant &v0, const Variant &v1) const { return ! (v1.get<String>() < v0.get<String>()); }
+    virtual Variant binary_greater(const Variant &v0, const Variant &v1) const { return v1.get<String>() < v0.get<String>(); }
+    virtual Variant binary_greater_equal(const Variant &v0, const Variant &v1) const { return ! (v0.get<String>() < v1.get<String>()); }
+};
+
+
+/// Floating point types, like binary_op without modulo and bit operations
+template<typename T>
+struct binary_op_real : public binary_op_unsupported<T>
+{
+    virtual Variant binary_mul           (const Variant &v0, const Variant &v1) const { return v0.get<T>() * v1.get<T>(); }
+    virtual Variant binary_div           (const Variant &v0, const Variant &v1) const { return v0.get<T>() / v1.get<T>(); }
+    virtual Variant binary_add           (const Variant &v0, const Variant &v1) const { return v0.get<T>() + v1.get<T>(); }
+    virtual Variant binary_concat        (const Variant &v0, const Variant &v1) const { return v0.get<String>() + v1.get<String>(); }
+    virtual Variant binary_sub           (const Variant &v0, const Variant &v1) const { return v0.get<T>() - v1.get<T>(); }
+    virtual Variant binary_less          (const Variant &v0, const Variant &v1) const { return v0.get<T>() < v1.get<T>(); }
+    virtual Variant binary_less_equal    (const Variant &v0, const Variant &v1) const { return v0.get<T>() <= v1.get<T>(); }
+    virtual Variant binary_equal         (const Variant &v0, const Variant &v1) const { return v0.get<T>() == v1.get<T>(); }
+    virtual Variant binary_not_equal     (const Variant &v0, const Variant &v1) const { return v0.get<T>() != v1.get<T>(); }
+    virtual Variant binary_greater       (const Variant &v0, const Variant &v1) const { return v0.get<T>() > v1.get<T>(); }
+    virtual Variant binary_greater_equal (const Variant &v0, const Variant &v1) const { return v0.get<T>() >= v1.get<T>(); }
 };
 
+template<> struct binary_op_impl<float> : public binary_op_real<float> { };
+template<> struct binary_op_impl<double> : public binary_op_real<double> { };
+
 
 template<> struct binary_op_impl<TDate> : public binary_op_unsupported<TDate>
 {
    virtual Variant binary_equal         (const Variant &v0, const Variant &v1) const { return v0.get<TDate>() == v1.get<TDate>(); }
-   virtual Variant binary_not_equl      (const Variant &v0, const Variant &v1) const { return v0.get<TDate>() != v1.get<TDate>(); }
+   virtual Variant binary_not_equal     (const Variant &v0, const Variant &v1) const { return v0.get<TDate>() != v1.get<TDate>(); }
    virtual Variant binary_less          (const Variant &v0, const Variant &v1) const { return v0.get<TDate>() < v1.get<TDate>(); }
    virtual Variant binary_less_equal    (const Variant &v0, const Variant &v1) const { return !(v0.get<TDate>() > v1.get<TDate>()); }
    virtual Variant binary_greater       (const Variant &v0, const Variant &v1) const { return v0.get<TDate>() > v1.get<TDate>(); }
@@ -164,7 +199,7 @@ template<> struct binary_op_impl<TDate> : public binary_op_unsupported<TDate>
 template<> struct binary_op_impl<TNumeric> : public binary_op_unsupported<TNumeric>
 {
    virtual Variant binary_equal         (const Variant &v0, const Variant &v1) const { return v0.get<TNumeric>() == v1.get<TNumeric>(); }
-   virtual Variant binary_not_equl      (const Variant &v0, const Variant &v1) const { return v0.get<TNumeric>() != v1.get<TNumeric>(); }
+   virtual Variant binary_not_equal     (const Variant &v0, const Variant &v1) const { return v0.get<TNumeric>() != v1.get<TNumeric>(); }
    virtual Variant binary_less          (const Variant &v0, const Variant &v1) const { return v0.get<TNumeric>() < v1.get<TNumeric>(); }
    virtual Variant binary_less_equal    (const Variant &v0, const Variant &v1) const { return !(v0.get<TNumeric>() > v1.get<TNumeric>()); }
    virtual Variant binary_greater       (const Variant &v0, const Variant &v1) const { return v0.get<TNumeric>() > v1.get<TNumeric>(); }
@@ -177,674 +212,154 @@ template<> struct binary_op_impl<TNumeric> : public binary_op_unsupported<TNumer
 };
 
 
-static daltype_t resolve_higher(const Variant &op0, const Variant &op1)
+//..............................................................................
+///////////////////////////////////////////////////////////// binary_promotion
+///
+/// @details
+/// Result type of a binary operation, indexed by the daltype of the left
+/// and the right operand. Combinations without a common type resolve to
+/// DAL_TYPE_UNKNOWN.
+
+#define UNK DAL_TYPE_UNKNOWN
+#define INT DAL_TYPE_INT
+#define UIN DAL_TYPE_UINT
+#define CHR DAL_TYPE_CHAR
+#define UCH DAL_TYPE_UCHAR
+#define STR DAL_TYPE_STRING
+#define BOO DAL_TYPE_BOOL
+#define SMI DAL_TYPE_SMALLINT
+#define USM DAL_TYPE_USMALLINT
+#define BIG DAL_TYPE_BIGINT
+#define UBI DAL_TYPE_UBIGINT
+#define BLB DAL_TYPE_BLOB
+#define MEM DAL_TYPE_MEMO
+#define NUM DAL_TYPE_NUMERIC
+#define VBN DAL_TYPE_VARBINARY
+#define FLT DAL_TYPE_FLOAT
+#define DBL DAL_TYPE_DOUBLE
+#define DAT DAL_TYPE_DATE
+#define TIM DAL_TYPE_TIME
+#define TST DAL_TYPE_TIMESTAMP
+
+static constexpr daltype_t binary_promotion[DAL_TYPE_COUNT][DAL_TYPE_COUNT] =
 {
-    switch(op0.datatype())
-    {
-    case DAL_TYPE_CUSTOM:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_UNKNOWN:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_INT:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_INT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_BIGINT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_INT;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_INT;
-        case DAL_TYPE_STRING:        return DAL_TYPE_STRING;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_INT;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_INT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_INT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_UINT:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UINT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UINT;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UINT;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UINT;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_BIGINT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UINT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_CHAR:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_INT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_INT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_CHAR;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_INT;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_CHAR;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_SMALLINT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_INT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_UCHAR:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_INT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UINT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_INT;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UCHAR;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_BOOL;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_INT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_INT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_STRING:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_STRING;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_BOOL:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_INT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UINT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_CHAR;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UCHAR;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_BOOL;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_SMALLINT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_USMALLINT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_SMALLINT:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_INT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_BIGINT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_CHAR;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_SMALLINT;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_SMALLINT;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_SMALLINT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_INT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_USMALLINT:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_INT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UINT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_INT;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_USMALLINT;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_INT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_USMALLINT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_BIGINT:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_BIGINT;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_BIGINT;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_BIGINT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_BIGINT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_BIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_UBIGINT:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UBIGINT;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_BLOB:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_BLOB;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_MEMO:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_MEMO;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_NUMERIC:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_UINT:          return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-	/*
-    case DAL_TYPE_DECIMAL:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_UINT:          return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-	*/
-    case DAL_TYPE_VARBINARY:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_VARBINARY;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_FLOAT:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_FLOAT;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_DOUBLE:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_NUMERIC;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_DECIMAL;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_DOUBLE;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_DATE:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_DATE;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_TIMESTAMP;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_TIME:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_TIME;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_TIMESTAMP;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_TIMESTAMP:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_TIMESTAMP;
-        case DAL_TYPE_TIME:          return DAL_TYPE_TIMESTAMP;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_TIMESTAMP;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    case DAL_TYPE_INTERVAL:
-        switch(op1.datatype())
-        {
-        case DAL_TYPE_CUSTOM:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UNKNOWN:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INT:           return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UINT:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_CHAR:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UCHAR:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_STRING:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BOOL:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_SMALLINT:      return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_USMALLINT:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BIGINT:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_UBIGINT:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_BLOB:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_MEMO:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_NUMERIC:       return DAL_TYPE_UNKNOWN;
-        //case DAL_TYPE_DECIMAL:       return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_VARBINARY:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_FLOAT:         return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DOUBLE:        return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_DATE:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIME:          return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_TIMESTAMP:     return DAL_TYPE_UNKNOWN;
-        case DAL_TYPE_INTERVAL:      return DAL_TYPE_UNKNOWN;
-        };
-    };
-
-    throw std::runtime_error("Binary operator not implemented");
+    /*              CUS  UNK  INT  UIN  CHR  UCH  STR  BOO  SMI  USM  BIG  UBI  BLB  BST  MEM  MST  NUM  VBN  FLT  DBL  DAT  TIM  TST  IVL */
+    /* CUSTOM     */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* UNKNOWN    */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* INT        */ { UNK, UNK, INT, BIG, INT, INT, STR, INT, INT, INT, BIG, UBI, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* UINT       */ { UNK, UNK, BIG, UIN, UIN, UIN, UNK, UIN, BIG, UIN, UBI, UBI, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* CHAR       */ { UNK, UNK, INT, INT, CHR, INT, UNK, CHR, SMI, INT, BIG, UBI, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* UCHAR      */ { UNK, UNK, INT, UIN, INT, UCH, UNK, BOO, INT, INT, BIG, UBI, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* STRING     */ { UNK, UNK, UNK, UNK, UNK, UNK, STR, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* BOOL       */ { UNK, UNK, INT, UIN, CHR, UCH, UNK, BOO, SMI, USM, BIG, UBI, UNK, UNK, UNK, UNK, NUM, UNK, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* SMALLINT   */ { UNK, UNK, INT, BIG, CHR, SMI, UNK, SMI, SMI, INT, BIG, UNK, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* USMALLINT  */ { UNK, UNK, INT, UIN, INT, USM, UNK, UNK, INT, USM, BIG, UBI, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* BIGINT     */ { UNK, UNK, BIG, UBI, BIG, BIG, UNK, BIG, BIG, BIG, BIG, UNK, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* UBIGINT    */ { UNK, UNK, UBI, UBI, UBI, UBI, UNK, UBI, UBI, UBI, UBI, UBI, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* BLOB       */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, BLB, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* BLOBSTREAM */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* MEMO       */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, MEM, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* MEMOSTREAM */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* NUMERIC    */ { UNK, UNK, NUM, NUM, NUM, NUM, UNK, NUM, NUM, NUM, NUM, NUM, UNK, UNK, UNK, UNK, NUM, UNK, NUM, NUM, UNK, UNK, UNK, UNK },
+    /* VARBINARY  */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, VBN, UNK, UNK, UNK, UNK, UNK, UNK },
+    /* FLOAT      */ { UNK, UNK, FLT, FLT, FLT, FLT, UNK, UNK, FLT, FLT, FLT, FLT, UNK, UNK, UNK, UNK, NUM, UNK, FLT, DBL, UNK, UNK, UNK, UNK },
+    /* DOUBLE     */ { UNK, UNK, DBL, DBL, DBL, DBL, UNK, UNK, DBL, DBL, DBL, DBL, UNK, UNK, UNK, UNK, NUM, UNK, DBL, DBL, UNK, UNK, UNK, UNK },
+    /* DATE       */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, DAT, UNK, TST, UNK },
+    /* TIME       */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, TIM, TST, UNK },
+    /* TIMESTAMP  */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, TST, TST, TST, UNK },
+    /* INTERVAL   */ { UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK, UNK }
+};
+
+#undef UNK
+#undef INT
+#undef UIN
+#undef CHR
+#undef UCH
+#undef STR
+#undef BOO
+#undef SMI
+#undef USM
+#undef BIG
+#undef UBI
+#undef BLB
+#undef MEM
+#undef NUM
+#undef VBN
+#undef FLT
+#undef DBL
+#undef DAT
+#undef TIM
+#undef TST
+
+
+static_assert(DAL_TYPE_COUNT == 24, "binary_promotion must be updated");
+
+
+
+//..............................................................................
+////////////////////////////////////////////////////////////// binary_op_table
+///
+/// @details
+/// One statically allocated operator implementation per result type.
+template<typename T>
+struct binary_op_instance
+{
+    static const binary_op_impl<T> value;
+};
+
+template<typename T>
+const binary_op_impl<T> binary_op_instance<T>::value = binary_op_impl<T>();
+
+
+static const BinaryOperatorVariant* const binary_op_table[DAL_TYPE_COUNT] =
+{
+    &binary_op_instance<int                 >::value,    // DAL_TYPE_CUSTOM
+    &binary_op_instance<int                 >::value,    // DAL_TYPE_UNKNOWN
+    &binary_op_instance<signed int          >::value,    // DAL_TYPE_INT
+    &binary_op_instance<unsigned int        >::value,    // DAL_TYPE_UINT
+    &binary_op_instance<signed char         >::value,    // DAL_TYPE_CHAR
+    &binary_op_instance<unsigned char       >::value,    // DAL_TYPE_UCHAR
+    &binary_op_instance<String              >::value,    // DAL_TYPE_STRING
+    &binary_op_instance<bool                >::value,    // DAL_TYPE_BOOL
+    &binary_op_instance<signed short        >::value,    // DAL_TYPE_SMALLINT
+    &binary_op_instance<unsigned short      >::value,    // DAL_TYPE_USMALLINT
+    &binary_op_instance<signed long long    >::value,    // DAL_TYPE_BIGINT
+    &binary_op_instance<unsigned long long  >::value,    // DAL_TYPE_UBIGINT
+    &binary_op_instance<Blob                >::value,    // DAL_TYPE_BLOB
+    &binary_op_instance<BlobStream          >::value,    // DAL_TYPE_BLOBSTREAM
+    &binary_op_instance<Memo                >::value,    // DAL_TYPE_MEMO
+    &binary_op_instance<MemoStream          >::value,    // DAL_TYPE_MEMOSTREAM
+    &binary_op_instance<TNumeric            >::value,    // DAL_TYPE_NUMERIC
+    &binary_op_instance<TVarbinary          >::value,    // DAL_TYPE_VARBINARY
+    &binary_op_instance<float               >::value,    // DAL_TYPE_FLOAT
+    &binary_op_instance<double              >::value,    // DAL_TYPE_DOUBLE
+    &binary_op_instance<TDate               >::value,    // DAL_TYPE_DATE
+    &binary_op_instance<TTime               >::value,    // DAL_TYPE_TIME
+    &binary_op_instance<TTimestamp          >::value,    // DAL_TYPE_TIMESTAMP
+    &binary_op_instance<TInterval           >::value     // DAL_TYPE_INTERVAL
+};
+
+
+
+/// @details
+/// The result type is looked up in the promotion matrix.
+const BinaryOperatorVariant* binary_operator_for(daltype_t t0, daltype_t t1)
+{
+    return binary_op_table[binary_promotion[t0][t1]];
 }
 
 
+/// @details
+/// The operator is called on the static implementation for the
+/// promoted type of both operands.
 Variant apply_binary_method(const Variant &op0, const Variant &op1, BinaryOperatorVariant::memfun_type method)
 {
     if(op0.isnull() || op1.isnull())
         throw NullException();
 
-    daltype_t type = resolve_higher(op0, op1);
+    const BinaryOperatorVariant *impl = binary_operator_for(op0.datatype(), op1.datatype());
 
-    switch(type)
-    {
-    case DAL_TYPE_CUSTOM:        return (binary_op_impl<int                 >().*method)(op0, op1);
-    case DAL_TYPE_UNKNOWN:       return (binary_op_impl<int                 >().*method)(op0, op1);
-    case DAL_TYPE_INT:           return (binary_op_impl<signed int          >().*method)(op0, op1);
-    case DAL_TYPE_UINT:          return (binary_op_impl<unsigned int        >().*method)(op0, op1);
-    case DAL_TYPE_CHAR:          return (binary_op_impl<signed char         >().*method)(op0, op1);
-    case DAL_TYPE_UCHAR:         return (binary_op_impl<unsigned char       >().*method)(op0, op1);
-    case DAL_TYPE_STRING:        return (binary_op_impl<String              >().*method)(op0, op1);
-    case DAL_TYPE_BOOL:          return (binary_op_impl<bool                >().*method)(op0, op1);
-    case DAL_TYPE_SMALLINT:      return (binary_op_impl<signed short        >().*method)(op0, op1);
-    case DAL_TYPE_USMALLINT:     return (binary_op_impl<unsigned short      >().*method)(op0, op1);
-    case DAL_TYPE_BIGINT:        return (binary_op_impl<signed long long    >().*method)(op0, op1);
-    case DAL_TYPE_UBIGINT:       return (binary_op_impl<unsigned long long  >().*method)(op0, op1);
-    case DAL_TYPE_BLOB:          return (binary_op_impl<Blob                >().*method)(op0, op1);
-    case DAL_TYPE_MEMO:          return (binary_op_impl<Memo                >().*method)(op0, op1);
-    case DAL_TYPE_NUMERIC:       return (binary_op_impl<TNumeric            >().*method)(op0, op1);
-        //case DAL_TYPE_DECIMAL:       return (binary_op_impl<TDecimal>().*method)(op0, op1);
-    case DAL_TYPE_VARBINARY:     return (binary_op_impl<TVarbinary          >().*method)(op0, op1);
-    case DAL_TYPE_FLOAT:         return (binary_op_impl<float               >().*method)(op0, op1);
-    case DAL_TYPE_DOUBLE:        return (binary_op_impl<double              >().*method)(op0, op1);
-    case DAL_TYPE_DATE:          return (binary_op_impl<TDate               >().*method)(op0, op1);
-    case DAL_TYPE_TIME:          return (binary_op_impl<TTime               >().*method)(op0, op1);
-    case DAL_TYPE_TIMESTAMP:     return (binary_op_impl<TTimestamp          >().*method)(op0, op1);
-    case DAL_TYPE_INTERVAL:      return (binary_op_impl<TInterval           >().*method)(op0, op1);
-    };
-
-    throw std::runtime_error("Binary operator not implemented");
+    return (impl->*method)(op0, op1);
 }
 
 
@@ -46,74 +46,271 @@
 #include "dbwtl/dal/dal_interface.hh"
 #include "dbwtl/variant.hh"
 
-#include <memory>
+#include "dal/dal_debug.hh"
 
 
 DB_NAMESPACE_BEGIN
 
 
-template<typename T, typename U>
-struct binary_operator_impl : public binary_operator
+//..............................................................................
+///////////////////////////////////////////////////////////// column_operator
+///
+/// @details
+/// Caches the operator implementation for the last seen pair of
+/// operand types. Columns usually hold a single type, so the
+/// promotion lookup is only done when the type changes.
+class column_operator
 {
-    virtual Variant add(const Variant &a, const Variant &b)
+public:
+    column_operator(BinaryOperatorVariant::memfun_type method)
+        : m_method(method),
+          m_impl(0),
+          m_t0(DAL_TYPE_UNKNOWN),
+          m_t1(DAL_TYPE_UNKNOWN)
+    {}
+
+    /// Computes a op b into result, result is NULL if a or b is NULL
+    inline void operator()(const Variant &a, const Variant &b, Variant &result)
+    {
+        if(a.isnull() || b.isnull())
         {
-            return a.get<T>() + b.get<U>();
+            result.setNull();
+            return;
         }
+        daltype_t t0 = a.datatype();
+        daltype_t t1 = b.datatype();
+        if(!m_impl || t0 != m_t0 || t1 != m_t1)
+        {
+            m_impl = binary_operator_for(t0, t1);
+            m_t0 = t0;
+            m_t1 = t1;
+        }
+        result = (m_impl->*m_method)(a, b);
+    }
+
+private:
+    BinaryOperatorVariant::memfun_type  m_method;
+    const BinaryOperatorVariant        *m_impl;
+    daltype_t                           m_t0;
+    daltype_t                           m_t1;
 };
 
 
 
-typedef std::shared_ptr<binary_operator> (*binary_function)(void);
+//
+Variant
+VariantExprHelper::binaryAdd(const Variant &a, const Variant &b)
+{
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_add);
+}
 
 
-template<typename T, typename U>
-std::shared_ptr<binary_operator> binary_expr(void)
+//
+Variant
+VariantExprHelper::binarySub(const Variant &a, const Variant &b)
 {
-    return std::shared_ptr<binary_operator>(new binary_operator_impl<T, U>());
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_sub);
 }
 
 
+//
+Variant
+VariantExprHelper::binaryMul(const Variant &a, const Variant &b)
+{
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_mul);
+}
 
 
-enum { DBWTL_TYPE_COUNT = 2};
+//
+Variant
+VariantExprHelper::binaryDiv(const Variant &a, const Variant &b)
+{
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_div);
+}
+
 
-binary_function mapping[DBWTL_TYPE_COUNT][2] =
+//
+Variant
+VariantExprHelper::binaryMod(const Variant &a, const Variant &b)
 {
-    {
-        binary_expr<int, int>,
-        binary_expr<int, int>
-    },
-    {
-        binary_expr<int, int>,
-        binary_expr<int, int>
-    }
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_mod);
+}
 
-};
 
+//
+Variant
+VariantExprHelper::binaryConcat(const Variant &a, const Variant &b)
+{
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_concat);
+}
+
+
+//
+Variant
+VariantExprHelper::binaryLess(const Variant &a, const Variant &b)
+{
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_less);
+}
 
 
-std::shared_ptr<binary_operator> handle(daltype_t a, daltype_t b)
+//
+Variant
+VariantExprHelper::binaryLessEqual(const Variant &a, const Variant &b)
 {
-    //daltype_t ta = a.datatype();
-    //daltype_t tb = b.datatype();
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_less_equal);
+}
 
-    return mapping[0][0]();
+
+//
+Variant
+VariantExprHelper::binaryEqual(const Variant &a, const Variant &b)
+{
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_equal);
 }
 
 
+//
 Variant
-VariantExprHelper::binaryAdd(const Variant &a, const Variant &b)
+VariantExprHelper::binaryNotEqual(const Variant &a, const Variant &b)
 {
-    return handle(a.datatype(), b.datatype())->add(a, b);   
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_not_equal);
 }
 
+
+//
+Variant
+VariantExprHelper::binaryGreater(const Variant &a, const Variant &b)
+{
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_greater);
+}
+
+
+//
+Variant
+VariantExprHelper::binaryGreaterEqual(const Variant &a, const Variant &b)
+{
+    return apply_binary_method(a, b, &BinaryOperatorVariant::binary_greater_equal);
+}
+
+
+//
+int
+VariantExprHelper::compare(const Variant &a, const Variant &b)
+{
+    if(a.isnull() || b.isnull())
+        throw NullException();
+
+    const BinaryOperatorVariant *impl = binary_operator_for(a.datatype(), b.datatype());
+
+    if(impl->binary_less(a, b).get<bool>())
+        return -1;
+    else if(impl->binary_equal(a, b).get<bool>())
+        return 0;
+    else
+        return 1;
+}
+
+
+/// @details
+/// The operand is promoted like in a binary operation with an INT.
 Variant
 VariantExprHelper::unaryPositive(const Variant &a)
 {
-    return + a.get<int>();
+    return apply_binary_method(Variant(static_cast<signed int>(0)), a, &BinaryOperatorVariant::binary_add);
 }
 
 
+/// @details
+/// The operand is promoted like in a binary operation with an INT.
+Variant
+VariantExprHelper::unaryNegative(const Variant &a)
+{
+    return apply_binary_method(Variant(static_cast<signed int>(0)), a, &BinaryOperatorVariant::binary_sub);
+}
+
+
+//
+void
+VariantExprHelper::apply(const column_type &a, const column_type &b, column_type &result,
+                         BinaryOperatorVariant::memfun_type method)
+{
+    DBWTL_BUGCHECK_EX(a.size() == b.size(), "VariantExprHelper: column sizes differ");
+
+    column_operator op(method);
+    result.resize(a.size());
+    for(column_type::size_type i = 0; i < a.size(); ++i)
+        op(a[i], b[i], result[i]);
+}
+
+
+//
+void
+VariantExprHelper::apply(const column_type &a, const Variant &b, column_type &result,
+                         BinaryOperatorVariant::memfun_type method)
+{
+    column_operator op(method);
+    result.resize(a.size());
+    for(column_type::size_type i = 0; i < a.size(); ++i)
+        op(a[i], b, result[i]);
+}
+
+
+//
+void
+VariantExprHelper::compare(const column_type &a, const column_type &b, std::vector<int> &result,
+                           std::vector<bool> &nulls)
+{
+    DBWTL_BUGCHECK_EX(a.size() == b.size(), "VariantExprHelper: column sizes differ");
+
+    result.resize(a.size());
+    nulls.assign(a.size(), false);
+    const BinaryOperatorVariant *impl = 0;
+    daltype_t t0 = DAL_TYPE_UNKNOWN, t1 = DAL_TYPE_UNKNOWN;
+
+    for(column_type::size_type i = 0; i < a.size(); ++i)
+    {
+        if(a[i].isnull() || b[i].isnull())
+        {
+            result[i] = 0;
+            nulls[i] = true;
+            continue;
+        }
+        if(!impl || a[i].datatype() != t0 || b[i].datatype() != t1)
+        {
+            t0 = a[i].datatype();
+            t1 = b[i].datatype();
+            impl = binary_operator_for(t0, t1);
+        }
+        if(impl->binary_less(a[i], b[i]).get<bool>())
+            result[i] = -1;
+        else if(impl->binary_equal(a[i], b[i]).get<bool>())
+            result[i] = 0;
+        else
+            result[i] = 1;
+    }
+}
+
+
+#define DBWTL_COLUMN_KERNEL(name, method)                               \
+    void VariantExprHelper::name(const column_type &a, const column_type &b, column_type &result) \
+    {                                                                   \
+        apply(a, b, result, &BinaryOperatorVariant::method);            \
+    }                                                                   \
+    void VariantExprHelper::name(const column_type &a, const Variant &b, column_type &result) \
+    {                                                                   \
+        apply(a, b, result, &BinaryOperatorVariant::method);            \
+    }
+
+DBWTL_COLUMN_KERNEL(binaryAdd,    binary_add)
+DBWTL_COLUMN_KERNEL(binarySub,    binary_sub)
+DBWTL_COLUMN_KERNEL(binaryMul,    binary_mul)
+DBWTL_COLUMN_KERNEL(binaryDiv,    binary_div)
+DBWTL_COLUMN_KERNEL(binaryMod,    binary_mod)
+DBWTL_COLUMN_KERNEL(binaryConcat, binary_concat)
+
+#undef DBWTL_COLUMN_KERNEL
+
+
 
 DB_NAMESPACE_END
 
@@ -0,0 +1,102 @@
+//
+// bench.hh - Timing helpers for the benchmarks
+//
+// You can use and redistribute this file without any restrictions.
+//
+
+/// @file
+/// @brief Timing helpers shared by the benchmarks in tests/bench
+
+
+#ifndef DBWTL_BENCH_HH
+#define DBWTL_BENCH_HH
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <locale>
+#include <ratio>
+#include <string>
+
+#include "../cxxc.hh"
+
+
+namespace bench
+{
+    typedef std::chrono::steady_clock clock;
+
+
+    /// Returns the time since start in the given unit, seconds by default
+    template<typename Unit = std::ratio<1> >
+    inline double elapsed(clock::time_point start)
+    {
+        return std::chrono::duration<double, Unit>(clock::now() - start).count();
+    }
+
+
+    /// Calls fn rounds times and returns the time per call in the given unit
+    template<typename Unit, typename F>
+    inline double per_call(int rounds, F fn)
+    {
+        clock::time_point start = clock::now();
+        for(int i = 0; i < rounds; ++i)
+            fn();
+        return elapsed<Unit>(start) / rounds;
+    }
+
+
+    /// Keeps the compiler from dropping a computed value
+    template<typename T>
+    inline void consume(const T &value)
+    {
+        static volatile char sink;
+        sink = *reinterpret_cast<const volatile char*>(&value);
+    }
+
+
+    /// Starts a result row with a left aligned label
+    inline std::ostream& row(const std::string &label, int width = 24)
+    {
+        return std::cout << "\t" << std::left << std::setw(width) << label << std::right;
+    }
+
+
+    /// Appends a measured value to the current row, negative values
+    /// are printed as "-" (not measured)
+    inline std::ostream& cell(const char *name, double value, const char *unit, int width = 8)
+    {
+        std::cout << "  " << name << ": " << std::setw(width);
+        if(value < 0)
+            return std::cout << "-" << std::string(std::char_traits<char>::length(unit) + 1, ' ');
+        return std::cout << value << " " << unit;
+    }
+
+
+    /// Sets up the locales and runs all benchmarks
+    inline int run(int precision = 1)
+    {
+        std::locale::global(std::locale(""));
+        std::cout.imbue(std::locale());
+        std::cerr.imbue(std::locale());
+        std::clog.imbue(std::locale());
+        std::wcout.imbue(std::locale());
+        std::wcerr.imbue(std::locale());
+        std::wclog.imbue(std::locale());
+
+        std::cout << std::fixed << std::setprecision(precision);
+        return cxxc::runAll();
+    }
+}
+
+
+#endif
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
@@ -0,0 +1,80 @@
+#include <dbwtl/dbobjects>
+
+#include <string>
+
+#include "bench.hh"
+
+
+using informave::utils::bcd;
+
+
+// Number of divisions per measured operand width
+#define BENCH_ROUNDS 20
+
+
+/// Returns an operand with the given number of integral and fractional digits
+static bcd make_operand(int digits, char first)
+{
+    std::string s;
+    for(int i = 0; i < digits; ++i)
+        s += static_cast<char>('1' + (first - '1' + i) % 9);
+    s.insert(s.size() - digits / 2, ".");
+    return bcd(s, std::locale("C"));
+}
+
+
+/// Returns the time per division in microseconds
+template<typename F>
+static double measure(const bcd &a, const bcd &b, F fn)
+{
+    return bench::per_call<std::micro>(BENCH_ROUNDS, [&]()
+    {
+        bcd x(a);
+        fn(x, b);
+        CXXC_CHECK( x != bcd(0) );
+    });
+}
+
+
+static void long_division(bcd &x, const bcd &b)
+{
+    x.div(b);
+}
+
+
+static void newton_division(bcd &x, const bcd &b)
+{
+    x.div_newton(b);
+}
+
+
+CXXC_TEST(DivisionCost)
+{
+    const int widths[] = { 2, 4, 8, 12, 16, 24 };
+
+    for(size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); ++i)
+    {
+        bcd a = make_operand(widths[i], '7');
+        bcd b = make_operand(widths[i] / 2 + 1, '3');
+
+        bench::row(std::to_string(widths[i]) + " digits", 10);
+        bench::cell("long division", measure(a, b, long_division), "us", 10);
+        bench::cell("newton", measure(a, b, newton_division), "us", 10) << std::endl;
+    }
+}
+
+
+int main(void)
+{
+    return bench::run();
+}
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
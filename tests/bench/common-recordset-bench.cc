@@ -0,0 +1,110 @@
+#include <dbwtl/dbobjects>
+
+#include <thread>
+#include <vector>
+
+#include "bench.hh"
+
+
+using namespace informave::db;
+
+
+// Number of rows in the benchmark RecordSet
+#define BENCH_ROWS 200000
+
+// Number of distinct group keys
+#define BENCH_GROUPS 100
+
+
+static void fill(RecordSet &rs)
+{
+    rs.setColumnCount(3);
+    rs.modifyColumnDesc(1, DBWTL_COLUMNDESC_NAME, String("id"));
+    rs.modifyColumnDesc(2, DBWTL_COLUMNDESC_NAME, String("grp"));
+    rs.modifyColumnDesc(3, DBWTL_COLUMNDESC_NAME, String("price"));
+    rs.open();
+    unsigned int x = 12345;
+    for(int i = 0; i < BENCH_ROWS; ++i)
+    {
+        x = x * 1103515245 + 12345;
+        ShrRecord rec(3);
+        rec[0] = Variant(static_cast<signed int>(x >> 8));
+        rec[1] = Variant(String("group ") + Variant(i % BENCH_GROUPS).get<String>());
+        rec[2] = Variant(double(i % 1000) / 8);
+        rs.emplace(std::move(rec));
+    }
+}
+
+
+CXXC_TEST(ParallelScaling)
+{
+    RecordSet rs;
+    fill(rs);
+
+    std::vector<RecordSortKey> keys;
+    keys.push_back(RecordSortKey(2));
+    keys.push_back(RecordSortKey(1, true));
+
+    std::vector<RecordAggregate> aggs;
+    aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_COUNT, 0));
+    aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_SUM, 3));
+    aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_MAX, 1));
+
+    // at least two threads, so the merge steps always run
+    size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+
+    RecordSetOps::rowlist_type expected;
+    RecordSet expected_groups;
+    double sort_base = 0, group_base = 0;
+
+    for(size_t threads = 1; threads <= cores; threads *= 2)
+    {
+        RecordSetOps::rowlist_type order;
+        bench::clock::time_point start = bench::clock::now();
+        RecordSetOps::sortRows(rs, keys, order, threads);
+        double sort_time = bench::elapsed(start);
+
+        RecordSet groups;
+        start = bench::clock::now();
+        RecordSetOps::groupBy(rs, std::vector<colnum_t>(1, 2), aggs, groups, threads);
+        double group_time = bench::elapsed(start);
+
+        if(threads == 1)
+        {
+            expected = order;
+            RecordSetOps::groupBy(rs, std::vector<colnum_t>(1, 2), aggs, expected_groups);
+            sort_base = sort_time;
+            group_base = group_time;
+        }
+
+        CXXC_CHECK( order == expected );
+        CXXC_CHECK( groups.rowCount() == BENCH_GROUPS );
+        groups.setpos(BENCH_GROUPS / 2);
+        expected_groups.setpos(BENCH_GROUPS / 2);
+        CXXC_CHECK( groups.column(1).get<String>() == expected_groups.column(1).get<String>() );
+        CXXC_CHECK( groups.column(2).get<int>() == BENCH_ROWS / BENCH_GROUPS );
+        CXXC_CHECK( groups.column(3).get<double>() == expected_groups.column(3).get<double>() );
+        CXXC_CHECK( groups.column(4).get<int>() == expected_groups.column(4).get<int>() );
+
+        bench::row(std::to_string(threads) + " threads", 12);
+        bench::cell("sort", sort_time, "s") << " (x" << sort_base / sort_time << ")";
+        bench::cell("group-by", group_time, "s") << " (x" << group_base / group_time << ")"
+                                                   << std::endl;
+    }
+}
+
+
+int main(void)
+{
+    return bench::run(3);
+}
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
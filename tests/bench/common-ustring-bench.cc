@@ -0,0 +1,63 @@
+#include <dbwtl/dal/dalinterface>
+#include <dbwtl/ustring>
+
+
+#include <string>
+
+#include "bench.hh"
+
+
+using namespace informave::db;
+
+
+// Number of conversions per measurement
+#define BENCH_ROUNDS 20000
+
+
+/// Returns the time per conversion in nanoseconds. If modify is set,
+/// the string is marked as modified before each conversion.
+template<typename F>
+static double measure(String &s, F fn, bool modify)
+{
+    return bench::per_call<std::nano>(BENCH_ROUNDS, [&]()
+    {
+        if(modify)
+            s.ref();
+        bench::consume(*fn(s));
+    });
+}
+
+
+static const char* to_utf8(const String &s)
+{
+    return s.utf8();
+}
+
+
+static const char* to_latin1(const String &s)
+{
+    return s.to("ISO-8859-1");
+}
+
+
+CXXC_TEST(RepeatedConversion)
+{
+    const size_t lengths[] = { 8, 64, 512, 4096 };
+
+    for(size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i)
+    {
+        String s(std::string(lengths[i], 'x'));
+
+        bench::row(std::to_string(lengths[i]) + " chars", 12);
+        bench::cell("utf8() modified", measure(s, to_utf8, true), "ns");
+        bench::cell("cached", measure(s, to_utf8, false), "ns", 6);
+        bench::cell("to(ISO-8859-1) modified", measure(s, to_latin1, true), "ns");
+        bench::cell("cached", measure(s, to_latin1, false), "ns", 6) << std::endl;
+    }
+}
+
+
+int main(void)
+{
+    return bench::run();
+}
@@ -0,0 +1,94 @@
+#include <dbwtl/dal/dalinterface>
+#include <dbwtl/dbobjects>
+#include <dbwtl/ustring>
+
+
+#include "bench.hh"
+
+
+using namespace informave::db;
+
+
+// Number of get<T>() calls per measured type pair
+#define BENCH_ROUNDS 5000
+
+
+/// Returns the time per get<T>() call in nanoseconds
+template<typename T>
+static double measure(const Variant &var)
+{
+    return bench::per_call<std::nano>(BENCH_ROUNDS, [&var]() { bench::consume(var.get<T>()); });
+}
+
+
+/// Compares the inline conversion table with the dynamic_cast<> path,
+/// which every get<T>() took before. A heap allocated value store still
+/// takes this path, like engine accessors (e.g. sv_accessor<SqliteData*>)
+/// in a fetch loop, whose conversions are not covered by the table.
+template<typename U, typename T>
+static void bench_pair(const U &value)
+{
+    Variant inl(value);
+    Variant heap(static_cast<IVariantValue*>(new typename value_traits<U>::stored_type(value)));
+
+    CXXC_CHECK( inl.is_inline() );
+    CXXC_CHECK( ! heap.is_inline() );
+    CXXC_CHECK( inl.can_convert<T>() == heap.can_convert<T>() );
+
+    if(! inl.can_convert<T>())
+        return;
+
+    double t_table = measure<T>(inl);
+    double t_cast = measure<T>(heap);
+
+    bench::row(std::string(var_info<U>::name()) + " -> " + var_info<T>::name());
+    bench::cell("table", t_table, "ns");
+    bench::cell("dynamic_cast", t_cast, "ns") << std::endl;
+}
+
+
+template<typename U>
+static void bench_source(const U &value)
+{
+    bench_pair<U, signed int>(value);
+    bench_pair<U, unsigned int>(value);
+    bench_pair<U, signed char>(value);
+    bench_pair<U, unsigned char>(value);
+    bench_pair<U, String>(value);
+    bench_pair<U, bool>(value);
+    bench_pair<U, signed short>(value);
+    bench_pair<U, unsigned short>(value);
+    bench_pair<U, signed long long>(value);
+    bench_pair<U, unsigned long long>(value);
+    bench_pair<U, TNumeric>(value);
+    bench_pair<U, float>(value);
+    bench_pair<U, double>(value);
+    bench_pair<U, TDate>(value);
+    bench_pair<U, TTime>(value);
+    bench_pair<U, TTimestamp>(value);
+}
+
+
+CXXC_TEST(GetConversionCost)
+{
+    bench_source<signed int>(1);
+    bench_source<unsigned int>(1);
+    bench_source<signed char>(1);
+    bench_source<unsigned char>(1);
+    bench_source<bool>(true);
+    bench_source<signed short>(1);
+    bench_source<unsigned short>(1);
+    bench_source<signed long long>(1);
+    bench_source<unsigned long long>(1);
+    bench_source<float>(1);
+    bench_source<double>(1);
+    bench_source<TDate>(TDate(2011, 5, 17));
+    bench_source<TTime>(TTime(12, 30, 15));
+    bench_source<TTimestamp>(TTimestamp(2011, 5, 17, 12, 30, 15));
+}
+
+
+int main(void)
+{
+    return bench::run();
+}
@@ -0,0 +1,77 @@
+#include <dbwtl/dal/dalinterface>
+#include <dbwtl/dbobjects>
+#include <dbwtl/ustring>
+
+
+#include <vector>
+
+#include "bench.hh"
+
+
+using namespace informave::db;
+
+
+// Number of operator calls per measured type pair
+#define BENCH_ROUNDS 2000
+
+
+/// Returns the time per operator call in nanoseconds, or a negative
+/// value if the operator is not supported for the given types.
+static double measure(const Variant &op0, const Variant &op1, BinaryOperatorVariant::memfun_type method)
+{
+    try
+    {
+        apply_binary_method(op0, op1, method);
+    }
+    catch(...)
+    {
+        return -1;
+    }
+
+    return bench::per_call<std::nano>(BENCH_ROUNDS, [&]()
+    {
+        Variant res = apply_binary_method(op0, op1, method);
+        CXXC_CHECK( ! res.isnull() );
+    });
+}
+
+
+CXXC_TEST(BinaryOperatorCost)
+{
+    std::vector<Variant> values;
+    values.push_back(Variant(static_cast<signed int>(3)));
+    values.push_back(Variant(static_cast<unsigned int>(3)));
+    values.push_back(Variant(static_cast<signed char>(3)));
+    values.push_back(Variant(static_cast<unsigned char>(3)));
+    values.push_back(Variant(String("3")));
+    values.push_back(Variant(true));
+    values.push_back(Variant(static_cast<signed short>(3)));
+    values.push_back(Variant(static_cast<unsigned short>(3)));
+    values.push_back(Variant(static_cast<signed long long>(3)));
+    values.push_back(Variant(static_cast<unsigned long long>(3)));
+    values.push_back(Variant(TNumeric(3)));
+    values.push_back(Variant(float(3)));
+    values.push_back(Variant(double(3)));
+    values.push_back(Variant(TDate(2011, 5, 17)));
+    values.push_back(Variant(TTime(12, 30, 15)));
+    values.push_back(Variant(TTimestamp(2011, 5, 17, 12, 30, 15)));
+
+    for(std::vector<Variant>::const_iterator i = values.begin(); i != values.end(); ++i)
+    {
+        for(std::vector<Variant>::const_iterator j = values.begin(); j != values.end(); ++j)
+        {
+            bench::row(std::string(daltype2string(i->datatype())).substr(9) + " op "
+                       + std::string(daltype2string(j->datatype())).substr(9), 28);
+            bench::cell("add", measure(*i, *j, &BinaryOperatorVariant::binary_add), "ns");
+            bench::cell("equal", measure(*i, *j, &BinaryOperatorVariant::binary_equal), "ns");
+            bench::cell("less", measure(*i, *j, &BinaryOperatorVariant::binary_less), "ns");
+            std::cout << std::endl;
+        }
+    }
+}
+
+
+int main(void)
+{
+    return bench::run();
+}
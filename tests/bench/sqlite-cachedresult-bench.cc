@@ -0,0 +1,158 @@
+#include <dbwtl/dbobjects>
+#include <dbwtl/dal/engines/generic>
+
+#include <algorithm>
+#include <utility>
+
+#include "bench.hh"
+
+#include "../sqlite/fixture_sqlite3.hh"
+
+
+using namespace informave::db;
+
+
+// Number of rows in the benchmark table
+#define BENCH_ROWS 20000
+
+
+static void fill_table(SqliteMemoryFixture::DBMS::Connection &dbc)
+{
+    SqliteMemoryFixture::DBMS::Statement stmt(dbc);
+
+    stmt.execDirect("CREATE TABLE bench(id integer, name text, price double)");
+    stmt.close();
+    stmt.execDirect("BEGIN");
+    stmt.close();
+    stmt.prepare("INSERT INTO bench(id, name, price) VALUES(?, ?, ?)");
+    for(int i = 0; i < BENCH_ROWS; ++i)
+    {
+        stmt.bind(1, i);
+        stmt.bind(2, String("some text value"));
+        stmt.bind(3, double(i) / 4);
+        stmt.execute();
+    }
+    stmt.close();
+    stmt.execDirect("COMMIT");
+    stmt.close();
+}
+
+
+// Number of runs per measurement, the best run is reported
+#define BENCH_RUNS 5
+
+
+/// Copies all rows like CachedResultBase did before records were
+/// ingested without a clone: every value is copied into a record, which
+/// is cloned again for insert()
+static void fetch_cloned(IResult &rs, RecordSet &cache)
+{
+    cache.open();
+    rs.first();
+    while(!rs.eof())
+    {
+        ShrRecord rec(rs.columnCount());
+        for(colnum_t i = 1; i <= rs.columnCount(); ++i)
+        {
+            if(rs.column(i).isnull())
+                rec[i-1] = Variant();
+            else
+                rec[i-1] = rs.column(i);
+        }
+        cache.insert(rec.clone());
+        rs.next();
+    }
+}
+
+
+/// Copies all rows like CachedResultBase::fetchAll(): every value is
+/// copied once and the record is handed over without a clone
+static void fetch_once(IResult &rs, RecordSet &cache)
+{
+    cache.open();
+    rs.first();
+    const colnum_t ncol = rs.columnCount();
+    while(!rs.eof())
+    {
+        ShrRecord rec(ncol);
+        for(colnum_t i = 1; i <= ncol; ++i)
+        {
+            const Variant &v = rs.column(i);
+            if(!v.isnull())
+                rec[i-1].assign(v);
+        }
+        cache.emplace(std::move(rec));
+        rs.next();
+    }
+}
+
+
+/// Runs fn over a fresh resultset and returns the best rate in rows/s
+template<typename F>
+static double best_rate(SqliteMemoryFixture::DBMS::Connection &dbc, F fn)
+{
+    double best = 0;
+    for(int run = 0; run < BENCH_RUNS; ++run)
+    {
+        SqliteMemoryFixture::DBMS::Statement stmt(dbc);
+        stmt.execDirect("SELECT * FROM bench");
+        bench::clock::time_point start = bench::clock::now();
+        size_t rows = fn(stmt);
+        CXXC_CHECK( rows == BENCH_ROWS );
+        best = std::max(best, rows / bench::elapsed(start));
+    }
+    return best;
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, FetchAllThroughput)
+{
+    fill_table(dbc);
+
+    // the same loop over the source, once with the clone in insert()
+    // and once without
+    double cloned = best_rate(dbc, [](DBMS::Statement &stmt) {
+            RecordSet cache;
+            fetch_cloned(stmt.resultset(), cache);
+            return size_t(cache.rowCount());
+        });
+    bench::row("insert(rec.clone())", 28);
+    bench::cell("rate", cloned, "rows/s", 12) << std::endl;
+
+    double once = best_rate(dbc, [](DBMS::Statement &stmt) {
+            RecordSet cache;
+            fetch_once(stmt.resultset(), cache);
+            return size_t(cache.rowCount());
+        });
+    bench::row("emplace(rec)", 28);
+    bench::cell("rate", once, "rows/s", 12) << std::endl;
+
+    // the real path, including the virtual calls of CachedResultBase
+    double fetched = best_rate(dbc, [](DBMS::Statement &stmt) {
+            DBMS::CachedResultset cr;
+            cr.attach(stmt);
+            cr.open();
+            cr.fetchAll();
+            cr.last();
+            CXXC_CHECK( cr.column("id").get<int>() == BENCH_ROWS - 1 );
+            return size_t(cr.rowCount());
+        });
+    bench::row("CachedResultset::fetchAll()", 28);
+    bench::cell("rate", fetched, "rows/s", 12) << std::endl;
+}
+
+
+int main(void)
+{
+    return bench::run();
+}
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
@@ -125,6 +125,41 @@ CXXC_TEST(Division)
 }
 
 
+CXXC_TEST(LongDivision)
+{
+    CXXC_CHECK( bcd(1) / bcd(3) == bcd("0.33333333333333") );
+
+    CXXC_CHECK( bcd(2) / bcd(3) == bcd("0.66666666666667") );
+
+    CXXC_CHECK( bcd("0.000045") / bcd("0.009") == bcd("0.005") );
+
+    CXXC_CHECK( bcd("123456789012345678901234567890") / bcd("10") == bcd("12345678901234567890123456789") );
+
+    bcd x(10);
+    x.div(bcd(4), 4, informave::utils::BCD_ROUND_HALF_UP);
+    CXXC_CHECK( x.scale() == 4 );
+    CXXC_CHECK( x.str(std::locale("C")) == "2.5000" );
+
+    x = bcd(10);
+    x.div(bcd(4), 0, informave::utils::BCD_ROUND_HALF_UP);
+    CXXC_CHECK( x == bcd(3) );
+
+    x = bcd(10);
+    x.div(bcd(4), 0, informave::utils::BCD_ROUND_HALF_EVEN);
+    CXXC_CHECK( x == bcd(2) );
+
+    x = bcd(-10);
+    x.div(bcd(3), 0, informave::utils::BCD_ROUND_UP);
+    CXXC_CHECK( x == bcd(-4) );
+
+    x = bcd(-10);
+    x.div(bcd(3), 2, informave::utils::BCD_ROUND_DOWN);
+    CXXC_CHECK( x == bcd("-3.33") );
+
+    CXXC_CHECK_THROW( std::domain_error, bcd(1) / bcd(0) );
+}
+
+
 CXXC_TEST(Important)
 {
 
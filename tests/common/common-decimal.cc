@@ -0,0 +1,245 @@
+#include <dbwtl/dbobjects>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include "../cxxc.hh"
+
+
+#if defined(INFORMAVE_HAVE_DECIMAL128)
+
+using informave::utils::decimal;
+using informave::utils::bcd;
+
+
+CXXC_TEST(Addition)
+{
+    CXXC_CHECK( decimal(159) + decimal(41) == decimal(200) );
+
+    CXXC_CHECK( decimal(159) + decimal(41) != decimal(100) );
+
+    CXXC_CHECK( decimal(9999) + decimal(1) == decimal(10000) );
+
+    CXXC_CHECK( decimal("1.0001").scale() == 4 );
+
+    CXXC_CHECK( decimal(9999) + decimal("1.001") == decimal("10000.001") );
+
+    CXXC_CHECK( decimal(33) + decimal(-35) == decimal("-2") );
+    CXXC_CHECK( decimal(-33) + decimal(-2) == decimal("-35") );
+    CXXC_CHECK( decimal(33) + decimal(-2) == decimal("31") );
+    CXXC_CHECK( decimal(-33) + decimal(2) == decimal("-31") );
+}
+
+
+CXXC_TEST(Subtraction)
+{
+    CXXC_CHECK( decimal(101) - decimal(4) == decimal(97) );
+
+    CXXC_CHECK( decimal(10) - decimal(10) == decimal(0) );
+
+    CXXC_CHECK( decimal("1.345") - decimal("0.045") == decimal("1.300") );
+
+    CXXC_CHECK( decimal(2) - decimal("0.10000000000000000001") == decimal("1.89999999999999999999") );
+
+    CXXC_CHECK( decimal(5) - decimal(8) == decimal("-3") );
+
+    CXXC_CHECK( decimal("4016783.28276") - decimal("9267.1825267392671935261936711782")
+                == decimal("4007516.1002332607328064738063288218") );
+
+    CXXC_CHECK( decimal(-33) - decimal(-2) == decimal("-31") );
+    CXXC_CHECK( decimal(33) - decimal(-2) == decimal("35") );
+    CXXC_CHECK( decimal(-33) - decimal(2) == decimal("-35") );
+}
+
+
+CXXC_TEST(Multiplication)
+{
+    CXXC_CHECK( decimal(100) * decimal("2.5") == decimal(250) );
+
+    CXXC_CHECK( decimal(1) * decimal("0") == decimal(0) );
+
+    CXXC_CHECK( decimal("12398.00028736") * decimal("0.9172860267") == decimal("11372.512422617912632512") );
+
+    CXXC_CHECK( decimal("0.000000000000000000000000000000001") * decimal(3)
+                == decimal("0.000000000000000000000000000000003") );
+
+    CXXC_CHECK( decimal(-33) * decimal(-2) == decimal("66") );
+    CXXC_CHECK( decimal(33) * decimal(-2) == decimal("-66") );
+}
+
+
+CXXC_TEST(Division)
+{
+    CXXC_CHECK( decimal(10) / decimal(2) == decimal(5) );
+
+    CXXC_CHECK( decimal(98) / decimal("2.5") == decimal("39.2") );
+
+    CXXC_CHECK( decimal(-33) / decimal(2) == decimal("-16.5") );
+
+    CXXC_CHECK( decimal(1) / decimal(3) == decimal("0.33333333333333") );
+
+    CXXC_CHECK( divi(decimal(5963776), decimal(65536)) == 91 );
+
+    CXXC_CHECK( decimal(17) % decimal(5) == decimal(2) );
+
+    CXXC_CHECK( decimal("7.5") % decimal(2) == decimal("1.5") );
+
+    CXXC_CHECK_THROW( std::domain_error, decimal(1) / decimal(0) );
+}
+
+
+CXXC_TEST(DivisionScale)
+{
+    decimal x(10);
+    x.div(decimal(4), 4, informave::utils::BCD_ROUND_HALF_UP);
+    CXXC_CHECK( x.str(std::locale("C")) == "2.5000" );
+
+    x = decimal(10);
+    x.div(decimal(4), 0, informave::utils::BCD_ROUND_HALF_EVEN);
+    CXXC_CHECK( x == decimal(2) );
+
+    x = decimal(-10);
+    x.div(decimal(3), 0, informave::utils::BCD_ROUND_UP);
+    CXXC_CHECK( x == decimal(-4) );
+
+    x = decimal(-10);
+    x.div(decimal(3), 2, informave::utils::BCD_ROUND_DOWN);
+    CXXC_CHECK( x == decimal("-3.33") );
+
+    x = decimal("99999999999999999999999999999999999999", std::locale("C"));
+    x.div(decimal(3), 2, informave::utils::BCD_ROUND_HALF_UP);
+    CXXC_CHECK( x.is_wide() );
+    CXXC_CHECK( x.str(std::locale("C")) == "33333333333333333333333333333333333333.00" );
+}
+
+
+CXXC_TEST(Compare)
+{
+    CXXC_CHECK( decimal(5) > decimal(4) );
+
+    CXXC_CHECK( decimal("1.3000") == decimal("1.3") );
+
+    CXXC_CHECK( decimal("0.0004") < decimal("0.003") );
+
+    CXXC_CHECK( decimal("-5") < decimal("-4") );
+
+    CXXC_CHECK( decimal(39) > decimal("-0.39") );
+}
+
+
+CXXC_TEST(Convert)
+{
+    CXXC_CHECK( decimal(5).convert<int>() == int(5) );
+
+    CXXC_CHECK( decimal("-1234.56").asLongLong() == -1234 );
+
+    CXXC_CHECK( decimal("-1234.5").asDouble() == -1234.5 );
+
+    CXXC_CHECK( decimal::from_double(0.1) == decimal("0.1") );
+
+    CXXC_CHECK( decimal::from_double(-2.25).str(std::locale("C")) == "-2.25" );
+
+    CXXC_CHECK( decimal(12345, 2).str(std::locale("C")) == "123.45" );
+
+    CXXC_CHECK( decimal(5, 3).str(std::locale("C")) == "0.005" );
+
+    decimal d("123.456");
+    d.rescale(2);
+    CXXC_CHECK( d.str(std::locale("C")) == "123.46" );
+    d.zeroscale();
+    CXXC_CHECK( d == decimal(12346) );
+}
+
+
+CXXC_TEST(WideFallback)
+{
+    const std::string big = "123456789012345678901234567890123456789012";
+
+    decimal a(big, std::locale("C"));
+    CXXC_CHECK( a.is_wide() );
+    CXXC_CHECK( a.str(std::locale("C")) == big );
+
+    decimal b = a + decimal(1);
+    CXXC_CHECK( b.is_wide() );
+    CXXC_CHECK( b - a == decimal(1) );
+    CXXC_CHECK( ! (b - a).is_wide() );
+
+    decimal c("99999999999999999999999999999999999999", std::locale("C"));
+    CXXC_CHECK( ! c.is_wide() );
+    CXXC_CHECK( (c + decimal(1)).is_wide() );
+    CXXC_CHECK( (c + decimal(1)).str(std::locale("C")) == "100000000000000000000000000000000000000" );
+
+    CXXC_CHECK( decimal(bcd("42.5")) == decimal("42.5") );
+}
+
+
+CXXC_TEST(IntegralRange)
+{
+    CXXC_CHECK( decimal("9223372036854775807").asLongLong() == std::numeric_limits<long long>::max() );
+    CXXC_CHECK( decimal("-9223372036854775808").asLongLong() == std::numeric_limits<long long>::min() );
+    CXXC_CHECK_THROW( std::out_of_range, decimal("9223372036854775808").asLongLong() );
+    CXXC_CHECK_THROW( std::out_of_range, decimal("-9223372036854775809").asLongLong() );
+    CXXC_CHECK( decimal("-128.7").convert<signed char>() == -128 );
+    CXXC_CHECK_THROW( std::out_of_range, decimal("300").convert<unsigned char>() );
+    CXXC_CHECK_THROW( std::out_of_range, decimal("-1").convert<unsigned int>() );
+
+    decimal w("1.000000000000000000000000000000000000000001", std::locale("C"));
+    CXXC_CHECK( w.is_wide() );
+    CXXC_CHECK( w.asLongLong() == 1 );
+    CXXC_CHECK_THROW( std::out_of_range, decimal("123456789012345678901234567890123456789012",
+                                                 std::locale("C")).asLongLong() );
+    CXXC_CHECK_THROW( std::out_of_range, bcd("9223372036854775808").asLongLong() );
+
+    using namespace informave::db;
+    CXXC_CHECK_THROW( ConvertException, Variant(TNumeric("99999999999999999999")).get<signed long long>() );
+    CXXC_CHECK( Variant(TNumeric("-42.5")).get<signed long long>() == -42 );
+}
+
+
+CXXC_TEST(RescaleBcdAndDecimal)
+{
+    // raising the scale keeps the value in both backends
+    decimal d("1.5");
+    d.rescale(3);
+    CXXC_CHECK( d.str(std::locale("C")) == "1.500" );
+    CXXC_CHECK( d == decimal("1.5") );
+
+    bcd b("1.5");
+    b.rescale(3);
+    CXXC_CHECK( b.str(std::locale("C")) == "1.500" );
+    CXXC_CHECK( b == bcd("1.5") );
+
+    informave::db::TNumeric n("123");
+    n.rescale(2);
+    CXXC_CHECK( n.str(std::locale("C")) == "123.00" );
+    CXXC_CHECK( n == informave::db::TNumeric("123") );
+
+    decimal r("123.456");
+    bcd rb("123.456");
+    r.rescale(2);
+    rb.rescale(2);
+    CXXC_CHECK( r.str(std::locale("C")) == rb.str(std::locale("C")) );
+
+    // more than max_digits digits are stored as BCD
+    decimal big("99999999999999999999999999999999999", std::locale("C"));
+    big.rescale(5);
+    CXXC_CHECK( big.is_wide() );
+    CXXC_CHECK( big.str(std::locale("C")) == "99999999999999999999999999999999999.00000" );
+}
+
+#endif
+
+
+int main(void)
+{
+    return cxxc::runAll();
+}
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
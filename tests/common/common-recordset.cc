@@ -2,6 +2,8 @@
 #include <dbwtl/dal/engines/generic>
 #include"../cxxc.hh"
 
+#include <cstdio>
+
 
 using namespace informave::db;
 
@@ -115,6 +117,527 @@ CXXC_TEST(RecordsetScroll)
 #endif
 
 
+CXXC_TEST(RecordsetColumnStorage)
+{
+	RecordSet rows;
+	RecordSet cols(DBWTL_STORAGE_COLUMNS);
+	CXXC_CHECK( cols.getStorage() == DBWTL_STORAGE_COLUMNS );
+	rows.open();
+	cols.open();
+	for(int i = 0; i < 1000; ++i)
+	{
+		ShrRecord rec({Variant(i), Variant(String("row")), Variant(double(i) / 2)});
+		if(i % 10 == 0)
+			rec[1] = Variant();
+		rows.insert(rec);
+		cols.insert(rec);
+	}
+	CXXC_CHECK( cols.rowCount() == 1000 );
+	CXXC_CHECK( cols.columnCount() == 3 );
+	CXXC_CHECK( cols.columns().columnType(0) == DAL_TYPE_INT );
+	CXXC_CHECK( cols.columns().columnType(1) == DAL_TYPE_STRING );
+	CXXC_CHECK( cols.columns().columnType(2) == DAL_TYPE_DOUBLE );
+	CXXC_CHECK( cols.columns().memoryUsage() > 0 );
+	CXXC_CHECK_THROW( EngineException, cols.setStorage(DBWTL_STORAGE_ROWS) );
+
+	cols.first();
+	CXXC_CHECK( cols.column(1).get<int>() == 0 );
+	CXXC_CHECK( cols.column(2).isnull() );
+	cols.next();
+	CXXC_CHECK( cols.column(1).get<int>() == 1 );
+	CXXC_CHECK( cols.column(2).get<String>() == std::string("row") );
+	CXXC_CHECK( cols.column(3).get<double>() == 0.5 );
+	cols.setpos(500);
+	CXXC_CHECK( cols.column(1).get<int>() == 499 );
+	cols.prev();
+	CXXC_CHECK( cols.column(1).get<int>() == 498 );
+	cols.last();
+	CXXC_CHECK( cols.column(1).get<int>() == 999 );
+	cols.next();
+	CXXC_CHECK( cols.eof() );
+
+	// a value of a different type turns the column into a Variant column
+	cols.insert(ShrRecord({Variant(String("x")), Variant(String("y")), Variant(1.5)}));
+	CXXC_CHECK( cols.columns().columnType(0) == DAL_TYPE_UNKNOWN );
+	cols.setpos(2);
+	CXXC_CHECK( cols.column(1).get<int>() == 1 );
+	cols.last();
+	CXXC_CHECK( cols.column(1).get<String>() == std::string("x") );
+
+	CXXC_CHECK_THROW( EngineException, cols.insert(ShrRecord({Variant(1)})) );
+
+	// column storage is written by cell
+	const std::string path = "common-recordset-columns-snapshot.bin";
+	cols.saveSnapshot(path);
+	RecordSet snap;
+	snap.loadSnapshot(path);
+	CXXC_CHECK( snap.rowCount() == 1001 );
+	snap.setpos(500);
+	CXXC_CHECK( snap.column(1).get<int>() == 499 );
+	CXXC_CHECK( snap.column(3).get<double>() == 249.5 );
+	snap.last();
+	CXXC_CHECK( snap.column(1).get<String>() == std::string("x") );
+	snap.clear();
+	std::remove(path.c_str());
+
+	cols.clear();
+	CXXC_CHECK( cols.columns().rowCount() == 0 );
+	cols.setStorage(DBWTL_STORAGE_ROWS);
+}
+
+
+CXXC_TEST(SpillStorePaging)
+{
+	SpillStore store;
+	store.setPageSize(16);
+	store.setMemoryLimit(4096);
+	CXXC_CHECK_THROW( EngineException, store.setPageSize(0) );
+
+	for(int i = 0; i < 2000; ++i)
+	{
+		ShrRecord rec({Variant(i), Variant(String("text \xc3\xa4")), Variant(double(i) / 4),
+					Variant(), Variant(TDate(2020, 1, 1 + i % 28)), Variant(TNumeric(i)),
+					Variant(Blob("\0\1\2", 3))});
+		store.append(rec);
+	}
+	CXXC_CHECK_THROW( EngineException, store.setPageSize(8) );
+	CXXC_CHECK( store.rowCount() == 2000 );
+	CXXC_CHECK( store.spilledPages() > 0 );
+	CXXC_CHECK( store.residentPages() < 2000 / 16 );
+
+	// backwards, every page is read from the file
+	for(int i = 1999; i >= 0; i -= 7)
+	{
+		ShrRecord rec = store.get(i);
+		CXXC_CHECK( rec[0].get<int>() == i );
+		CXXC_CHECK( rec[1].get<String>() == String("text \xc3\xa4") );
+		CXXC_CHECK( rec[2].get<double>() == double(i) / 4 );
+		CXXC_CHECK( rec[3].isnull() );
+		CXXC_CHECK( rec[4].datatype() == DAL_TYPE_DATE );
+		CXXC_CHECK( rec[4].get<TDate>() == TDate(2020, 1, 1 + i % 28) );
+		CXXC_CHECK( rec[5].get<TNumeric>() == TNumeric(i) );
+		CXXC_CHECK( rec[6].datatype() == DAL_TYPE_BLOB );
+	}
+	CXXC_CHECK_THROW( EngineException, store.get(2000) );
+
+	SpillStore copy(store);
+	CXXC_CHECK( copy.rowCount() == 2000 );
+	CXXC_CHECK( copy.get(3)[0].get<int>() == 3 );
+
+	store.clear();
+	CXXC_CHECK( store.rowCount() == 0 );
+	CXXC_CHECK( store.spilledPages() == 0 );
+}
+
+
+CXXC_TEST(SpillStoreLobSize)
+{
+	// the memory limit counts the size of BLOB and MEMO buffers
+	SpillStore store;
+	store.setPageSize(4);
+	store.setMemoryLimit(64 * 1024);
+
+	const std::string data(16 * 1024, 'x');
+	for(int i = 0; i < 64; ++i)
+	{
+		ShrRecord rec({Variant(i), Variant(Blob(data.data(), data.size())),
+					Variant(Memo(Variant(String(data))))});
+		store.append(rec);
+	}
+	CXXC_CHECK( store.spilledPages() > 0 );
+	CXXC_CHECK( store.residentPages() < 64 / 4 );
+
+	ShrRecord rec = store.get(5);
+	CXXC_CHECK( rec[0].get<int>() == 5 );
+	CXXC_CHECK( rec[1].datatype() == DAL_TYPE_BLOB );
+	CXXC_CHECK( rec[2].get<String>() == String(data) );
+}
+
+
+CXXC_TEST(RecordsetSpillStorage)
+{
+	RecordSet rs(DBWTL_STORAGE_SPILL);
+	rs.setMemoryLimit(16 * 1024);
+	rs.open();
+	for(int i = 1; i <= 5000; ++i)
+		rs.insert(ShrRecord({Variant(i), Variant(String("some row text"))}));
+
+	CXXC_CHECK( rs.rowCount() == 5000 );
+	CXXC_CHECK( rs.spilled().spilledPages() > 0 );
+
+	rs.first();
+	CXXC_CHECK( rs.column(1).get<int>() == 1 );
+	rs.last();
+	CXXC_CHECK( rs.column(1).get<int>() == 5000 );
+	rs.setpos(10);
+	CXXC_CHECK( rs.column(1).get<int>() == 10 );
+	CXXC_CHECK( rs.column(2).get<String>() == String("some row text") );
+	rs.prev();
+	CXXC_CHECK( rs.column(1).get<int>() == 9 );
+	rs.setpos(4000);
+	rs.next();
+	CXXC_CHECK( rs.column(1).get<int>() == 4001 );
+
+	// spilled rows are read once for a snapshot
+	const std::string path = "common-recordset-spill-snapshot.bin";
+	rs.saveSnapshot(path);
+	RecordSet snap;
+	snap.loadSnapshot(path);
+	CXXC_CHECK( snap.rowCount() == 5000 );
+	snap.setpos(4001);
+	CXXC_CHECK( snap.column(1).get<int>() == 4001 );
+	CXXC_CHECK( snap.column(2).get<String>() == String("some row text") );
+	snap.clear();
+	std::remove(path.c_str());
+
+	rs.clear();
+	CXXC_CHECK( rs.rowCount() == 0 );
+	rs.open();
+	rs.insert(ShrRecord({Variant(7), Variant(String("x"))}));
+	rs.first();
+	CXXC_CHECK( rs.column(1).get<int>() == 7 );
+}
+
+
+CXXC_TEST(RecordsetSnapshot)
+{
+	const std::string path = "common-recordset-snapshot.bin";
+
+	RecordSet src;
+	src.setColumnCount(5);
+	src.modifyColumnDesc(1, DBWTL_COLUMNDESC_NAME, String("id"));
+	src.modifyColumnDesc(2, DBWTL_COLUMNDESC_NAME, String("name"));
+	src.modifyColumnDesc(3, DBWTL_COLUMNDESC_NAME, String("price"));
+	src.modifyColumnDesc(4, DBWTL_COLUMNDESC_NAME, String("mixed"));
+	src.modifyColumnDesc(5, DBWTL_COLUMNDESC_NAME, String("day"));
+	src.setDatatype(1, DAL_TYPE_INT);
+	src.setDatatype(3, DAL_TYPE_DOUBLE);
+	src.open();
+	for(int i = 0; i < 100; ++i)
+	{
+		ShrRecord rec({Variant(i), Variant(String("row \xc3\xa4")), Variant(double(i) / 4),
+					Variant(i), Variant(TDate(2010, 1, 1 + i % 28))});
+		if(i % 2)
+			rec[3] = Variant(String("odd"));
+		if(i % 10 == 0)
+			rec[1] = Variant();
+		src.insert(rec);
+	}
+	src.saveSnapshot(path);
+
+	RecordSet snap;
+	snap.loadSnapshot(path);
+	CXXC_CHECK( snap.getStorage() == DBWTL_STORAGE_SNAPSHOT );
+	CXXC_CHECK( snap.rowCount() == 100 );
+	CXXC_CHECK( snap.columnCount() == 5 );
+	CXXC_CHECK( snap.describeColumn(2).getName().asStr() == String("name") );
+	CXXC_CHECK( snap.describeColumn(1).getDatatype() == DAL_TYPE_INT );
+	CXXC_CHECK( snap.describeColumn(3).getDatatype() == DAL_TYPE_DOUBLE );
+
+	snap.first();
+	CXXC_CHECK( snap.column("id").get<int>() == 0 );
+	CXXC_CHECK( snap.column("name").isnull() );
+	CXXC_CHECK( snap.column("mixed").get<int>() == 0 );
+	snap.next();
+	CXXC_CHECK( snap.column("name").get<String>() == String("row \xc3\xa4") );
+	CXXC_CHECK( snap.column("price").get<double>() == 0.25 );
+	CXXC_CHECK( snap.column("mixed").get<String>() == String("odd") );
+	snap.setpos(56);
+	CXXC_CHECK( snap.column(1).get<int>() == 55 );
+	CXXC_CHECK( snap.column(5).get<TDate>() == TDate(2010, 1, 28) );
+	snap.last();
+	CXXC_CHECK( snap.column(1).get<int>() == 99 );
+	CXXC_CHECK( snap.getRecord(3)[2].get<double>() == 0.5 );
+
+	CXXC_CHECK_THROW( EngineException, snap.insert(ShrRecord({Variant(1), Variant(), Variant(),
+													   Variant(), Variant()})) );
+	CXXC_CHECK_THROW( EngineException, src.loadSnapshot(path) );
+
+	// snapshots are written by cell from snapshot storage
+	const std::string copy_path = "common-recordset-snapshot-copy.bin";
+	snap.saveSnapshot(copy_path);
+	RecordSet copy;
+	copy.loadSnapshot(copy_path);
+	CXXC_CHECK( copy.rowCount() == 100 );
+	copy.setpos(56);
+	CXXC_CHECK( copy.column("id").get<int>() == 55 );
+	CXXC_CHECK( copy.column("mixed").get<String>() == String("odd") );
+	CXXC_CHECK( copy.column("day").get<TDate>() == TDate(2010, 1, 28) );
+	CXXC_CHECK( copy.getRecord(11)[1].isnull() );
+	copy.clear();
+	std::remove(copy_path.c_str());
+
+	snap.clear();
+	CXXC_CHECK( snap.rowCount() == 0 );
+	std::remove(path.c_str());
+
+	CXXC_CHECK_THROW( EngineException, snap.loadSnapshot(path) );
+}
+
+
+CXXC_TEST(RecordsetIndexes)
+{
+	RecordSet rs;
+	rs.open();
+	for(int i = 1; i <= 50; ++i)
+		rs.insert(ShrRecord({Variant(i), Variant(String(i % 2 ? "odd" : "even")), Variant(i % 5)}));
+
+	std::vector<colnum_t> id(1, 1);
+	std::vector<colnum_t> parity_mod;
+	parity_mod.push_back(2);
+	parity_mod.push_back(3);
+
+	rs.createIndex("id", DBWTL_INDEX_HASH, id);
+	rs.createIndex("parity", DBWTL_INDEX_ORDERED, parity_mod);
+	CXXC_CHECK_THROW( EngineException, rs.createIndex("id", DBWTL_INDEX_HASH, id) );
+	CXXC_CHECK_THROW( EngineException, rs.createIndex("bad", DBWTL_INDEX_HASH, std::vector<colnum_t>(1, 4)) );
+	CXXC_CHECK( rs.getIndex("id").size() == 50 );
+
+	// keys of other numeric types match by value
+	CXXC_CHECK( rs.seek("id", Variant(20)) );
+	CXXC_CHECK( rs.column(1).get<int>() == 20 );
+	CXXC_CHECK( rs.seek("id", Variant(static_cast<signed long long>(21))) );
+	CXXC_CHECK( rs.column(1).get<int>() == 21 );
+	CXXC_CHECK( rs.seek("id", Variant(22.0)) );
+	CXXC_CHECK( rs.column(1).get<int>() == 22 );
+	CXXC_CHECK( ! rs.seek("id", Variant(22.5)) );
+	CXXC_CHECK( rs.column(1).get<int>() == 22 );
+	CXXC_CHECK_THROW( NotFoundException, rs.seek("foo", Variant(1)) );
+
+	// incremental maintenance
+	rs.insert(ShrRecord({Variant(51), Variant(), Variant(1)}));
+	CXXC_CHECK( rs.seek("id", Variant(51)) );
+	CXXC_CHECK( rs.column(2).isnull() );
+
+	RecordIndex::key_type key;
+	key.push_back(Variant(String("odd")));
+	CXXC_CHECK( rs.lookup("parity", key).size() == 25 );
+	key.push_back(Variant(3));
+	RecordIndex::rowlist_type rows = rs.lookup("parity", key);
+	CXXC_CHECK( rows.size() == 5 );
+	CXXC_CHECK( rows.front() == 3 && rows.back() == 43 );
+
+	// ("even", 3) <= key <= ("odd", 0), NULL sorts first
+	RecordIndex::key_type lower, upper;
+	lower.push_back(Variant(String("even")));
+	lower.push_back(Variant(3));
+	upper.push_back(Variant(String("odd")));
+	upper.push_back(Variant(0));
+	rows = rs.lookupRange("parity", lower, upper);
+	CXXC_CHECK( rows.size() == 15 );
+	CXXC_CHECK( rs.lookupRange("parity", RecordIndex::key_type(), RecordIndex::key_type()).size() == 51 );
+	CXXC_CHECK( rs.lookupRange("parity", RecordIndex::key_type(), lower).front() == 51 );
+	CXXC_CHECK_THROW( EngineException, rs.lookupRange("id", lower, upper) );
+
+	rs.dropIndex("parity");
+	CXXC_CHECK_THROW( NotFoundException, rs.getIndex("parity") );
+
+	// clear() keeps the definition, column storage is indexed as well
+	rs.clear();
+	rs.setStorage(DBWTL_STORAGE_COLUMNS);
+	rs.open();
+	CXXC_CHECK( rs.getIndex("id").size() == 0 );
+	rs.insert(ShrRecord({Variant(7), Variant(String("x")), Variant(0)}));
+	CXXC_CHECK( rs.seek("id", Variant(7)) );
+	CXXC_CHECK( rs.column(2).get<String>() == String("x") );
+}
+
+
+CXXC_TEST(RecordsetOps)
+{
+	RecordSet rs;
+	rs.setColumnCount(3);
+	rs.modifyColumnDesc(1, DBWTL_COLUMNDESC_NAME, String("id"));
+	rs.modifyColumnDesc(2, DBWTL_COLUMNDESC_NAME, String("grp"));
+	rs.modifyColumnDesc(3, DBWTL_COLUMNDESC_NAME, String("val"));
+	rs.setDatatype(1, DAL_TYPE_INT);
+	rs.open();
+	const char *groups[] = { "b", "a", "c", "a", "b", "a" };
+	for(int i = 0; i < 6; ++i)
+	{
+		ShrRecord rec({Variant(i + 1), Variant(String(groups[i])), Variant(double(i) * 1.5)});
+		if(i == 2)
+			rec[2] = Variant();
+		rs.insert(rec);
+	}
+
+	// grp ascending, val descending, stable for equal keys
+	std::vector<RecordSortKey> keys;
+	keys.push_back(RecordSortKey(2));
+	keys.push_back(RecordSortKey(3, true));
+	RecordSet sorted;
+	RecordSetOps::sort(rs, keys, sorted);
+	CXXC_CHECK( sorted.rowCount() == 6 );
+	CXXC_CHECK( sorted.columnName(2) == String("grp") );
+	const int expected[] = { 6, 4, 2, 5, 1, 3 };
+	int pos = 0;
+	for(sorted.first(); !sorted.eof(); sorted.next())
+		CXXC_CHECK( sorted.column("id").get<int>() == expected[pos++] );
+
+	// NULL sorts first, mixed types fall back to Variant comparisons
+	RecordSetOps::rowlist_type order;
+	RecordSetOps::sortRows(rs, std::vector<RecordSortKey>(1, RecordSortKey(3)), order);
+	CXXC_CHECK( order.front() == 3 && order.back() == 6 );
+	rs.insert(ShrRecord({Variant(7), Variant(String("c")), Variant(2)}));
+	RecordSetOps::sortRows(rs, std::vector<RecordSortKey>(1, RecordSortKey(3)), order);
+	CXXC_CHECK( order[1] == 1 && order[2] == 2 && order[3] == 7 );
+
+	RecordSet filtered;
+	RecordSetOps::filter(rs, ColumnMatchFilter<String>("grp", String("a")), filtered);
+	CXXC_CHECK( filtered.rowCount() == 3 );
+	filtered.first();
+	CXXC_CHECK( filtered.column("id").get<int>() == 2 );
+
+	std::vector<RecordAggregate> aggs;
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_COUNT, 0));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_COUNT, 3, "nonnull"));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_SUM, 1));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_MIN, 3));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_MAX, 3));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_AVG, 3));
+	RecordSet grouped;
+	RecordSetOps::groupBy(rs, std::vector<colnum_t>(1, 2), aggs, grouped);
+	CXXC_CHECK( grouped.rowCount() == 3 );
+	CXXC_CHECK( grouped.columnCount() == 7 );
+	CXXC_CHECK( grouped.columnName(2) == String("COUNT(*)") );
+	CXXC_CHECK( grouped.columnName(4) == String("SUM(id)") );
+	CXXC_CHECK( grouped.describeColumn(4).getDatatype() == DAL_TYPE_BIGINT );
+
+	grouped.first();
+	CXXC_CHECK( grouped.column("grp").get<String>() == String("b") );
+	CXXC_CHECK( grouped.column("COUNT(*)").get<int>() == 2 );
+	CXXC_CHECK( grouped.column("SUM(id)").get<int>() == 6 );
+	CXXC_CHECK( grouped.column("AVG(val)").get<double>() == 3.0 );
+	grouped.next();
+	CXXC_CHECK( grouped.column("grp").get<String>() == String("a") );
+	CXXC_CHECK( grouped.column("MIN(val)").get<double>() == 1.5 );
+	CXXC_CHECK( grouped.column("MAX(val)").get<double>() == 7.5 );
+	grouped.next();
+	CXXC_CHECK( grouped.column("grp").get<String>() == String("c") );
+	CXXC_CHECK( grouped.column("COUNT(*)").get<int>() == 2 );
+	CXXC_CHECK( grouped.column("nonnull").get<int>() == 1 );
+	CXXC_CHECK( grouped.column("MIN(val)").get<int>() == 2 );
+
+	CXXC_CHECK_THROW( EngineException, RecordSetOps::groupBy(rs, std::vector<colnum_t>(1, 4), aggs, grouped) );
+}
+
+
+CXXC_TEST(RecordsetColumnIndex)
+{
+	RecordSet rs;
+	rs.setColumnCount(3);
+	rs.modifyColumnDesc(1, DBWTL_COLUMNDESC_NAME, String("id"));
+	rs.modifyColumnDesc(2, DBWTL_COLUMNDESC_NAME, String("Name"));
+	rs.modifyColumnDesc(3, DBWTL_COLUMNDESC_NAME, String("name"));
+	rs.open();
+
+	// columnID() is case-sensitive
+	CXXC_CHECK( rs.columnID("Name") == 2 );
+	CXXC_CHECK( rs.columnID("name") == 3 );
+	CXXC_CHECK_THROW( NotFoundException, rs.columnID("NAME") );
+
+	ColumnIndex index;
+	index.build(rs);
+	CXXC_CHECK( index.find("id") == 1 );
+	CXXC_CHECK( index.find("ID") == 0 );
+	CXXC_CHECK( index.find("name") == 3 );
+	CXXC_CHECK( index.find("foo") == 0 );
+}
+
+
+CXXC_TEST(RecordsetOpsParallel)
+{
+	// more than two workers with PARALLEL_MIN_ROWS (1024) rows each,
+	// many equal keys and NULLs in both key columns
+	const int rows = 5000;
+	RecordSet rs;
+	rs.setColumnCount(3);
+	rs.modifyColumnDesc(1, DBWTL_COLUMNDESC_NAME, String("id"));
+	rs.modifyColumnDesc(2, DBWTL_COLUMNDESC_NAME, String("grp"));
+	rs.modifyColumnDesc(3, DBWTL_COLUMNDESC_NAME, String("val"));
+	rs.setDatatype(1, DAL_TYPE_INT);
+	rs.open();
+	const char *groups[] = { "d", "a", "c", "b" };
+	unsigned int x = 4711;
+	for(int i = 0; i < rows; ++i)
+	{
+		x = x * 1103515245 + 12345;
+		ShrRecord rec({Variant(i + 1), Variant(String(groups[(x >> 8) % 4])),
+					Variant(double((x >> 12) % 7))});
+		if((x >> 16) % 11 == 0)
+			rec[1] = Variant();
+		if((x >> 20) % 13 == 0)
+			rec[2] = Variant();
+		rs.insert(rec);
+	}
+
+	std::vector<RecordSortKey> keys;
+	keys.push_back(RecordSortKey(2));
+	keys.push_back(RecordSortKey(3, true));
+
+	RecordSetOps::rowlist_type expected;
+	RecordSetOps::sortRows(rs, keys, expected, 1);
+	CXXC_CHECK( expected.size() == size_t(rows) );
+
+	// equal keys keep their input order
+	for(size_t i = 1; i < expected.size(); ++i)
+	{
+		rs.setpos(expected[i-1]);
+		Variant grp = rs.column(2), val = rs.column(3);
+		rs.setpos(expected[i]);
+		if(grp.isnull() == rs.column(2).isnull() && val.isnull() == rs.column(3).isnull() &&
+		   (grp.isnull() || grp.get<String>() == rs.column(2).get<String>()) &&
+		   (val.isnull() || val.get<double>() == rs.column(3).get<double>()))
+		{
+			CXXC_CHECK( expected[i-1] < expected[i] );
+		}
+	}
+	rs.setpos(expected.front());
+	CXXC_CHECK( rs.column(2).isnull() );
+
+	std::vector<RecordAggregate> aggs;
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_COUNT, 0));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_COUNT, 3, "nonnull"));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_SUM, 1));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_MIN, 3));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_MAX, 3));
+	aggs.push_back(RecordAggregate(DBWTL_AGGREGATE_AVG, 3));
+	RecordSet expected_groups;
+	RecordSetOps::groupBy(rs, std::vector<colnum_t>(1, 2), aggs, expected_groups, 1);
+	CXXC_CHECK( expected_groups.rowCount() == 5 );
+
+	const size_t threads[] = { 2, 3, 4 };
+	for(size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); ++t)
+	{
+		RecordSetOps::rowlist_type order;
+		RecordSetOps::sortRows(rs, keys, order, threads[t]);
+		CXXC_CHECK( order == expected );
+
+		RecordSet sorted;
+		RecordSetOps::sort(rs, keys, sorted, threads[t]);
+		CXXC_CHECK( sorted.rowCount() == rows );
+		size_t pos = 0;
+		for(sorted.first(); !sorted.eof(); sorted.next())
+			CXXC_CHECK( sorted.column(1).get<int>() == expected[pos++] );
+
+		RecordSet grouped;
+		RecordSetOps::groupBy(rs, std::vector<colnum_t>(1, 2), aggs, grouped, threads[t]);
+		CXXC_CHECK( grouped.rowCount() == expected_groups.rowCount() );
+		for(grouped.first(), expected_groups.first(); !grouped.eof(); grouped.next(), expected_groups.next())
+		{
+			for(colnum_t c = 1; c <= grouped.columnCount(); ++c)
+			{
+				CXXC_CHECK( grouped.column(c).isnull() == expected_groups.column(c).isnull() );
+				if(! grouped.column(c).isnull())
+				{
+					CXXC_CHECK( grouped.column(c).get<String>() == expected_groups.column(c).get<String>() );
+				}
+			}
+		}
+	}
+}
+
+
 int main(void)
 {
     std::locale::global(std::locale(""));
@@ -35,6 +35,45 @@ CXXC_TEST(RecordCopy)
 	CXXC_CHECK(r1[1].get<int>() == r2[1].get<int>());
 }
 
+CXXC_TEST(RecordCopyOnWrite)
+{
+    ShrRecord r1(2);
+    r1[0] = Variant(1);
+    r1[1] = Variant(String("a"));
+
+    ShrRecord r2(r1);
+    CXXC_CHECK( ! r1.unique() );
+    CXXC_CHECK( &r1.getbuf() != &r2.getbuf() );
+
+    // reading through const references does not copy
+    ShrRecord r3(r1);
+    const ShrRecord &c1 = r1;
+    const ShrRecord &c3 = r3;
+    CXXC_CHECK( &c1[0] == &c3[0] );
+    CXXC_CHECK( c3[1].get<String>() == String("a") );
+
+    r3[0] = Variant(2);
+    CXXC_CHECK( r1[0].get<int>() == 1 );
+    CXXC_CHECK( r3[0].get<int>() == 2 );
+    CXXC_CHECK( r3.unique() );
+
+    ShrRecord r4(r3);
+    r4.clear();
+    CXXC_CHECK( r4.size() == 0 );
+    CXXC_CHECK( r3.size() == 2 );
+
+    // insert() shares the buffer, later changes do not reach the RecordSet
+    RecordSet rs;
+    rs.open();
+    rs.insert(r3);
+    CXXC_CHECK( ! r3.unique() );
+    r3[0] = Variant(3);
+    rs.first();
+    CXXC_CHECK( rs.column(1).get<int>() == 2 );
+    CXXC_CHECK( rs.getRecord(1)[0].get<int>() == 2 );
+}
+
+
 CXXC_TEST(RecordClear)
 {
     ShrRecord r1;
@@ -0,0 +1,148 @@
+#include <dbwtl/dal/dalinterface>
+#include <dbwtl/ustring>
+
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+
+#include "../cxxc.hh"
+
+
+using namespace informave::db;
+
+
+CXXC_TEST(NarrowCache)
+{
+    String s("abc\xc3\xa4");
+
+    const char *p = s.utf8();
+    CXXC_CHECK( std::strcmp(p, "abc\xc3\xa4") == 0 );
+    CXXC_CHECK( s.utf8() == p );
+    CXXC_CHECK( s.to("UTF-8") == p );
+
+    CXXC_CHECK( std::strcmp(s.to("ISO-8859-1"), "abc\xe4") == 0 );
+    CXXC_CHECK( std::strcmp(s.utf8(), "abc\xc3\xa4") == 0 );
+
+    s += String("x");
+    CXXC_CHECK( std::strcmp(s.utf8(), "abc\xc3\xa4x") == 0 );
+
+    s = String("def");
+    CXXC_CHECK( std::strcmp(s.utf8(), "def") == 0 );
+
+    s.loadUTF8("ghi");
+    CXXC_CHECK( std::strcmp(s.utf8(), "ghi") == 0 );
+
+    s.ref()[0] = 'j';
+    CXXC_CHECK( std::strcmp(s.utf8(), "jhi") == 0 );
+
+    String c(s);
+    CXXC_CHECK( std::strcmp(c.utf8(), "jhi") == 0 );
+}
+
+
+CXXC_TEST(NarrowCacheExternStorage)
+{
+    std::string ext("abc");
+    String s;
+    s.sync_with(&ext);
+
+    CXXC_CHECK( std::strcmp(s.utf8(), "abc") == 0 );
+    ext = "xyz";
+    CXXC_CHECK( std::strcmp(s.utf8(), "xyz") == 0 );
+}
+
+
+CXXC_TEST(LazyUTF8)
+{
+    String s("abc\xc3\xa4", "UTF-8");
+    CXXC_CHECK( s.isUTF8Pending() );
+    CXXC_CHECK( std::strcmp(s.utf8(), "abc\xc3\xa4") == 0 );
+    CXXC_CHECK( ! s.empty() );
+
+    String c(s);
+    CXXC_CHECK( c.isUTF8Pending() );
+    CXXC_CHECK( c == s );
+
+    c += String("x");
+    CXXC_CHECK( c.isUTF8Pending() );
+    CXXC_CHECK( std::strcmp(c.utf8(), "abc\xc3\xa4x") == 0 );
+    CXXC_CHECK( s + String("x") == c );
+
+    CXXC_CHECK( s.length() == 4 );
+    CXXC_CHECK( ! s.isUTF8Pending() );
+    CXXC_CHECK( std::wstring(s) == L"abcä" );
+    CXXC_CHECK( std::strcmp(s.utf8(), "abc\xc3\xa4") == 0 );
+
+    CXXC_CHECK( std::strcmp(c.to("ISO-8859-1"), "abc\xe4x") == 0 );
+    CXXC_CHECK( ! c.isUTF8Pending() );
+    CXXC_CHECK( std::strcmp(c.utf8(), "abc\xc3\xa4x") == 0 );
+
+    String e(std::string(""), "UTF-8");
+    CXXC_CHECK( e.empty() );
+
+    String w(L"abc");
+    w = s;
+    CXXC_CHECK( std::wstring(w) == L"abcä" );
+    w = String(std::string("def"));
+    CXXC_CHECK( w.isUTF8Pending() );
+    w.ref()[0] = 'x';
+    CXXC_CHECK( std::strcmp(w.utf8(), "xef") == 0 );
+}
+
+
+CXXC_TEST(ConverterCache)
+{
+    String::charset_id_t id = String::intern_charset("ISO-8859-1");
+    CXXC_CHECK( id != 0 );
+    CXXC_CHECK( String::intern_charset("ISO-8859-1") == id );
+    CXXC_CHECK( String::intern_charset("ISO-8859-15") != id );
+    CXXC_CHECK( String::prepare_converter("ISO-8859-1") == id );
+
+    CXXC_CHECK_THROW( ConversionError, String::prepare_converter("no-such-charset") );
+
+    // more charsets than cache slots, evicted converters are reopened
+    const char *charsets[] = { "ISO-8859-1", "ISO-8859-2", "ISO-8859-3", "ISO-8859-4",
+                               "ISO-8859-5", "ISO-8859-7", "ISO-8859-9", "ISO-8859-15",
+                               "windows-1252", "US-ASCII" };
+    for(int round = 0; round < 2; ++round)
+    {
+        for(size_t i = 0; i < sizeof(charsets) / sizeof(charsets[0]); ++i)
+        {
+            String s(std::string("abc"), charsets[i]);
+            CXXC_CHECK( std::strcmp(s.to(charsets[i]), "abc") == 0 );
+        }
+    }
+
+    // ids don't change when the per thread name cache evicts them,
+    // and other threads get the same ids
+    CXXC_CHECK( String::intern_charset("ISO-8859-1") == id );
+    String::charset_id_t other = 0;
+    std::thread t([&other]() { other = String::intern_charset("ISO-8859-1"); });
+    t.join();
+    CXXC_CHECK( other == id );
+
+    String s("\xc3\xa4");
+    CXXC_CHECK( std::strcmp(s.to("ISO-8859-1"), "\xe4") == 0 );
+
+    // each id selects its own converter
+    String l(std::string("\xb3"), "ISO-8859-2");
+    CXXC_CHECK( std::strcmp(l.utf8(), "\xc5\x82") == 0 );
+    CXXC_CHECK( std::strcmp(l.to("ISO-8859-2"), "\xb3") == 0 );
+    CXXC_CHECK( std::strcmp(String(std::string("\xb3"), "ISO-8859-1").utf8(), "\xc2\xb3") == 0 );
+}
+
+
+int main(void)
+{
+    std::locale::global(std::locale(""));
+    std::cout.imbue(std::locale());
+    std::cerr.imbue(std::locale());
+    std::clog.imbue(std::locale());
+    std::wcout.imbue(std::locale());
+    std::wcerr.imbue(std::locale());
+    std::wclog.imbue(std::locale());
+
+    return cxxc::runAll();
+}
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <memory>
 #include <cstdlib>
+#include <stdexcept>
 
 #include "../cxxc.hh"
 
@@ -190,6 +191,222 @@ CXXC_TEST(MemoDeepCopy)
 }
 
 
+CXXC_TEST(InlineStorage)
+{
+    Variant v1(10);
+    CXXC_CHECK( v1.is_inline() );
+    CXXC_CHECK( v1.datatype() == DAL_TYPE_INT );
+    CXXC_CHECK( v1.get<String>() == String("10") );
+    CXXC_CHECK( v1.get<signed long long>() == 10 );
+
+    Variant v2(v1);
+    CXXC_CHECK( v2.is_inline() );
+    v1.set<double>(2.5);
+    CXXC_CHECK( v1.datatype() == DAL_TYPE_DOUBLE );
+    CXXC_CHECK( v2.get<int>() == 10 );
+
+    v2.set<String>("foo");
+    CXXC_CHECK( ! v2.is_inline() );
+    v2 = v1;
+    CXXC_CHECK( v2.is_inline() );
+    CXXC_CHECK( v2.get<double>() == 2.5 );
+
+    v2.setNull();
+    CXXC_CHECK( v2.isnull() );
+    CXXC_CHECK( ! v2.is_inline() );
+
+    Variant v3(TDate(2011, 5, 17));
+    CXXC_CHECK( v3.is_inline() );
+    CXXC_CHECK( v3.get<TTimestamp>().day() == 17 );
+
+    Variant v4(v3.clone());
+    CXXC_CHECK( ! v4.is_inline() );
+    CXXC_CHECK( v4.get<TDate>() == TDate(2011, 5, 17) );
+}
+
+
+CXXC_TEST(InlineStorageConst)
+{
+    // const access must not move the value to the heap, records are
+    // shared between threads
+    const Variant c(10);
+    CXXC_CHECK( c.get<String>() == String("10") );
+    CXXC_CHECK( c.can_convert<String>() );
+    CXXC_CHECK( ! c.can_convert<TDate>() );
+    CXXC_CHECK_THROW( ConvertException, c.get<TDate>() );
+    CXXC_CHECK( std::string(c.get_typename()).size() > 0 );
+    std::unique_ptr<IVariantValue> copy(c.clone());
+    CXXC_CHECK( copy->datatype() == DAL_TYPE_INT );
+    CXXC_CHECK( c.is_inline() );
+    CXXC_CHECK_THROW( std::runtime_error, c.get_storage() );
+}
+
+
+CXXC_TEST(InlineConversionTable)
+{
+    // the table must accept the same conversions as the heap value store
+    Variant inl(int(65));
+    Variant heap(static_cast<IVariantValue*>(new value_traits<int>::stored_type(65)));
+    CXXC_CHECK( inl.is_inline() );
+    CXXC_CHECK( ! heap.is_inline() );
+
+    CXXC_CHECK( inl.can_convert<double>() == heap.can_convert<double>() );
+    CXXC_CHECK( inl.get<double>() == heap.get<double>() );
+    CXXC_CHECK( inl.can_convert<String>() == heap.can_convert<String>() );
+    CXXC_CHECK( inl.get<String>() == heap.get<String>() );
+    CXXC_CHECK( inl.can_convert<unsigned char>() == heap.can_convert<unsigned char>() );
+    CXXC_CHECK( inl.get<unsigned char>() == heap.get<unsigned char>() );
+    CXXC_CHECK( inl.can_convert<TDate>() == heap.can_convert<TDate>() );
+    CXXC_CHECK( inl.get<bool>() == heap.get<bool>() );
+    CXXC_CHECK( inl.get<TNumeric>() == heap.get<TNumeric>() );
+
+    // range errors of the arithmetic conversions without accessor
+    Variant big(int(300));
+    Variant bigheap(static_cast<IVariantValue*>(new value_traits<int>::stored_type(300)));
+    CXXC_CHECK_THROW( ConvertException, bigheap.get<unsigned char>() );
+    CXXC_CHECK_THROW( ConvertException, big.get<unsigned char>() );
+    Variant real(-1.5);
+    Variant realheap(static_cast<IVariantValue*>(new value_traits<double>::stored_type(-1.5)));
+    CXXC_CHECK( real.get<int>() == realheap.get<int>() );
+
+    Variant d(TDate(2011, 5, 17));
+    Variant dheap(static_cast<IVariantValue*>(new value_traits<TDate>::stored_type(TDate(2011, 5, 17))));
+    CXXC_CHECK( d.can_convert<TTimestamp>() == dheap.can_convert<TTimestamp>() );
+    CXXC_CHECK( d.get<TTimestamp>() == dheap.get<TTimestamp>() );
+    CXXC_CHECK( d.can_convert<int>() == dheap.can_convert<int>() );
+}
+
+
+CXXC_TEST(InlineStorageFromPointer)
+{
+    int x = 5;
+
+    Variant v1(&x);
+    CXXC_CHECK( ! v1.is_inline() );
+
+    Variant v2;
+    v2 = v1;
+    CXXC_CHECK( v2.is_inline() );
+    x = 7;
+    CXXC_CHECK( v2.get<int>() == 5 );
+    CXXC_CHECK( v1.get<int>() == 7 );
+}
+
+
+CXXC_TEST(BinaryOperators)
+{
+    Variant a(5), b(static_cast<signed long long>(7)), c(String("x"));
+
+    Variant r = apply_binary_method(a, b, &BinaryOperatorVariant::binary_add);
+    CXXC_CHECK( r.datatype() == DAL_TYPE_BIGINT );
+    CXXC_CHECK( r.get<int>() == 12 );
+
+    CXXC_CHECK( apply_binary_method(a, b, &BinaryOperatorVariant::binary_less).get<bool>() );
+    CXXC_CHECK( apply_binary_method(a, a, &BinaryOperatorVariant::binary_equal).get<bool>() );
+    CXXC_CHECK( apply_binary_method(c, c, &BinaryOperatorVariant::binary_equal).get<bool>() );
+    CXXC_CHECK( apply_binary_method(Variant(TDate(2011, 5, 17)), Variant(TDate(2011, 5, 18)),
+                                    &BinaryOperatorVariant::binary_not_equal).get<bool>() );
+    CXXC_CHECK_THROW( NullException, apply_binary_method(a, Variant(), &BinaryOperatorVariant::binary_add) );
+}
+
+
+CXXC_TEST(BinaryOperatorsString)
+{
+    Variant ab(String("ab")), b(String("b"));
+
+    CXXC_CHECK( apply_binary_method(ab, b, &BinaryOperatorVariant::binary_less).get<bool>() );
+    CXXC_CHECK( apply_binary_method(ab, ab, &BinaryOperatorVariant::binary_less_equal).get<bool>() );
+    CXXC_CHECK( apply_binary_method(b, ab, &BinaryOperatorVariant::binary_greater).get<bool>() );
+    CXXC_CHECK( apply_binary_method(b, b, &BinaryOperatorVariant::binary_greater_equal).get<bool>() );
+    CXXC_CHECK( ! apply_binary_method(b, ab, &BinaryOperatorVariant::binary_less).get<bool>() );
+    CXXC_CHECK( VariantExprHelper::compare(ab, b) < 0 );
+    CXXC_CHECK( VariantExprHelper::compare(b, ab) > 0 );
+    CXXC_CHECK( VariantExprHelper::compare(b, b) == 0 );
+}
+
+
+CXXC_TEST(BinaryOperatorsReal)
+{
+    Variant a(7), f(2.5f), d(6.5);
+
+    // floating point operands are not truncated to an integer type
+    Variant r = apply_binary_method(Variant(1.5), a, &BinaryOperatorVariant::binary_add);
+    CXXC_CHECK( r.datatype() == DAL_TYPE_DOUBLE );
+    CXXC_CHECK( r.get<double>() == 8.5 );
+    r = apply_binary_method(a, f, &BinaryOperatorVariant::binary_mul);
+    CXXC_CHECK( r.datatype() == DAL_TYPE_FLOAT );
+    CXXC_CHECK( r.get<float>() == 17.5f );
+    r = apply_binary_method(f, d, &BinaryOperatorVariant::binary_sub);
+    CXXC_CHECK( r.datatype() == DAL_TYPE_DOUBLE );
+    CXXC_CHECK( r.get<double>() == -4.0 );
+    CXXC_CHECK( apply_binary_method(Variant(1.0), Variant(4), &BinaryOperatorVariant::binary_div).get<double>() == 0.25 );
+
+    CXXC_CHECK( apply_binary_method(d, a, &BinaryOperatorVariant::binary_less).get<bool>() );
+    CXXC_CHECK( apply_binary_method(a, d, &BinaryOperatorVariant::binary_greater).get<bool>() );
+    CXXC_CHECK( ! apply_binary_method(d, Variant(6), &BinaryOperatorVariant::binary_equal).get<bool>() );
+    CXXC_CHECK( VariantExprHelper::compare(Variant(2.5), a) < 0 );
+    CXXC_CHECK( VariantExprHelper::compare(a, d) > 0 );
+    CXXC_CHECK( VariantExprHelper::compare(Variant(static_cast<signed long long>(6)), d) < 0 );
+}
+
+
+CXXC_TEST(ExprKernels)
+{
+    Variant a(7), b(3), s(String("ab"));
+
+    CXXC_CHECK( VariantExprHelper::binarySub(a, b).get<int>() == 4 );
+    CXXC_CHECK( VariantExprHelper::binaryMul(a, b).get<int>() == 21 );
+    CXXC_CHECK( VariantExprHelper::binaryDiv(a, b).get<int>() == 2 );
+    CXXC_CHECK( VariantExprHelper::binaryMod(a, b).get<int>() == 1 );
+    CXXC_CHECK( VariantExprHelper::binaryConcat(s, s).get<String>() == String("abab") );
+    CXXC_CHECK( VariantExprHelper::binaryGreater(a, b).get<bool>() );
+    CXXC_CHECK( VariantExprHelper::compare(a, b) > 0 );
+    CXXC_CHECK( VariantExprHelper::compare(b, a) < 0 );
+    CXXC_CHECK( VariantExprHelper::compare(a, a) == 0 );
+    CXXC_CHECK( VariantExprHelper::unaryNegative(a).get<int>() == -7 );
+    CXXC_CHECK( VariantExprHelper::unaryPositive(Variant(static_cast<signed char>(2))).datatype() == DAL_TYPE_INT );
+}
+
+
+CXXC_TEST(ExprColumnKernels)
+{
+    VariantExprHelper::column_type x, y, r;
+    for(int i = 0; i < 10; ++i)
+    {
+        x.push_back(Variant(i));
+        y.push_back(Variant(static_cast<signed long long>(i * 10)));
+    }
+    y[3].setNull();
+
+    VariantExprHelper::binaryAdd(x, y, r);
+    CXXC_CHECK( r.size() == 10 );
+    CXXC_CHECK( r[2].get<int>() == 22 );
+    CXXC_CHECK( r[2].datatype() == DAL_TYPE_BIGINT );
+    CXXC_CHECK( r[3].isnull() );
+
+    VariantExprHelper::binaryMul(x, Variant(2), r);
+    CXXC_CHECK( r[9].get<int>() == 18 );
+
+    std::vector<int> cmp;
+    std::vector<bool> nulls;
+    VariantExprHelper::compare(x, y, cmp, nulls);
+    CXXC_CHECK( nulls.size() == 10 );
+    CXXC_CHECK( cmp[0] == 0 && ! nulls[0] );
+    CXXC_CHECK( cmp[1] < 0 );
+    CXXC_CHECK( nulls[3] );
+
+    // a zero divisor gives NULL instead of a division trap
+    VariantExprHelper::binaryDiv(y, x, r);
+    CXXC_CHECK( r[0].isnull() );
+    CXXC_CHECK( r[2].get<int>() == 10 );
+    VariantExprHelper::binaryMod(x, Variant(0), r);
+    CXXC_CHECK( r[5].isnull() );
+    CXXC_CHECK( VariantExprHelper::binaryDiv(Variant(1), Variant(0)).isnull() );
+    CXXC_CHECK( VariantExprHelper::binaryMod(Variant(static_cast<unsigned char>(1)),
+                                             Variant(static_cast<unsigned char>(0))).isnull() );
+}
+
+
 int main(void)
 {
     std::locale::global(std::locale(""));
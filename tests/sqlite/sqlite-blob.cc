@@ -0,0 +1,233 @@
+#include <dbwtl/dal/dalinterface>
+#include <dbwtl/dal/engines/sqlite>
+#include <dbwtl/dbobjects>
+#include <dbwtl/ustring>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <memory>
+
+#include "../cxxc.hh"
+#include "fixture_sqlite3.hh"
+
+
+// Size of the test BLOBs, larger than one streaming chunk
+#define BLOB_SIZE 200000
+
+
+/// Stream buffer that serves its data in small pieces, optionally
+/// without support for seeking
+class chunked_buf : public std::streambuf
+{
+public:
+    chunked_buf(const std::string &data, bool seekable)
+        : m_data(data), m_pos(0), m_seekable(seekable)
+    {}
+
+protected:
+    virtual int_type underflow(void)
+    {
+        if(this->m_pos >= this->m_data.size())
+            return traits_type::eof();
+        size_t n = std::min(sizeof(this->m_buf), this->m_data.size() - this->m_pos);
+        this->m_data.copy(this->m_buf, n, this->m_pos);
+        this->m_pos += n;
+        this->setg(this->m_buf, this->m_buf, this->m_buf + n);
+        return traits_type::to_int_type(this->m_buf[0]);
+    }
+
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode)
+    {
+        if(! this->m_seekable)
+            return pos_type(off_type(-1));
+        off_type cur = off_type(this->m_pos) - (this->egptr() - this->gptr());
+        off_type base = way == std::ios_base::beg ? 0 : way == std::ios_base::cur ? cur : off_type(this->m_data.size());
+        return this->seekpos(pos_type(base + off), std::ios_base::in);
+    }
+
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode)
+    {
+        if(! this->m_seekable)
+            return pos_type(off_type(-1));
+        this->m_pos = size_t(pos);
+        this->setg(this->m_buf, this->m_buf, this->m_buf);
+        return pos;
+    }
+
+    const std::string &m_data;
+    size_t             m_pos;
+    bool               m_seekable;
+    char               m_buf[16];
+};
+
+
+static std::string make_blob(size_t size, int seed)
+{
+    std::string s(size, '\0');
+    for(size_t i = 0; i < size; ++i)
+        s[i] = char((i * 31 + seed) % 256);
+    return s;
+}
+
+
+static std::string read_blob(SqliteMemoryFixture::DBMS::Connection &dbc, int id)
+{
+    SqliteMemoryFixture::DBMS::Statement stmt(dbc);
+    stmt.prepare("SELECT data FROM b WHERE id = ?");
+    stmt.bind(1, id);
+    stmt.execute();
+    stmt.resultset().first();
+    std::stringstream ss;
+    ss << stmt.resultset().column(1).get<BlobStream>().rdbuf();
+    stmt.close();
+    return ss.str();
+}
+
+
+static void insert_blob(SqliteMemoryFixture::DBMS::Connection &dbc, int id, std::streambuf *buf)
+{
+    SqliteMemoryFixture::DBMS::Statement stmt(dbc);
+    stmt.prepare("INSERT INTO b(id, data) VALUES(?, ?)");
+    stmt.bind(1, id);
+    stmt.bind(2, buf);
+    stmt.execute();
+    stmt.close();
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, BindBlobSources)
+{
+    dbc.directCmd("CREATE TABLE b(id INTEGER PRIMARY KEY, data BLOB)");
+    const std::string data = make_blob(BLOB_SIZE, 7);
+
+    // contiguous buffer, executed twice with the same binding
+    std::stringstream ss(data);
+    ss.seekg(10);
+    DBMS::Statement stmt(dbc);
+    stmt.prepare("INSERT INTO b(id, data) VALUES(?, ?)");
+    stmt.bind(2, ss.rdbuf());
+    stmt.bind(1, 1);
+    stmt.execute();
+    stmt.bind(1, 2);
+    stmt.execute();
+    stmt.close();
+    CXXC_CHECK( ss.tellg() == std::streampos(10) );
+    CXXC_CHECK( read_blob(dbc, 1) == data.substr(10) );
+    CXXC_CHECK( read_blob(dbc, 2) == data.substr(10) );
+
+    // seekable buffer without a contiguous get area
+    chunked_buf seekable(data, true);
+    insert_blob(dbc, 3, &seekable);
+    CXXC_CHECK( read_blob(dbc, 3) == data );
+
+    // buffer that can only be read once
+    chunked_buf forward(data, false);
+    insert_blob(dbc, 4, &forward);
+    CXXC_CHECK( read_blob(dbc, 4) == data );
+
+    // an empty buffer is an empty BLOB, not NULL
+    std::stringstream empty;
+    insert_blob(dbc, 5, empty.rdbuf());
+    stmt.execDirect("SELECT data IS NULL, length(data) FROM b WHERE id = 5");
+    stmt.resultset().first();
+    CXXC_CHECK( stmt.resultset().column(1).asInt() == 0 );
+    CXXC_CHECK( stmt.resultset().column(2).asInt() == 0 );
+    stmt.close();
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, WriteBlob)
+{
+    dbc.directCmd("CREATE TABLE b(id INTEGER PRIMARY KEY, data BLOB)");
+    const std::string data = make_blob(BLOB_SIZE, 3);
+
+    DBMS::Statement stmt(dbc);
+    stmt.prepare("INSERT INTO b(id, data) VALUES(?, zeroblob(?))");
+    stmt.bind(1, 1);
+    stmt.bind(2, int(data.size()));
+    stmt.execute();
+    stmt.close();
+
+    chunked_buf src(data, false);
+    dbc.getImpl()->writeBlob("b", "data", 1, &src);
+    CXXC_CHECK( read_blob(dbc, 1) == data );
+
+    // the data must fit into the stored value
+    std::stringstream big(data + "x");
+    CXXC_CHECK_THROW( SqlstateException, dbc.getImpl()->writeBlob("b", "data", 1, big.rdbuf()) );
+    CXXC_CHECK_THROW( SqlstateException, dbc.getImpl()->writeBlob("b", "data", 99, big.rdbuf()) );
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, IncrementalRead)
+{
+    dbc.directCmd("CREATE TABLE b(id INTEGER PRIMARY KEY, data BLOB)");
+    const std::string data = make_blob(BLOB_SIZE, 5);
+    std::stringstream src(data);
+    insert_blob(dbc, 1, src.rdbuf());
+    std::stringstream empty;
+    insert_blob(dbc, 2, empty.rdbuf());
+
+    std::auto_ptr<SqliteBlob> buf(dbc.getImpl()->openBlob("b", "data", 1));
+    std::istream in(buf.get());
+
+    std::stringstream all;
+    all << in.rdbuf();
+    CXXC_CHECK( all.str() == data );
+
+    // seek back into the data and read a few bytes
+    in.clear();
+    in.seekg(150000);
+    char part[10];
+    in.read(part, sizeof(part));
+    CXXC_CHECK( std::string(part, sizeof(part)) == data.substr(150000, sizeof(part)) );
+
+    in.seekg(-5, std::ios_base::end);
+    CXXC_CHECK( buf->in_avail() == 5 );
+    in.read(part, 5);
+    CXXC_CHECK( std::string(part, 5) == data.substr(data.size() - 5) );
+
+    // a read larger than one chunk bypasses the buffer
+    std::string large(100000, '\0');
+    in.seekg(3);
+    in.get(part[0]);
+    in.read(&large[0], std::streamsize(large.size()));
+    CXXC_CHECK( in.gcount() == std::streamsize(large.size()) );
+    CXXC_CHECK( large == data.substr(4, large.size()) );
+    in.read(part, 3);
+    CXXC_CHECK( std::string(part, 3) == data.substr(100004, 3) );
+
+    CXXC_CHECK( buf->pubseekoff(1, std::ios_base::end, std::ios_base::in) == std::streampos(-1) );
+    buf.reset();
+
+    std::auto_ptr<SqliteBlob> none(dbc.getImpl()->openBlob("b", "data", 2));
+    CXXC_CHECK( none->sgetc() == std::char_traits<char>::eof() );
+    none.reset();
+
+    CXXC_CHECK_THROW( SqlstateException, dbc.getImpl()->openBlob("b", "data", 99) );
+}
+
+
+int main(void)
+{
+    std::locale::global(std::locale(""));
+    std::cout.imbue(std::locale());
+    std::cerr.imbue(std::locale());
+    std::clog.imbue(std::locale());
+    std::wcout.imbue(std::locale());
+    std::wcerr.imbue(std::locale());
+    std::wclog.imbue(std::locale());
+
+    return cxxc::runAll();
+}
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
@@ -0,0 +1,238 @@
+#include <dbwtl/dal/dalinterface>
+#include <dbwtl/dal/engines/sqlite>
+#include <dbwtl/dbobjects>
+#include <dbwtl/ustring>
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+
+#if defined(DBWTL_ON_UNIX)
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+#include "../cxxc.hh"
+
+
+using namespace informave::db;
+
+typedef Database<sqlite> DBMS;
+
+
+// Number of writer processes and rows per process
+#define WRITERS       4
+#define TRANSACTIONS  20
+#define ROWS_PER_TRX  10
+
+
+static std::string test_database(const char *name)
+{
+    std::string path = std::string("/tmp/dbwtl_") + name + ".sqlite3";
+    std::remove(path.c_str());
+    std::remove((path + "-wal").c_str());
+    std::remove((path + "-shm").c_str());
+    return path;
+}
+
+
+static int select_value(DBMS::Connection &dbc, const char *sql)
+{
+    DBMS::Statement stmt(dbc);
+    stmt.execDirect(sql);
+    stmt.resultset().first();
+    int value = stmt.resultset().column(1).asInt();
+    stmt.close();
+    return value;
+}
+
+
+CXXC_TEST(ConnectOptions)
+{
+    std::string path = test_database("options");
+    DBMS::Environment env("sqlite:libsqlite");
+
+    {
+        DBMS::Connection dbc(env);
+        DBMS::Connection::Options options;
+        options["database"] = path;
+        options["journal_mode"] = "wal";
+        options["synchronous"] = "NORMAL";
+        options["cache_size"] = "-4000";
+        options["mmap_size"] = "1048576";
+        options["busy_timeout"] = "100";
+        dbc.connect(options);
+
+        DBMS::Statement stmt(dbc);
+        stmt.execDirect("PRAGMA journal_mode");
+        stmt.resultset().first();
+        CXXC_CHECK( stmt.resultset().column(1).asStr() == String("wal") );
+        stmt.close();
+
+        CXXC_CHECK( select_value(dbc, "PRAGMA synchronous") == 1 );
+        CXXC_CHECK( select_value(dbc, "PRAGMA cache_size") == -4000 );
+        CXXC_CHECK( select_value(dbc, "PRAGMA mmap_size") == 1048576 );
+        CXXC_CHECK( select_value(dbc, "PRAGMA busy_timeout") == 100 );
+    }
+
+    {
+        DBMS::Connection dbc(env);
+        DBMS::Connection::Options options;
+        options["database"] = path;
+        options["journal_mode"] = "WAL; DROP TABLE x";
+        CXXC_CHECK_THROW( EngineException, dbc.connect(options) );
+        CXXC_CHECK( ! dbc.isConnected() );
+    }
+
+    {
+        DBMS::Connection dbc(env);
+        DBMS::Connection::Options options;
+        options["database"] = path;
+        options["busy_retries"] = "many";
+        CXXC_CHECK_THROW( EngineException, dbc.connect(options) );
+    }
+}
+
+
+CXXC_TEST(BusyRetry)
+{
+    std::string path = test_database("busy");
+    DBMS::Environment env("sqlite:libsqlite");
+
+    DBMS::Connection holder(env);
+    holder.connect(path);
+    holder.directCmd("CREATE TABLE t(id INTEGER)");
+    holder.directCmd("BEGIN IMMEDIATE");
+
+    // without busy handling a locked database fails at once
+    DBMS::Connection plain(env);
+    plain.connect(path);
+    CXXC_CHECK_THROW( SqlstateException, plain.directCmd("INSERT INTO t VALUES(1)") );
+    plain.disconnect();
+
+    std::thread release([&holder]()
+                        {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                            holder.directCmd("COMMIT");
+                        });
+
+    DBMS::Connection waiting(env);
+    DBMS::Connection::Options options;
+    options["database"] = path;
+    options["busy_retries"] = "20";
+    options["busy_backoff"] = "5";
+    waiting.connect(options);
+    waiting.directCmd("INSERT INTO t VALUES(1)");
+    release.join();
+
+    CXXC_CHECK( select_value(waiting, "SELECT COUNT(*) FROM t") == 1 );
+}
+
+
+#if defined(DBWTL_ON_UNIX)
+
+/// Inserts TRANSACTIONS * ROWS_PER_TRX rows, returns the exit code
+static int run_writer(const std::string &path, int writer)
+{
+    try
+    {
+        DBMS::Environment env("sqlite:libsqlite");
+        DBMS::Connection dbc(env);
+        DBMS::Connection::Options options;
+        options["database"] = path;
+        options["journal_mode"] = "WAL";
+        options["synchronous"] = "NORMAL";
+        options["busy_timeout"] = "20";
+        options["busy_retries"] = "100";
+        options["busy_backoff"] = "2";
+        dbc.connect(options);
+
+        DBMS::Statement stmt(dbc);
+        for(int t = 0; t < TRANSACTIONS; ++t)
+        {
+            dbc.directCmd("BEGIN IMMEDIATE");
+            for(int r = 0; r < ROWS_PER_TRX; ++r)
+            {
+                stmt.prepare("INSERT INTO contention(writer, seq) VALUES(?, ?)");
+                stmt.bind(1, writer);
+                stmt.bind(2, t * ROWS_PER_TRX + r);
+                stmt.execute();
+                stmt.close();
+            }
+            dbc.directCmd("COMMIT");
+        }
+        return 0;
+    }
+    catch(std::exception &e)
+    {
+        std::cerr << "writer " << writer << ": " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+
+CXXC_TEST(MultiProcessContention)
+{
+    std::string path = test_database("contention");
+
+    {
+        DBMS::Environment env("sqlite:libsqlite");
+        DBMS::Connection dbc(env);
+        DBMS::Connection::Options options;
+        options["database"] = path;
+        options["journal_mode"] = "WAL";
+        dbc.connect(options);
+        dbc.directCmd("CREATE TABLE contention(writer INTEGER, seq INTEGER)");
+    }
+
+    pid_t pids[WRITERS];
+    for(int i = 0; i < WRITERS; ++i)
+    {
+        pids[i] = ::fork();
+        CXXC_CHECK( pids[i] >= 0 );
+        if(pids[i] == 0)
+            ::_exit(run_writer(path, i));
+    }
+
+    for(int i = 0; i < WRITERS; ++i)
+    {
+        int status = 0;
+        CXXC_CHECK( ::waitpid(pids[i], &status, 0) == pids[i] );
+        CXXC_CHECK( WIFEXITED(status) && WEXITSTATUS(status) == 0 );
+    }
+
+    DBMS::Environment env("sqlite:libsqlite");
+    DBMS::Connection dbc(env);
+    dbc.connect(path);
+    CXXC_CHECK( select_value(dbc, "SELECT COUNT(*) FROM contention")
+                == WRITERS * TRANSACTIONS * ROWS_PER_TRX );
+    CXXC_CHECK( select_value(dbc, "SELECT COUNT(DISTINCT writer) FROM contention") == WRITERS );
+}
+
+#endif
+
+
+int main(void)
+{
+    std::locale::global(std::locale(""));
+    std::cout.imbue(std::locale());
+    std::cerr.imbue(std::locale());
+    std::clog.imbue(std::locale());
+    std::wcout.imbue(std::locale());
+    std::wcerr.imbue(std::locale());
+    std::wclog.imbue(std::locale());
+
+    return cxxc::runAll();
+}
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
@@ -64,6 +64,203 @@ CXXC_FIXTURE_TEST(SqliteMemoryFixture, CachedFoo)
 }
 
 
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, ColumnLookup)
+{
+    DBMS::Statement stmt(dbc);
+    DBMS::Resultset rs;
+
+    stmt.execDirect("CREATE TABLE lookup(id integer, Name text, name2 text)");
+    stmt.close();
+    stmt.execDirect("INSERT INTO lookup VALUES(1, 'a', 'b')");
+    stmt.close();
+
+    stmt.execDirect("SELECT * FROM lookup");
+    rs.attach(stmt);
+    rs.first();
+    CXXC_CHECK( rs.columnID("id") == 1 );
+    CXXC_CHECK( rs.columnID("Name") == 2 );
+    CXXC_CHECK_THROW( NotFoundException, rs.columnID("NAME") );
+    CXXC_CHECK( rs.columnID("name2") == 3 );
+    CXXC_CHECK( rs.column("Name").get<String>() == std::string("a") );
+    CXXC_CHECK_THROW( NotFoundException, rs.columnID("foo") );
+    stmt.close();
+
+    // the index must be rebuilt for a new query on the same statement
+    stmt.execDirect("SELECT name2 AS foo, id FROM lookup");
+    rs.attach(stmt);
+    rs.first();
+    CXXC_CHECK( rs.columnID("foo") == 1 );
+    CXXC_CHECK( rs.columnID("id") == 2 );
+    CXXC_CHECK_THROW( NotFoundException, rs.columnID("Name") );
+
+    DBMS::CachedResultset cr;
+    cr.attach(stmt);
+    cr.open();
+    cr.first();
+    CXXC_CHECK( cr.columnID("foo") == 1 );
+    CXXC_CHECK_THROW( NotFoundException, cr.columnID("FOO") );
+    CXXC_CHECK( cr.column("foo").get<String>() == std::string("b") );
+    stmt.close();
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, RowsetSizeAndPrefetch)
+{
+    DBMS::Statement stmt(dbc);
+
+    stmt.execDirect("CREATE TABLE prefetch(id integer, name text)");
+    stmt.close();
+    stmt.execDirect("BEGIN");
+    stmt.close();
+    stmt.prepare("INSERT INTO prefetch(id, name) VALUES(?, ?)");
+    for(int i = 1; i <= 1000; ++i)
+    {
+        stmt.bind(1, i);
+        stmt.bind(2, String("prefetched row"));
+        stmt.execute();
+    }
+    stmt.close();
+    stmt.execDirect("COMMIT");
+    stmt.close();
+
+    {
+        DBMS::CachedResultset cr;
+        stmt.execDirect("SELECT * FROM prefetch ORDER BY id");
+        cr.attach(stmt);
+        cr.open();
+        CXXC_CHECK_THROW( EngineException, cr.setRowsetSize(0) );
+        cr.setRowsetSize(30);
+        CXXC_CHECK( cr.getRowsetSize() == 30 );
+        CXXC_CHECK( cr.fetchMore() == 30 );
+        CXXC_CHECK( cr.rowCount() == 30 );
+        stmt.close();
+    }
+
+    {
+        DBMS::CachedResultset cr;
+        stmt.execDirect("SELECT * FROM prefetch ORDER BY id");
+        cr.attach(stmt);
+        cr.setPrefetch(64, 4096);
+        cr.open();
+        CXXC_CHECK( cr.isPrefetching() );
+
+        int expected = 0;
+        cr.first();
+        do
+        {
+            ++expected;
+            CXXC_CHECK( cr.column("id").get<int>() == expected );
+        }
+        while(cr.next());
+        CXXC_CHECK( expected == 1000 );
+        CXXC_CHECK( cr.rowCount() == 1000 );
+        CXXC_CHECK( ! cr.moreAvail() );
+        stmt.close();
+    }
+
+    {
+        // stopping the worker keeps the rows fetched so far
+        DBMS::CachedResultset cr;
+        stmt.execDirect("SELECT * FROM prefetch ORDER BY id");
+        cr.attach(stmt);
+        cr.open();
+        cr.setPrefetch(100);
+        cr.setRowsetSize(10);
+        CXXC_CHECK( cr.fetchMore() == 10 );
+        cr.stopPrefetch();
+        CXXC_CHECK( ! cr.isPrefetching() );
+        cr.fetchAll();
+        CXXC_CHECK( cr.rowCount() == 1000 );
+        cr.last();
+        CXXC_CHECK( cr.column("id").get<int>() == 1000 );
+        stmt.close();
+    }
+
+    {
+        // a worker error is not lost when the worker is stopped
+        DBMS::CachedResultset cr;
+        stmt.execDirect("SELECT id, CASE WHEN id > 50 THEN abs(-9223372036854775808) "
+                        "ELSE id END FROM prefetch");
+        cr.attach(stmt);
+        cr.setPrefetch(1000);
+        cr.setRowsetSize(10);
+        cr.open();
+        CXXC_CHECK( cr.fetchMore() == 10 );
+        cr.stopPrefetch();
+        CXXC_CHECK( cr.moreAvail() );
+        cr.setRowsetSize(100);
+        CXXC_CHECK_THROW( Exception, cr.fetchMore() );
+        CXXC_CHECK( cr.rowCount() >= 10 && cr.rowCount() <= 50 );
+        stmt.close();
+    }
+
+    {
+        // moreAvail() reports a pending worker error
+        DBMS::CachedResultset cr;
+        stmt.execDirect("SELECT id, CASE WHEN id > 50 THEN abs(-9223372036854775808) "
+                        "ELSE id END FROM prefetch");
+        cr.attach(stmt);
+        cr.setPrefetch(1000);
+        cr.setRowsetSize(10);
+        cr.open();
+        bool failed = false;
+        try
+        {
+            while(cr.moreAvail())
+                cr.fetchMore();
+        }
+        catch(Exception &)
+        {
+            failed = true;
+        }
+        CXXC_CHECK( failed );
+        CXXC_CHECK( ! cr.moreAvail() );
+        stmt.close();
+    }
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, IndexSeek)
+{
+    DBMS::Statement stmt(dbc);
+
+    stmt.execDirect("CREATE TABLE keyed(id integer, code text)");
+    stmt.close();
+    stmt.prepare("INSERT INTO keyed(id, code) VALUES(?, ?)");
+    for(int i = 1; i <= 300; ++i)
+    {
+        stmt.bind(1, i);
+        stmt.bind(2, String(i % 3 ? "b" : "a"));
+        stmt.execute();
+    }
+    stmt.close();
+
+    DBMS::CachedResultset cr;
+    stmt.execDirect("SELECT * FROM keyed ORDER BY id");
+    cr.attach(stmt);
+    cr.open();
+    cr.setRowsetSize(10);
+    cr.fetchMore();
+    cr.createIndex("id", DBWTL_INDEX_HASH, std::vector<colnum_t>(1, 1));
+    cr.createIndex("code", DBWTL_INDEX_ORDERED, std::vector<colnum_t>(1, 2));
+
+    // rows fetched after createIndex() are indexed as well
+    CXXC_CHECK( cr.seek("id", Variant(250)) );
+    CXXC_CHECK( cr.rowCount() == 300 );
+    CXXC_CHECK( cr.column("id").get<int>() == 250 );
+    CXXC_CHECK( ! cr.seek("id", Variant(301)) );
+    CXXC_CHECK( cr.column("id").get<int>() == 250 );
+
+    CXXC_CHECK( cr.lookup("code", RecordIndex::key_type(1, Variant(String("a")))).size() == 100 );
+    CXXC_CHECK( cr.seek("code", Variant(String("a"))) );
+    CXXC_CHECK( cr.column("id").get<int>() == 3 );
+    CXXC_CHECK_THROW( NotFoundException, cr.seek("foo", Variant(1)) );
+    cr.dropIndex("code");
+    CXXC_CHECK_THROW( NotFoundException, cr.lookup("code", RecordIndex::key_type(1, Variant(1))) );
+    stmt.close();
+}
+
+
 int main(void)
 {
     std::locale::global(std::locale(""));
@@ -0,0 +1,178 @@
+#include <dbwtl/dal/dalinterface>
+#include <dbwtl/dal/engines/sqlite>
+#include <dbwtl/dbobjects>
+#include <dbwtl/ustring>
+
+#include <iostream>
+
+#include "../cxxc.hh"
+#include "fixture_sqlite3.hh"
+
+
+static int select_value(SqliteMemoryFixture::DBMS::Connection &dbc, const char *sql)
+{
+    SqliteMemoryFixture::DBMS::Statement stmt(dbc);
+    stmt.execDirect(sql);
+    stmt.resultset().first();
+    int value = stmt.resultset().column(1).asInt();
+    stmt.close();
+    return value;
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, StmtCacheReuse)
+{
+    size_t hits = dbc.getImpl()->stmtCacheHits();
+    size_t misses = dbc.getImpl()->stmtCacheMisses();
+
+    DBMS::Statement stmt(dbc);
+    for(int i = 1; i <= 3; ++i)
+    {
+        stmt.prepare("SELECT ?");
+        stmt.bind(1, i);
+        stmt.execute();
+        stmt.resultset().first();
+        CXXC_CHECK( stmt.resultset().column(1).asInt() == i );
+        stmt.close();
+    }
+    CXXC_CHECK( dbc.getImpl()->stmtCacheMisses() == misses + 1 );
+    CXXC_CHECK( dbc.getImpl()->stmtCacheHits() == hits + 2 );
+
+    // bindings are cleared when a statement goes back to the cache
+    stmt.prepare("SELECT ?");
+    stmt.execute();
+    stmt.resultset().first();
+    CXXC_CHECK( stmt.resultset().column(1).isnull() );
+    stmt.close();
+
+    // two open statements with the same SQL get their own handles
+    DBMS::Statement other(dbc);
+    stmt.execDirect("SELECT 1");
+    other.execDirect("SELECT 1");
+    stmt.resultset().first();
+    other.resultset().first();
+    CXXC_CHECK( stmt.resultset().column(1).asInt() == 1 );
+    CXXC_CHECK( other.resultset().column(1).asInt() == 1 );
+    other.close();
+    stmt.close();
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, StmtCacheSchemaChange)
+{
+    dbc.directCmd("CREATE TABLE t(a INTEGER)");
+    dbc.directCmd("INSERT INTO t VALUES(1)");
+
+    DBMS::Statement stmt(dbc);
+    stmt.execDirect("SELECT * FROM t");
+    CXXC_CHECK( stmt.resultset().columnCount() == 1 );
+    stmt.close();
+
+    dbc.directCmd("ALTER TABLE t ADD COLUMN b INTEGER DEFAULT 2");
+
+    size_t hits = dbc.getImpl()->stmtCacheHits();
+    stmt.execDirect("SELECT * FROM t");
+    CXXC_CHECK( dbc.getImpl()->stmtCacheHits() == hits + 1 );
+    CXXC_CHECK( stmt.resultset().columnCount() == 2 );
+    CXXC_CHECK( stmt.resultset().column(2).asInt() == 2 );
+    stmt.close();
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, StmtCacheCapacity)
+{
+    dbc.setOption(DBWTL_SQLITE_STMT_CACHE_SIZE, int(1));
+
+    size_t misses = dbc.getImpl()->stmtCacheMisses();
+    CXXC_CHECK( select_value(dbc, "SELECT 1") == 1 );
+    CXXC_CHECK( select_value(dbc, "SELECT 2") == 2 );
+    CXXC_CHECK( select_value(dbc, "SELECT 1") == 1 );
+    CXXC_CHECK( dbc.getImpl()->stmtCacheMisses() == misses + 3 );
+
+    size_t hits = dbc.getImpl()->stmtCacheHits();
+    CXXC_CHECK( select_value(dbc, "SELECT 1") == 1 );
+    CXXC_CHECK( dbc.getImpl()->stmtCacheHits() == hits + 1 );
+
+    dbc.getImpl()->clearStmtCache();
+    misses = dbc.getImpl()->stmtCacheMisses();
+    CXXC_CHECK( select_value(dbc, "SELECT 1") == 1 );
+    CXXC_CHECK( dbc.getImpl()->stmtCacheMisses() == misses + 1 );
+
+    dbc.setOption(DBWTL_SQLITE_STMT_CACHE_SIZE, int(0));
+    misses = dbc.getImpl()->stmtCacheMisses();
+    CXXC_CHECK( select_value(dbc, "SELECT 1") == 1 );
+    CXXC_CHECK( select_value(dbc, "SELECT 1") == 1 );
+    CXXC_CHECK( dbc.getImpl()->stmtCacheMisses() == misses + 2 );
+}
+
+
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, ColumnDescReuse)
+{
+    dbc.directCmd("CREATE TABLE d(id INTEGER, name VARCHAR(20))");
+    dbc.directCmd("INSERT INTO d VALUES(1, 'a')");
+    dbc.directCmd("INSERT INTO d VALUES(2, 'b')");
+
+    DBMS::Statement stmt(dbc);
+    stmt.prepare("SELECT * FROM d WHERE id = ?");
+    for(int i = 1; i <= 2; ++i)
+    {
+        stmt.bind(1, i);
+        stmt.execute();
+        stmt.resultset().first();
+        CXXC_CHECK( stmt.resultset().columnCount() == 2 );
+        CXXC_CHECK( stmt.resultset().describeColumn(1).getDatatype() == DAL_TYPE_INT );
+        CXXC_CHECK( stmt.resultset().describeColumn(2).getDatatype() == DAL_TYPE_STRING );
+        CXXC_CHECK( stmt.resultset().column(1).datatype() == DAL_TYPE_INT );
+        CXXC_CHECK( stmt.resultset().column("name").datatype() == DAL_TYPE_STRING );
+        CXXC_CHECK( stmt.resultset().column(1).asInt() == i );
+    }
+    CXXC_CHECK_THROW( NotFoundException, stmt.resultset().describeColumn(3) );
+
+    // SQLite recompiles the statement after a schema change
+    dbc.directCmd("ALTER TABLE d ADD COLUMN price DOUBLE");
+    stmt.bind(1, 2);
+    stmt.execute();
+    CXXC_CHECK( stmt.resultset().columnCount() == 3 );
+    CXXC_CHECK( stmt.resultset().describeColumn(3).getDatatype() == DAL_TYPE_DOUBLE );
+    CXXC_CHECK( stmt.resultset().columnName(3) == String("price") );
+
+    // same column count, but other declared types
+    while(stmt.resultset().next())
+        ;
+    dbc.directCmd("DROP TABLE d");
+    dbc.directCmd("CREATE TABLE d(id TEXT, name INTEGER, price VARCHAR(10))");
+    dbc.directCmd("INSERT INTO d VALUES('2', 5, 'x')");
+    stmt.bind(1, String("2"));
+    stmt.execute();
+    stmt.resultset().first();
+    CXXC_CHECK( stmt.resultset().columnCount() == 3 );
+    CXXC_CHECK( stmt.resultset().describeColumn(1).getDatatype() == DAL_TYPE_STRING );
+    CXXC_CHECK( stmt.resultset().describeColumn(2).getDatatype() == DAL_TYPE_INT );
+    CXXC_CHECK( stmt.resultset().describeColumn(3).getDatatype() == DAL_TYPE_STRING );
+    CXXC_CHECK( stmt.resultset().column("name").asInt() == 5 );
+    stmt.close();
+}
+
+
+int main(void)
+{
+    std::locale::global(std::locale(""));
+    std::cout.imbue(std::locale());
+    std::cerr.imbue(std::locale());
+    std::clog.imbue(std::locale());
+    std::wcout.imbue(std::locale());
+    std::wcerr.imbue(std::locale());
+    std::wclog.imbue(std::locale());
+
+    return cxxc::runAll();
+}
+
+
+//
+// Local Variables:
+// mode: C++
+// c-file-style: "bsd"
+// c-basic-offset: 4
+// indent-tabs-mode: nil
+// End:
+//
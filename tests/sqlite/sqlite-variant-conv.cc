@@ -117,6 +117,40 @@ CXXC_FIXTURE_TEST(SqliteMemoryFixture, SqliteVariantTest)
 
 
 
+CXXC_FIXTURE_TEST(SqliteMemoryFixture, SqliteUTF8View)
+{
+    DBMS::Statement stmt(dbc);
+    stmt.execDirect("SELECT 'foo\xc3\xa4', 42, X'0102', NULL, 1.5 UNION ALL SELECT '', 43, X'03', NULL, 2.5");
+    DBMS::Resultset rs;
+    rs.attach(stmt);
+    rs.first();
+
+    utf8_view view;
+    CXXC_CHECK( rs.column(1).get_utf8_view(view) );
+    CXXC_CHECK( view == utf8_view("foo\xc3\xa4", 5) );
+    CXXC_CHECK( view.str() == "foo\xc3\xa4" );
+
+    // numbers are not converted to text for a view
+    CXXC_CHECK( ! rs.column(2).get_utf8_view(view) );
+    CXXC_CHECK( rs.column(2).get<int>() == 42 );
+    CXXC_CHECK( ! rs.column(5).get_utf8_view(view) );
+    CXXC_CHECK( rs.column(5).get<double>() == 1.5 );
+
+    CXXC_CHECK( ! rs.column(3).get_utf8_view(view) );
+    CXXC_CHECK_THROW( NullException, rs.column(4).get_utf8_view(view) );
+
+    rs.next();
+    CXXC_CHECK( rs.column(1).get_utf8_view(view) );
+    CXXC_CHECK( view.empty() );
+
+    Variant v(String("bar"));
+    CXXC_CHECK( v.get_utf8_view(view) );
+    CXXC_CHECK( view.str() == "bar" );
+    CXXC_CHECK( ! Variant(int(5)).get_utf8_view(view) );
+}
+
+
+
 
 CXXC_FIXTURE_TEST(SqliteMemoryFixture, SqliteNumeric)
 {